@@ -0,0 +1,335 @@
+/**
+ * @file macro.cc
+ * @brief Benchmark de extremo a extremo: ejecuta Voraz, GRASP y RVND con semilla fija sobre un conjunto
+ *        fijo de instancias, mide tiempo de pared, tiempo de CPU, memoria pico, vehículos y distancia de
+ *        cada ejecución y los compara con una línea base guardada, marcando las regresiones de tiempo o
+ *        de calidad que superen los umbrales. Cada ejecución se hace en un proceso hijo (fork) para que
+ *        el tiempo de CPU y la memoria pico que devuelve wait4 sean sólo los de esa ejecución.
+ */
+#include "../src/tools/tools.h"
+#include "../src/tools/escritor_json/escritor_json.h"
+#include "../src/algoritmo/voraz/voraz.h"
+#include "../src/algoritmo/grasp/grasp.h"
+#include "../src/algoritmo/rvnd/rvnd.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+struct Ejecucion {
+  string algoritmo;
+  string instancia;
+  double tiempoPared = 0.0; // Segundos (sólo la ejecución del algoritmo, sin leer la instancia)
+  double tiempoCPU = 0.0; // Segundos de CPU (usuario + sistema) de todo el proceso hijo
+  long memoriaPicoKB = 0; // Memoria residente máxima del proceso hijo
+  int vehiculosRecoleccion = 0; // #CV
+  int vehiculosTransporte = 0; // #TV
+  double distancia = 0.0; // Distancia de recolección
+};
+
+struct Configuracion {
+  string entrada = "data/";
+  vector<string> algoritmos = {"voraz", "grasp", "rvnd"};
+  unsigned semilla = 1;
+  int tamanoLRC = 3;
+  int numeroEjecuciones = 3;
+  int repeticiones = 3; // Se guarda el mínimo de tiempo y memoria de las repeticiones
+  string lineaBase = "bench/linea_base.txt";
+  bool guardar = false; // Guardar los resultados como nueva línea base en vez de comparar
+  double umbralTiempo = 0.25; // Regresión si el tiempo empeora más de un 25%...
+  double margenTiempo = 0.005; // ...y más de 5 ms (para no marcar el ruido de las instancias pequeñas)
+  double umbralDistancia = 0.01; // Regresión si la distancia empeora más de un 1%
+  string salida = "bench_macro.json";
+};
+
+// Mejor solución de entre las que guarda el algoritmo para la instancia: menos vehículos y, a igualdad, menos distancia
+const Tools& mejorSolucion(const Algoritmo& algoritmo) {
+  const auto& datos = algoritmo.getDatos();
+  auto mejor = min_element(datos.begin(), datos.end(), [](const shared_ptr<Tools>& a, const shared_ptr<Tools>& b) {
+    const size_t vehiculosA = a->rutasRecoleccion.size() + a->rutasTransporte.size();
+    const size_t vehiculosB = b->rutasRecoleccion.size() + b->rutasTransporte.size();
+    if (vehiculosA != vehiculosB) return vehiculosA < vehiculosB;
+    return a->calcularDistanciaRecoleccion() < b->calcularDistanciaRecoleccion();
+  });
+  return **mejor;
+}
+
+unique_ptr<Algoritmo> crear(const string& nombre, const Configuracion& configuracion) {
+  if (nombre == "voraz") return make_unique<Voraz>();
+  if (nombre == "grasp") {
+    auto grasp = make_unique<Grasp>(configuracion.tamanoLRC, configuracion.numeroEjecuciones);
+    grasp->setSemilla(configuracion.semilla);
+    return grasp;
+  }
+  if (nombre == "rvnd") {
+    auto rvnd = make_unique<RVND>(configuracion.tamanoLRC, configuracion.numeroEjecuciones);
+    rvnd->setSemilla(configuracion.semilla);
+    return rvnd;
+  }
+  throw invalid_argument("Error: Algoritmo desconocido \"" + nombre + "\" (use voraz, grasp o rvnd)");
+}
+
+// Código que ejecuta el proceso hijo: resuelve la instancia y escribe el resultado en "descriptor"
+[[noreturn]] void ejecutarEnHijo(const string& algoritmoNombre, const string& rutaInstancia, const Configuracion& configuracion, int descriptor) {
+  FILE* salida = fdopen(descriptor, "w");
+  try {
+    Tools dato = leerInstancia(rutaInstancia);
+    unique_ptr<Algoritmo> algoritmo = crear(algoritmoNombre, configuracion);
+    const auto inicio = chrono::steady_clock::now();
+    algoritmo->setDato(dato);
+    algoritmo->ejecutar();
+    const double pared = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    const Tools& mejor = mejorSolucion(*algoritmo);
+    fprintf(salida, "%.9f %zu %zu %.9f\n", pared, mejor.rutasRecoleccion.size(), mejor.rutasTransporte.size(), mejor.calcularDistanciaRecoleccion());
+    fclose(salida);
+    _exit(0);
+  } catch (const exception& e) {
+    fprintf(salida, "ERROR %s\n", e.what());
+    fclose(salida);
+    _exit(1);
+  }
+}
+
+Ejecucion medir(const string& algoritmo, const string& rutaInstancia, const Configuracion& configuracion) {
+  int tuberia[2];
+  if (pipe(tuberia) != 0) throw runtime_error("Error: No se pudo crear la tubería con el proceso hijo");
+  cout.flush();
+  const pid_t hijo = fork();
+  if (hijo < 0) throw runtime_error("Error: No se pudo crear el proceso hijo");
+  if (hijo == 0) {
+    close(tuberia[0]);
+    ejecutarEnHijo(algoritmo, rutaInstancia, configuracion, tuberia[1]);
+  }
+  close(tuberia[1]);
+  string respuesta;
+  char bloque[256];
+  ssize_t leidos;
+  while ((leidos = read(tuberia[0], bloque, sizeof(bloque))) > 0) respuesta.append(bloque, leidos);
+  close(tuberia[0]);
+  int estado = 0;
+  struct rusage uso {};
+  wait4(hijo, &estado, 0, &uso);
+  if (!WIFEXITED(estado) || WEXITSTATUS(estado) != 0) {
+    throw runtime_error("Error: Falló " + algoritmo + " sobre " + rutaInstancia + ": " + respuesta);
+  }
+  Ejecucion ejecucion;
+  ejecucion.algoritmo = algoritmo;
+  ejecucion.instancia = fs::path(rutaInstancia).stem().string();
+  istringstream campos(respuesta);
+  campos >> ejecucion.tiempoPared >> ejecucion.vehiculosRecoleccion >> ejecucion.vehiculosTransporte >> ejecucion.distancia;
+  ejecucion.tiempoCPU = uso.ru_utime.tv_sec + uso.ru_utime.tv_usec / 1e6 + uso.ru_stime.tv_sec + uso.ru_stime.tv_usec / 1e6;
+  ejecucion.memoriaPicoKB = uso.ru_maxrss; // En Linux, en kilobytes
+  return ejecucion;
+}
+
+// Ficheros de instancia de la entrada (directorio, fichero o patrón), ordenados como los lee el programa
+vector<string> ficherosDeInstancia(const string& entrada) {
+  vector<string> rutas;
+  if (fs::is_regular_file(entrada)) return {entrada};
+  for (const auto& fichero : fs::directory_iterator(entrada)) {
+    const string nombre = fichero.path().stem().string();
+    if (fichero.is_regular_file() && nombre.rfind("instance", 0) == 0 && fichero.path().extension() == ".txt") {
+      rutas.push_back(fichero.path().string());
+    }
+  }
+  auto numero = [](const string& ruta) {
+    const string nombre = fs::path(ruta).stem().string().substr(8);
+    return all_of(nombre.begin(), nombre.end(), ::isdigit) && !nombre.empty() ? stoi(nombre) : -1;
+  };
+  sort(rutas.begin(), rutas.end(), [&](const string& a, const string& b) { return numero(a) < numero(b); });
+  if (rutas.empty()) throw invalid_argument("Error: " + entrada + " no contiene ficheros \"instanceN.txt\"");
+  return rutas;
+}
+
+// Línea base: una línea por ejecución con "algoritmo instancia pared cpu memoriaKB CV TV distancia"
+void guardarLineaBase(const vector<Ejecucion>& ejecuciones, const string& ruta) {
+  ofstream salida(ruta);
+  if (!salida.is_open()) throw runtime_error("Error: No se pudo crear la línea base " + ruta);
+  salida << "# algoritmo instancia tiempoPared tiempoCPU memoriaPicoKB CV TV distancia\n";
+  salida << setprecision(9);
+  for (const auto& e : ejecuciones) {
+    salida << e.algoritmo << " " << e.instancia << " " << e.tiempoPared << " " << e.tiempoCPU << " "
+           << e.memoriaPicoKB << " " << e.vehiculosRecoleccion << " " << e.vehiculosTransporte << " " << e.distancia << "\n";
+  }
+}
+
+map<pair<string, string>, Ejecucion> leerLineaBase(const string& ruta) {
+  ifstream entrada(ruta);
+  if (!entrada.is_open()) throw invalid_argument("Error: No se pudo abrir la línea base " + ruta + " (genérela con --guardar)");
+  map<pair<string, string>, Ejecucion> lineaBase;
+  string linea;
+  while (getline(entrada, linea)) {
+    if (linea.empty() || linea[0] == '#') continue;
+    istringstream campos(linea);
+    Ejecucion e;
+    campos >> e.algoritmo >> e.instancia >> e.tiempoPared >> e.tiempoCPU >> e.memoriaPicoKB >> e.vehiculosRecoleccion >> e.vehiculosTransporte >> e.distancia;
+    if (campos) lineaBase[make_pair(e.algoritmo, e.instancia)] = e;
+  }
+  return lineaBase;
+}
+
+// Compara con la línea base e imprime las regresiones; devuelve cuántas hay
+int comparar(const vector<Ejecucion>& ejecuciones, const map<pair<string, string>, Ejecucion>& lineaBase, const Configuracion& configuracion) {
+  int regresiones = 0;
+  cout << "------------------------------------------------------------------------------------------" << endl;
+  cout << left << setw(8) << "Alg." << setw(14) << "Instancia" << setw(22) << "Pared (base -> ahora)"
+       << setw(22) << "Vehículos" << setw(24) << "Distancia" << "Estado" << endl;
+  cout << "------------------------------------------------------------------------------------------" << endl;
+  for (const auto& e : ejecuciones) {
+    auto it = lineaBase.find(make_pair(e.algoritmo, e.instancia));
+    if (it == lineaBase.end()) {
+      cout << left << setw(8) << e.algoritmo << setw(14) << e.instancia << "sin línea base" << endl;
+      continue;
+    }
+    const Ejecucion& base = it->second;
+    vector<string> motivos;
+    if (e.tiempoPared > base.tiempoPared * (1 + configuracion.umbralTiempo) && e.tiempoPared - base.tiempoPared > configuracion.margenTiempo) {
+      motivos.push_back("tiempo");
+    }
+    if (e.vehiculosRecoleccion + e.vehiculosTransporte > base.vehiculosRecoleccion + base.vehiculosTransporte) {
+      motivos.push_back("vehículos");
+    }
+    if (e.distancia > base.distancia * (1 + configuracion.umbralDistancia)) motivos.push_back("distancia");
+    ostringstream pared, vehiculos, distancia;
+    pared << fixed << setprecision(4) << base.tiempoPared << " -> " << e.tiempoPared;
+    vehiculos << base.vehiculosRecoleccion << "+" << base.vehiculosTransporte << " -> " << e.vehiculosRecoleccion << "+" << e.vehiculosTransporte;
+    distancia << fixed << setprecision(2) << base.distancia << " -> " << e.distancia;
+    string estado = "ok";
+    if (!motivos.empty()) {
+      estado = "REGRESIÓN (";
+      for (size_t m = 0; m < motivos.size(); m++) estado += (m > 0 ? ", " : "") + motivos[m];
+      estado += ")";
+      regresiones++;
+    }
+    cout << left << setw(8) << e.algoritmo << setw(14) << e.instancia << setw(22) << pared.str()
+         << setw(22) << vehiculos.str() << setw(24) << distancia.str() << estado << endl;
+  }
+  cout << "------------------------------------------------------------------------------------------" << endl;
+  return regresiones;
+}
+
+void exportarJSON(const vector<Ejecucion>& ejecuciones, const string& ruta) {
+  EscritorJSON salida(ruta);
+  salida.literal("{\"ejecuciones\":[");
+  for (size_t i = 0; i < ejecuciones.size(); i++) {
+    const Ejecucion& e = ejecuciones[i];
+    if (i > 0) salida.literal(",");
+    salida.literal("{\"algoritmo\":");
+    salida.cadena(e.algoritmo);
+    salida.literal(",\"instancia\":");
+    salida.cadena(e.instancia);
+    salida.literal(",\"tiempoPared\":");
+    salida.numero(e.tiempoPared);
+    salida.literal(",\"tiempoCPU\":");
+    salida.numero(e.tiempoCPU);
+    salida.literal(",\"memoriaPicoKB\":");
+    salida.numero(e.memoriaPicoKB);
+    salida.literal(",\"vehiculosRecoleccion\":");
+    salida.numero(e.vehiculosRecoleccion);
+    salida.literal(",\"vehiculosTransporte\":");
+    salida.numero(e.vehiculosTransporte);
+    salida.literal(",\"distancia\":");
+    salida.numero(e.distancia);
+    salida.literal("}");
+  }
+  salida.literal("]}\n");
+}
+
+void mostrarUsoBenchmark(const string& programa) {
+  cout << "Uso: " << programa << " [opciones]" << endl;
+  cout << "  --entrada <ruta>          Directorio o fichero de instancias (por defecto data/)" << endl;
+  cout << "  --algoritmos <a,b,...>    Algoritmos a medir (por defecto voraz,grasp,rvnd)" << endl;
+  cout << "  --semilla <n>             Semilla de GRASP/RVND (por defecto 1)" << endl;
+  cout << "  --lrc <n>, --ejecuciones <n>  Parámetros de GRASP/RVND (por defecto 3 y 3)" << endl;
+  cout << "  --repeticiones <n>        Repeticiones por ejecución; se guarda el mínimo de tiempo (por defecto 3)" << endl;
+  cout << "  --linea-base <fichero>    Fichero de línea base (por defecto bench/linea_base.txt)" << endl;
+  cout << "  --guardar                 Guarda los resultados como nueva línea base en vez de comparar" << endl;
+  cout << "  --umbral-tiempo <f>       Empeoramiento relativo de tiempo tolerado (por defecto 0.25)" << endl;
+  cout << "  --umbral-distancia <f>    Empeoramiento relativo de distancia tolerado (por defecto 0.01)" << endl;
+  cout << "  -o <fichero>              Fichero JSON de resultados (por defecto bench_macro.json)" << endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  Configuracion configuracion;
+  try {
+    for (int i = 1; i < argc; i++) {
+      const string argumento = argv[i];
+      const bool conValor = i + 1 < argc;
+      if (argumento == "-h" || argumento == "--ayuda") {
+        mostrarUsoBenchmark(argv[0]);
+        return 0;
+      }
+      else if (argumento == "--entrada" && conValor) configuracion.entrada = argv[++i];
+      else if (argumento == "--algoritmos" && conValor) {
+        configuracion.algoritmos.clear();
+        istringstream lista(argv[++i]);
+        string algoritmo;
+        while (getline(lista, algoritmo, ',')) configuracion.algoritmos.push_back(algoritmo);
+      }
+      else if (argumento == "--semilla" && conValor) configuracion.semilla = static_cast<unsigned>(stoul(argv[++i]));
+      else if (argumento == "--lrc" && conValor) configuracion.tamanoLRC = stoi(argv[++i]);
+      else if (argumento == "--ejecuciones" && conValor) configuracion.numeroEjecuciones = stoi(argv[++i]);
+      else if (argumento == "--repeticiones" && conValor) configuracion.repeticiones = max(1, stoi(argv[++i]));
+      else if (argumento == "--linea-base" && conValor) configuracion.lineaBase = argv[++i];
+      else if (argumento == "--guardar") configuracion.guardar = true;
+      else if (argumento == "--umbral-tiempo" && conValor) configuracion.umbralTiempo = stod(argv[++i]);
+      else if (argumento == "--umbral-distancia" && conValor) configuracion.umbralDistancia = stod(argv[++i]);
+      else if (argumento == "-o" && conValor) configuracion.salida = argv[++i];
+      else throw invalid_argument("Error: Opción desconocida o sin valor " + argumento);
+    }
+    for (const auto& algoritmo : configuracion.algoritmos) crear(algoritmo, configuracion); // Valida los nombres
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    mostrarUsoBenchmark(argv[0]);
+    return 1;
+  }
+
+  try {
+    const vector<string> instancias = ficherosDeInstancia(configuracion.entrada);
+    vector<Ejecucion> ejecuciones;
+    cout << left << setw(8) << "Alg." << setw(14) << "Instancia" << setw(12) << "Pared (s)" << setw(12) << "CPU (s)"
+         << setw(14) << "Memoria (KB)" << setw(6) << "#CV" << setw(6) << "#TV" << setw(12) << "Distancia" << endl;
+    for (const auto& algoritmo : configuracion.algoritmos) {
+      for (const auto& instancia : instancias) {
+        Ejecucion mejor = medir(algoritmo, instancia, configuracion);
+        for (int r = 1; r < configuracion.repeticiones; r++) {
+          const Ejecucion repeticion = medir(algoritmo, instancia, configuracion);
+          mejor.tiempoPared = min(mejor.tiempoPared, repeticion.tiempoPared);
+          mejor.tiempoCPU = min(mejor.tiempoCPU, repeticion.tiempoCPU);
+          mejor.memoriaPicoKB = min(mejor.memoriaPicoKB, repeticion.memoriaPicoKB);
+        }
+        cout << left << setw(8) << mejor.algoritmo << setw(14) << mejor.instancia << setw(12) << mejor.tiempoPared
+             << setw(12) << mejor.tiempoCPU << setw(14) << mejor.memoriaPicoKB << setw(6) << mejor.vehiculosRecoleccion
+             << setw(6) << mejor.vehiculosTransporte << setw(12) << mejor.distancia << endl;
+        ejecuciones.push_back(mejor);
+      }
+    }
+    exportarJSON(ejecuciones, configuracion.salida);
+    cout << "Resultados exportados a " << configuracion.salida << endl;
+    if (configuracion.guardar) {
+      guardarLineaBase(ejecuciones, configuracion.lineaBase);
+      cout << "Línea base guardada en " << configuracion.lineaBase << endl;
+      return 0;
+    }
+    const int regresiones = comparar(ejecuciones, leerLineaBase(configuracion.lineaBase), configuracion);
+    if (regresiones > 0) {
+      cout << regresiones << " regresiones respecto a " << configuracion.lineaBase << endl;
+      return 2;
+    }
+    cout << "Sin regresiones respecto a " << configuracion.lineaBase << endl;
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
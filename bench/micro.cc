@@ -0,0 +1,431 @@
+/**
+ * @file micro.cc
+ * @brief Microbenchmarks de las funciones críticas del programa (matriz de distancias, selección de la
+ *        zona más cercana, factibilidad y coste de rutas, operadores de búsqueda local y fase de
+ *        transporte) sobre instancias sintéticas de varios tamaños. Informa de ns/op, asignaciones/op,
+ *        bytes/op y rendimiento, y escribe los resultados en JSON para compararlos entre versiones.
+ */
+#include "../src/tools/tools.h"
+#include "../src/tools/escritor_json/escritor_json.h"
+#include "../src/algoritmo/voraz/voraz.h"
+#include "../src/algoritmo/grasp/grasp.h"
+#include "../src/algoritmo/grasp/busqueda_local/busqueda_local.h"
+#include "../src/algoritmo/grasp/ruina_recreacion/ruina_recreacion.h"
+#include "../src/algoritmo/constructor/constructor.h"
+#include "../src/algoritmo/insercion/insercion.h"
+#include "../src/algoritmo/insercion_arrepentimiento/insercion_arrepentimiento.h"
+#include "../generador/generador.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <type_traits>
+
+using namespace std;
+
+// ---------- Contador de asignaciones (sustituye al operator new/delete global de este ejecutable) ----------
+
+namespace {
+atomic<uint64_t> asignaciones{0};
+atomic<uint64_t> bytesAsignados{0};
+} // namespace
+
+void* operator new(size_t bytes) {
+  asignaciones.fetch_add(1, memory_order_relaxed);
+  bytesAsignados.fetch_add(bytes, memory_order_relaxed);
+  if (void* puntero = malloc(bytes > 0 ? bytes : 1)) return puntero;
+  throw bad_alloc();
+}
+void operator delete(void* puntero) noexcept { free(puntero); }
+void operator delete(void* puntero, size_t) noexcept { free(puntero); }
+
+namespace {
+
+// Impide que el compilador elimine el cálculo cuyo resultado no se usa
+template <typename T>
+inline void hacerVisible(const T& valor) {
+  asm volatile("" : : "g"(&valor) : "memory");
+}
+
+struct Medida {
+  string kernel;
+  int zonas;
+  uint64_t iteraciones;
+  double nsPorOp;
+  double asignacionesPorOp;
+  double bytesPorOp;
+  double opsPorSegundo;
+  double elementosPorSegundo; // Elementos procesados por segundo (zonas, pares de zonas, paradas...)
+};
+
+class Banco {
+  public:
+    Banco(double tiempoMinimo, const string& filtro) : tiempoMinimo_(tiempoMinimo), filtro_(filtro) {}
+
+    // Mide "cuerpo" en lotes (para operaciones cortas que se pueden repetir sin preparar nada)
+    template <typename Cuerpo>
+    void medir(const string& kernel, int zonas, double elementosPorOp, Cuerpo&& cuerpo) {
+      if (!seleccionado(kernel)) return;
+      cuerpo(); // Calentamiento
+      uint64_t lote = 1, iteraciones = 0;
+      double segundos = 0.0;
+      const uint64_t asignacionesAntes = asignaciones.load(), bytesAntes = bytesAsignados.load();
+      while (segundos < tiempoMinimo_) {
+        const auto inicio = chrono::steady_clock::now();
+        for (uint64_t i = 0; i < lote; i++) cuerpo();
+        const double duracion = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        segundos += duracion;
+        iteraciones += lote;
+        if (duracion < 1e-3) lote *= 2;
+      }
+      registrar(kernel, zonas, elementosPorOp, iteraciones, segundos, asignaciones.load() - asignacionesAntes, bytesAsignados.load() - bytesAntes);
+    }
+
+    // Mide "cuerpo" de uno en uno, ejecutando antes "preparar" fuera del tiempo medido
+    // (para operaciones que modifican su entrada, como los operadores de búsqueda local)
+    template <typename Preparar, typename Cuerpo>
+    void medirConPreparacion(const string& kernel, int zonas, double elementosPorOp, Preparar&& preparar, Cuerpo&& cuerpo) {
+      if (!seleccionado(kernel)) return;
+      uint64_t iteraciones = 0, asignacionesMedidas = 0, bytesMedidos = 0;
+      double segundos = 0.0;
+      while (segundos < tiempoMinimo_ || iteraciones < 3) {
+        preparar();
+        const uint64_t asignacionesAntes = asignaciones.load(), bytesAntes = bytesAsignados.load();
+        const auto inicio = chrono::steady_clock::now();
+        cuerpo();
+        segundos += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        asignacionesMedidas += asignaciones.load() - asignacionesAntes;
+        bytesMedidos += bytesAsignados.load() - bytesAntes;
+        iteraciones++;
+      }
+      registrar(kernel, zonas, elementosPorOp, iteraciones, segundos, asignacionesMedidas, bytesMedidos);
+    }
+
+    const vector<Medida>& medidas() const { return medidas_; }
+
+  private:
+    bool seleccionado(const string& kernel) const { return filtro_.empty() || kernel.find(filtro_) != string::npos; }
+
+    void registrar(const string& kernel, int zonas, double elementosPorOp, uint64_t iteraciones, double segundos, uint64_t asignacionesTotales, uint64_t bytesTotales) {
+      const double ops = static_cast<double>(iteraciones);
+      Medida medida{kernel, zonas, iteraciones, segundos * 1e9 / ops, asignacionesTotales / ops, bytesTotales / ops, ops / segundos, elementosPorOp * ops / segundos};
+      cout << left << setw(28) << medida.kernel << setw(8) << medida.zonas << setw(12) << medida.iteraciones
+           << setw(16) << medida.nsPorOp << setw(14) << medida.asignacionesPorOp << setw(14) << medida.bytesPorOp
+           << setw(16) << medida.elementosPorSegundo << endl;
+      medidas_.push_back(std::move(medida));
+    }
+
+    double tiempoMinimo_;
+    string filtro_;
+    vector<Medida> medidas_;
+};
+
+// Con tramosLargos, zonas con poco contenido y tiempo de procesado: caben unas diez entre dos SWTS
+Tools instanciaSintetica(int zonas, bool tramosLargos = false) {
+  ConfiguracionGenerador configuracion;
+  configuracion.numeroZonas = zonas;
+  configuracion.semilla = 1;
+  if (tramosLargos) {
+    configuracion.contenido = {DistribucionValores::Tipo::uniforme, 60.0, 120.0};
+    configuracion.tiempo = {DistribucionValores::Tipo::uniforme, 5.0, 10.0};
+  }
+  stringstream texto;
+  generarInstancia(configuracion, texto);
+  return leerInstancia(texto, "sintetica" + to_string(zonas));
+}
+
+// Solución de partida para los kernels que trabajan sobre rutas: la construcción voraz
+Tools solucionVoraz(const Tools& instancia) {
+  Tools dato = instancia;
+  Voraz voraz(dato);
+  voraz.calcularRutasRecoleccion();
+  return dato;
+}
+
+double paradasMedias(const vector<Recoleccion>& rutas) {
+  double paradas = 0.0;
+  for (const auto& ruta : rutas) paradas += ruta.getZonasVisitadas().size();
+  return paradas / max<size_t>(rutas.size(), 1);
+}
+
+void medirInstancia(Banco& banco, int zonas) {
+  const Tools instancia = instanciaSintetica(zonas);
+  const int n = static_cast<int>(instancia.zonas.size());
+
+  banco.medir("calcularDistancias", zonas, double(n) * n, [&]() {
+    auto distancias = calcularDistancias(instancia);
+    hacerVisible(distancias);
+  });
+  banco.medir("calcularDistancias<u16>", zonas, double(n) * n, [&]() {
+    auto distancias = calcularDistancias(instancia, PrecisionDistancias::fija16);
+    hacerVisible(distancias);
+  });
+
+  // Selección de la siguiente zona con cada política, desde cada zona de recolección por turnos
+  vector<int> posiciones;
+  for (int i = 0; i < n; i++) {
+    if (!instancia.zonas[i].esSWTS() && i != instancia.indiceDeposito && i != instancia.indiceVertedero) posiciones.push_back(i);
+  }
+  // "vecindario" sólo lleva el tipo: VecindarioMatriz<T> o VecindarioRejilla (índice espacial, sin matriz)
+  auto medirPolitica = [&](const string& nombre, auto politica, auto vecindario, PrecisionDistancias precision = PrecisionDistancias::doble) {
+    Tools dato = instancia;
+    if (precision != PrecisionDistancias::doble) dato.distancias = calcularDistancias(instancia, precision);
+    Constructor<decltype(politica), typename decltype(vecindario)::type> constructor(dato, std::move(politica));
+    size_t siguiente = 0;
+    banco.medir(nombre, zonas, n, [&]() {
+      int zona = constructor.elegirZona(posiciones[siguiente++ % posiciones.size()]);
+      hacerVisible(zona);
+    });
+  };
+  const type_identity<VecindarioMatriz<double>> matriz;
+  const type_identity<VecindarioRejilla> rejilla;
+  mt19937 generador(1);
+  medirPolitica("elegirZona<MasCercana>", PoliticaMasCercana{}, matriz);
+  medirPolitica("elegirZona<LRCCardinalidad>", PoliticaLRCCardinalidad(3, generador), matriz);
+  medirPolitica("elegirZona<LRCValor>", PoliticaLRCValor(0.2, generador), matriz);
+  medirPolitica("elegirZona<Arrepentimiento>", PoliticaArrepentimiento(3), matriz);
+  medirPolitica("elegirZona<MasCercana> f32", PoliticaMasCercana{}, type_identity<VecindarioMatriz<float>>{}, PrecisionDistancias::simple);
+  medirPolitica("elegirZona<MasCercana> u16", PoliticaMasCercana{}, type_identity<VecindarioMatriz<uint16_t>>{}, PrecisionDistancias::fija16);
+  medirPolitica("elegirZona<LRCCardinalidad> u16", PoliticaLRCCardinalidad(3, generador), type_identity<VecindarioMatriz<uint16_t>>{}, PrecisionDistancias::fija16);
+  medirPolitica("rejilla<MasCercana>", PoliticaMasCercana{}, rejilla);
+  medirPolitica("rejilla<LRCCardinalidad>", PoliticaLRCCardinalidad(3, generador), rejilla);
+  medirPolitica("rejilla<Arrepentimiento>", PoliticaArrepentimiento(3), rejilla);
+
+  // Construcción completa de las rutas de Voraz, con la matriz y sin ella (la copia de la instancia no se mide)
+  Tools instanciaSinMatriz = instancia;
+  instanciaSinMatriz.distancias = monostate{};
+  for (const Tools* origen : {&instancia, static_cast<const Tools*>(&instanciaSinMatriz)}) {
+    Tools dato;
+    banco.medirConPreparacion(!tieneMatriz(origen->distancias) ? "construir (rejilla)" : "construir (matriz)", zonas, n,
+      [&]() { dato = *origen; },
+      [&]() {
+        construirRutas(dato, PoliticaMasCercana{});
+        hacerVisible(dato.rutasRecoleccion);
+      });
+  }
+  {
+    Tools dato;
+    banco.medirConPreparacion("construir (insercion)", zonas, n,
+      [&]() { dato = instancia; },
+      [&]() {
+        InsercionArrepentimiento(dato).construir();
+        hacerVisible(dato.rutasRecoleccion);
+      });
+  }
+
+  const Tools solucion = solucionVoraz(instancia);
+  const vector<Recoleccion>& rutas = solucion.rutasRecoleccion;
+  const double paradas = paradasMedias(rutas);
+  BusquedaLocal local;
+  {
+    size_t siguiente = 0;
+    banco.medir("BusquedaLocal::esFactible", zonas, paradas, [&]() {
+      bool factible = BusquedaLocal::esFactible(rutas[siguiente++ % rutas.size()]);
+      hacerVisible(factible);
+    });
+    siguiente = 0;
+    banco.medir("calcularCostoRuta", zonas, paradas, [&]() {
+      double costo = BusquedaLocal::calcularCostoRuta(rutas[siguiente++ % rutas.size()]);
+      hacerVisible(costo);
+    });
+  }
+
+  {
+    // Deltas de inserción en una ruta que recorre todas las zonas, con cada kernel
+    vector<double> x, y, deltaDistancia(n), deltaDistanciaEscalar(n);
+    vector<int> deltaTiempo(n), deltaTiempoEscalar(n);
+    for (const auto& zona : instancia.zonas) {
+      x.push_back(zona.getPosicion().first);
+      y.push_back(zona.getPosicion().second);
+    }
+    for (int i = 0; i < n; i++) {
+      deltasInsercion(x.data(), y.data(), n, x[i] + 0.5, y[i], instancia.velocidad, deltaDistancia.data(), deltaTiempo.data());
+      deltasInsercionEscalar(x.data(), y.data(), n, x[i] + 0.5, y[i], instancia.velocidad, deltaDistanciaEscalar.data(), deltaTiempoEscalar.data());
+      if (!equal(deltaDistancia.begin() + 1, deltaDistancia.end(), deltaDistanciaEscalar.begin() + 1) ||
+          !equal(deltaTiempo.begin() + 1, deltaTiempo.end(), deltaTiempoEscalar.begin() + 1)) {
+        throw runtime_error("deltasInsercion: el kernel vectorial no coincide con el escalar");
+      }
+    }
+    size_t siguiente = 0;
+    banco.medir(insercionVectorial() ? "deltasInsercion (AVX2)" : "deltasInsercion", zonas, n, [&]() {
+      const size_t i = siguiente++ % n;
+      deltasInsercion(x.data(), y.data(), n, x[i] + 0.5, y[i], instancia.velocidad, deltaDistancia.data(), deltaTiempo.data());
+      hacerVisible(deltaDistancia);
+    });
+    siguiente = 0;
+    banco.medir("deltasInsercion (escalar)", zonas, n, [&]() {
+      const size_t i = siguiente++ % n;
+      deltasInsercionEscalar(x.data(), y.data(), n, x[i] + 0.5, y[i], instancia.velocidad, deltaDistancia.data(), deltaTiempo.data());
+      hacerVisible(deltaDistancia);
+    });
+  }
+
+  vector<Recoleccion> trabajo;
+  auto restaurar = [&]() {
+    trabajo = rutas;
+    local.setVehiculos(trabajo);
+  };
+  banco.medirConPreparacion("swapInter", zonas, zonas, restaurar, [&]() { hacerVisible(local.swapInter()); });
+  banco.medirConPreparacion("swapIntra", zonas, zonas, restaurar, [&]() { hacerVisible(local.swapIntra()); });
+  banco.medirConPreparacion("reinsertIntra", zonas, zonas, restaurar, [&]() { hacerVisible(local.reinsertIntra()); });
+  banco.medirConPreparacion("reinsertInter", zonas, zonas, restaurar, [&]() { hacerVisible(local.reinsertInter()); });
+  banco.medirConPreparacion("twoOptIntra", zonas, zonas, restaurar, [&]() { hacerVisible(local.twoOptIntra()); });
+
+  {
+    // Operadores intra-ruta hasta que no mejoran, sin y con la ordenación exacta de los tramos, sobre
+    // rutas con tramos largos entre SWTS (en la instancia por defecto tienen una o dos zonas)
+    const Tools largos = solucionVoraz(instanciaSintetica(zonas, true));
+    BusquedaLocal exacta;
+    exacta.setTramosExactos(SecuenciadorExacto::kMaxZonas);
+    for (BusquedaLocal* busqueda : {&local, &exacta}) {
+      banco.medirConPreparacion(busqueda == &exacta ? "intra (exacto)" : "intra (operadores)", zonas, zonas,
+        [&]() {
+          trabajo = largos.rutasRecoleccion;
+          busqueda->setVehiculos(trabajo);
+        },
+        [&]() {
+          bool mejorado = true;
+          while (mejorado) {
+            mejorado = busqueda == &exacta && busqueda->tramosExactos();
+            mejorado |= busqueda->swapIntra();
+            mejorado |= busqueda->reinsertIntra();
+            mejorado |= busqueda->twoOptIntra();
+          }
+          hacerVisible(trabajo);
+        });
+    }
+  }
+
+  {
+    // Con LNS, cada combinación de GRASP aplica la suya aunque repita la construcción de otra (con
+    // arrepentimiento, todas las ejecuciones de un tamaño de LRC construyen lo mismo)
+    constexpr int kIteraciones = 20, kEjecuciones = 3, kLRC = 3;
+    Tools dato = instancia;
+    Grasp grasp(dato, kLRC, kEjecuciones);
+    ConfiguracionLNS configuracion;
+    configuracion.iteraciones = kIteraciones;
+    grasp.setSemilla(1);
+    grasp.setSeleccion(TipoSeleccion::arrepentimiento, 0.2);
+    grasp.setLNS(configuracion, false);
+    grasp.ejecutar();
+    uint64_t iteraciones = 0;
+    for (const auto& resultado : grasp.getDato(dato)) iteraciones += resultado->metricas.lns.iteraciones;
+    if (iteraciones != static_cast<uint64_t>(kIteraciones) * kEjecuciones * (kLRC - 1)) {
+      throw runtime_error("Grasp: la LNS no se ha aplicado una vez por combinación");
+    }
+  }
+
+  {
+    // Ruina y recreación sobre la solución voraz: el coste de una iteración depende de las zonas que se
+    // quitan y no del tamaño de la instancia (sólo la carga de la solución al empezar es O(n))
+    constexpr int kIteraciones = 100;
+    ConfiguracionLNS configuracion;
+    configuracion.iteraciones = kIteraciones;
+    mt19937 generadorLNS(1);
+    RuinaRecreacion lns(solucion, configuracion, generadorLNS);
+    banco.medirConPreparacion("lns (100 iteraciones)", zonas, kIteraciones,
+      [&]() {
+        trabajo = rutas;
+        lns.setVehiculos(trabajo);
+      },
+      [&]() {
+        hacerVisible(lns.mejorar());
+        hacerVisible(trabajo);
+      });
+  }
+
+  {
+    Tools dato = solucion;
+    Voraz voraz(dato);
+    banco.medir("calcularRutasTransporte", zonas, rutas.size(), [&]() {
+      voraz.calcularRutasTransporte();
+      hacerVisible(dato.rutasTransporte);
+    });
+  }
+}
+
+void exportarJSON(const vector<Medida>& medidas, const string& rutaSalida) {
+  EscritorJSON salida(rutaSalida);
+  salida.literal("{\"benchmarks\":[");
+  for (size_t i = 0; i < medidas.size(); i++) {
+    const Medida& medida = medidas[i];
+    if (i > 0) salida.literal(",");
+    salida.literal("{\"kernel\":");
+    salida.cadena(medida.kernel);
+    salida.literal(",\"zonas\":");
+    salida.numero(medida.zonas);
+    salida.literal(",\"iteraciones\":");
+    salida.numero(medida.iteraciones);
+    salida.literal(",\"nsPorOp\":");
+    salida.numero(medida.nsPorOp);
+    salida.literal(",\"asignacionesPorOp\":");
+    salida.numero(medida.asignacionesPorOp);
+    salida.literal(",\"bytesPorOp\":");
+    salida.numero(medida.bytesPorOp);
+    salida.literal(",\"opsPorSegundo\":");
+    salida.numero(medida.opsPorSegundo);
+    salida.literal(",\"elementosPorSegundo\":");
+    salida.numero(medida.elementosPorSegundo);
+    salida.literal("}");
+  }
+  salida.literal("]}\n");
+}
+
+void mostrarUsoBenchmark(const string& programa) {
+  cout << "Uso: " << programa << " [opciones]" << endl;
+  cout << "  --tamanos <n,n,...>   Zonas de las instancias sintéticas (por defecto 50,200,1000)" << endl;
+  cout << "  --tiempo <segundos>   Tiempo mínimo de medida por kernel (por defecto 0.2)" << endl;
+  cout << "  --filtro <texto>      Sólo los kernels cuyo nombre contenga el texto" << endl;
+  cout << "  -o <fichero>          Fichero JSON de resultados (por defecto bench_micro.json)" << endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  vector<int> tamanos = {50, 200, 1000};
+  double tiempoMinimo = 0.2;
+  string filtro, rutaSalida = "bench_micro.json";
+  try {
+    for (int i = 1; i < argc; i++) {
+      const string argumento = argv[i];
+      const bool conValor = i + 1 < argc;
+      if (argumento == "-h" || argumento == "--ayuda") {
+        mostrarUsoBenchmark(argv[0]);
+        return 0;
+      } else if (argumento == "--tamanos" && conValor) {
+        tamanos.clear();
+        stringstream lista(argv[++i]);
+        string tamano;
+        while (getline(lista, tamano, ',')) tamanos.push_back(stoi(tamano));
+      } else if (argumento == "--tiempo" && conValor) {
+        tiempoMinimo = stod(argv[++i]);
+      } else if (argumento == "--filtro" && conValor) {
+        filtro = argv[++i];
+      } else if (argumento == "-o" && conValor) {
+        rutaSalida = argv[++i];
+      } else {
+        throw invalid_argument("Error: Opción desconocida o sin valor " + argumento);
+      }
+    }
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    mostrarUsoBenchmark(argv[0]);
+    return 1;
+  }
+
+  cout << left << setw(28) << "Kernel" << setw(8) << "Zonas" << setw(12) << "Iter."
+       << setw(16) << "ns/op" << setw(14) << "asig./op" << setw(14) << "bytes/op" << setw(16) << "elementos/s" << endl;
+  Banco banco(tiempoMinimo, filtro);
+  try {
+    for (int zonas : tamanos) medirInstancia(banco, zonas);
+    exportarJSON(banco.medidas(), rutaSalida);
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  cout << "Resultados exportados a " << rutaSalida << endl;
+  return 0;
+}
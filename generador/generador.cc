@@ -0,0 +1,167 @@
+#include "generador.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using std::string;
+using std::vector;
+using std::pair;
+using std::invalid_argument;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+double generarValor(const DistribucionValores& distribucion, std::mt19937& generador) {
+  const double rango = distribucion.maximo - distribucion.minimo;
+  double valor = distribucion.minimo;
+  switch (distribucion.tipo) {
+    case DistribucionValores::Tipo::uniforme:
+      valor = std::uniform_real_distribution<double>(distribucion.minimo, distribucion.maximo)(generador);
+      break;
+    case DistribucionValores::Tipo::normal:
+      valor = std::normal_distribution<double>(distribucion.minimo + rango / 2, rango / 6)(generador);
+      break;
+    case DistribucionValores::Tipo::exponencial:
+      valor = distribucion.minimo + std::exponential_distribution<double>(3.0 / std::max(rango, 1e-9))(generador);
+      break;
+  }
+  return std::clamp(std::round(valor), distribucion.minimo, distribucion.maximo);
+}
+
+// Escribe un número entero con el ".0" final, como en las instancias originales
+string comoReal(double valor) {
+  std::ostringstream texto;
+  texto << static_cast<long long>(std::llround(valor)) << ".0";
+  return texto.str();
+}
+
+} // namespace
+
+/**
+ * @brief Función para generar una instancia sintética y escribirla en el formato de "data/instanceN.txt"
+ *        (L1, L2, num_vehicles, num_zones, Lx, Ly, Q1, Q2, V, Depot, IF, IF1..., Dumpsite y las zonas).
+ *        El resultado sólo depende de la configuración (incluida la semilla).
+ * @param configuracion Parámetros de la instancia
+ * @param salida Flujo en el que se escribe
+ * @return void
+ * @throws std::invalid_argument si la configuración no es válida
+ */
+void generarInstancia(const ConfiguracionGenerador& configuracion, std::ostream& salida) {
+  if (configuracion.numeroZonas < 1) throw invalid_argument("Error: La instancia debe tener al menos una zona");
+  if (configuracion.numeroSWTS < 1) throw invalid_argument("Error: La instancia debe tener al menos una SWTS");
+  if (configuracion.contenido.maximo > configuracion.capacidadRecoleccion) {
+    // Una zona que no cabe en un vehículo vacío no se podría recoger nunca
+    throw invalid_argument("Error: El contenido máximo de una zona no puede superar la capacidad Q1");
+  }
+  if (configuracion.contenido.minimo < 0 || configuracion.tiempo.minimo < 0 ||
+      configuracion.contenido.minimo > configuracion.contenido.maximo || configuracion.tiempo.minimo > configuracion.tiempo.maximo) {
+    throw invalid_argument("Error: Los rangos de contenido y tiempo deben ser no negativos y con mínimo <= máximo");
+  }
+  std::mt19937 generador(configuracion.semilla);
+  const int ladoPorDefecto = std::max(20, static_cast<int>(std::ceil(3 * std::sqrt(configuracion.numeroZonas))));
+  const int maxX = configuracion.maxX > 0 ? configuracion.maxX : ladoPorDefecto;
+  const int maxY = configuracion.maxY > 0 ? configuracion.maxY : ladoPorDefecto;
+  const double diagonal = std::hypot(maxX, maxY);
+  const int velocidad = configuracion.velocidad > 0 ? configuracion.velocidad
+      : std::max(30, static_cast<int>(std::ceil(diagonal * 60 * 4 / configuracion.duracionRecoleccion)));
+
+  salida << "L1 " << configuracion.duracionRecoleccion << "\n";
+  salida << "L2 " << configuracion.duracionTransporte << "\n";
+  salida << "num_vehicles " << (configuracion.numeroZonas + 3) / 4 << "\n";
+  salida << "num_zones " << configuracion.numeroZonas << "\n";
+  salida << "Lx " << maxX << "\n";
+  salida << "Ly " << maxY << "\n";
+  salida << "Q1 " << configuracion.capacidadRecoleccion << "\n";
+  salida << "Q2 " << configuracion.capacidadTransporte << "\n";
+  salida << "V " << velocidad << "\n";
+  salida << "Depot " << maxX / 2 << " " << maxY / 2 << "\n";
+  // Las SWTS se reparten en una circunferencia alrededor del depósito
+  for (int s = 0; s < configuracion.numeroSWTS; s++) {
+    const double angulo = 2 * kPi * s / configuracion.numeroSWTS + kPi;
+    const int x = std::clamp(static_cast<int>(std::lround(maxX / 2.0 + 0.35 * maxX * std::cos(angulo))), 0, maxX);
+    const int y = std::clamp(static_cast<int>(std::lround(maxY / 2.0 + 0.35 * maxY * std::sin(angulo))), 0, maxY);
+    salida << (s == 0 ? string("IF") : "IF" + std::to_string(s)) << " " << x << " " << y << "\n";
+  }
+  // El vertedero queda fuera del plano, como en las instancias originales
+  salida << "Dumpsite " << maxX / 2 << " " << 3 * maxY << "\n";
+
+  vector<pair<double, double>> centros;
+  if (configuracion.distribucion == DistribucionEspacial::agrupada) {
+    std::uniform_real_distribution<double> centroX(0.1 * maxX, 0.9 * maxX), centroY(0.1 * maxY, 0.9 * maxY);
+    for (int g = 0; g < std::max(1, configuracion.numeroGrupos); g++) centros.emplace_back(centroX(generador), centroY(generador));
+  }
+  std::uniform_real_distribution<double> uniformeX(0, maxX), uniformeY(0, maxY), unidad(0, 1);
+  std::normal_distribution<double> ruido(0, 1);
+  const double dispersionGrupo = std::min(maxX, maxY) / (4.0 * std::sqrt(static_cast<double>(centros.size() + 1)));
+  for (int z = 1; z <= configuracion.numeroZonas; z++) {
+    double x = 0, y = 0;
+    switch (configuracion.distribucion) {
+      case DistribucionEspacial::uniforme:
+        x = uniformeX(generador);
+        y = uniformeY(generador);
+        break;
+      case DistribucionEspacial::agrupada: {
+        const auto& centro = centros[std::uniform_int_distribution<size_t>(0, centros.size() - 1)(generador)];
+        x = centro.first + ruido(generador) * dispersionGrupo;
+        y = centro.second + ruido(generador) * dispersionGrupo;
+        break;
+      }
+      case DistribucionEspacial::corredor: {
+        // Punto de la diagonal del plano desplazado perpendicularmente un 5% del lado
+        const double t = unidad(generador), desplazamiento = ruido(generador) * 0.05 * std::min(maxX, maxY);
+        x = t * maxX - desplazamiento * maxY / diagonal;
+        y = t * maxY + desplazamiento * maxX / diagonal;
+        break;
+      }
+    }
+    x = std::clamp(std::round(x), 0.0, static_cast<double>(maxX));
+    y = std::clamp(std::round(y), 0.0, static_cast<double>(maxY));
+    const double tiempo = generarValor(configuracion.tiempo, generador);
+    const double contenido = generarValor(configuracion.contenido, generador);
+    salida << z << " " << comoReal(x) << " " << comoReal(y) << " " << comoReal(tiempo) << " " << comoReal(contenido) << "\n";
+  }
+}
+
+/**
+ * @brief Función para interpretar el nombre de una distribución espacial
+ * @param texto "uniforme", "agrupada" o "corredor"
+ * @return DistribucionEspacial Distribución correspondiente
+ * @throws std::invalid_argument si el nombre no es válido
+ */
+DistribucionEspacial distribucionEspacialDeTexto(const string& texto) {
+  if (texto == "uniforme") return DistribucionEspacial::uniforme;
+  if (texto == "agrupada") return DistribucionEspacial::agrupada;
+  if (texto == "corredor") return DistribucionEspacial::corredor;
+  throw invalid_argument("Error: Distribución espacial desconocida \"" + texto + "\" (use uniforme, agrupada o corredor)");
+}
+
+/**
+ * @brief Función para interpretar una distribución de valores con el formato "tipo:minimo:maximo"
+ * @param texto Texto a interpretar, p.ej. "normal:300:400"
+ * @return DistribucionValores Distribución correspondiente
+ * @throws std::invalid_argument si el texto no es válido
+ */
+DistribucionValores distribucionValoresDeTexto(const string& texto) {
+  std::istringstream partes(texto);
+  string tipo, minimo, maximo;
+  if (!getline(partes, tipo, ':') || !getline(partes, minimo, ':') || !getline(partes, maximo)) {
+    throw invalid_argument("Error: La distribución \"" + texto + "\" debe tener el formato tipo:minimo:maximo");
+  }
+  DistribucionValores distribucion;
+  if (tipo == "uniforme") distribucion.tipo = DistribucionValores::Tipo::uniforme;
+  else if (tipo == "normal") distribucion.tipo = DistribucionValores::Tipo::normal;
+  else if (tipo == "exponencial") distribucion.tipo = DistribucionValores::Tipo::exponencial;
+  else throw invalid_argument("Error: Tipo de distribución desconocido \"" + tipo + "\" (use uniforme, normal o exponencial)");
+  try {
+    distribucion.minimo = std::stod(minimo);
+    distribucion.maximo = std::stod(maximo);
+  } catch (const std::exception&) {
+    throw invalid_argument("Error: Los límites de la distribución \"" + texto + "\" deben ser números");
+  }
+  return distribucion;
+}
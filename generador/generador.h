@@ -0,0 +1,47 @@
+/**
+ * @brief Generador de instancias sintéticas en el formato de "data/instanceN.txt", para estudiar
+ *        cómo escalan los algoritmos con el número de zonas
+ */
+
+#ifndef C_Generador_H
+#define C_Generador_H
+
+#include <ostream>
+#include <string>
+
+// Cómo se reparten las zonas de recolección por el plano
+enum class DistribucionEspacial {
+  uniforme, // Uniforme en todo el plano
+  agrupada, // Alrededor de varios centros (barrios)
+  corredor // A lo largo de una diagonal del plano (una avenida)
+};
+
+// Distribución de una magnitud de las zonas (contenido o tiempo de procesado) entre "minimo" y "maximo"
+struct DistribucionValores {
+  enum class Tipo { uniforme, normal, exponencial };
+  Tipo tipo = Tipo::uniforme;
+  double minimo = 0.0;
+  double maximo = 0.0;
+};
+
+struct ConfiguracionGenerador {
+  int numeroZonas = 100; // Zonas de recolección
+  int numeroSWTS = 2; // Estaciones de transferencia (IF, IF1, IF2...)
+  DistribucionEspacial distribucion = DistribucionEspacial::uniforme;
+  int numeroGrupos = 5; // Centros de la distribución agrupada
+  int maxX = 0, maxY = 0; // Tamaño del plano (0 = proporcional a la raíz del número de zonas)
+  int velocidad = 0; // Velocidad de los vehículos (0 = suficiente para cruzar el plano en un cuarto de jornada)
+  int duracionRecoleccion = 480; // L1
+  int duracionTransporte = 480; // L2
+  int capacidadRecoleccion = 900; // Q1
+  int capacidadTransporte = 5100; // Q2
+  DistribucionValores contenido{DistribucionValores::Tipo::uniforme, 300.0, 400.0};
+  DistribucionValores tiempo{DistribucionValores::Tipo::uniforme, 60.0, 120.0};
+  unsigned semilla = 1;
+};
+
+void generarInstancia(const ConfiguracionGenerador& configuracion, std::ostream& salida); // Escribe una instancia
+DistribucionEspacial distribucionEspacialDeTexto(const std::string& texto); // "uniforme", "agrupada" o "corredor"
+DistribucionValores distribucionValoresDeTexto(const std::string& texto); // "tipo:minimo:maximo", p.ej. "normal:300:400"
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file main.cc
+ * @brief Función principal del generador de instancias sintéticas
+ */
+#include "generador.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void mostrarUso(const string& programa) {
+  cout << "Uso: " << programa << " -o <directorio> [opciones]" << endl;
+  cout << "  -o, --directorio <dir>    Directorio en el que se escriben los ficheros \"instanceN.txt\"" << endl;
+  cout << "  -n, --zonas <n>           Zonas de recolección (por defecto 100)" << endl;
+  cout << "  --instancias <n>          Número de instancias a generar (por defecto 1)" << endl;
+  cout << "  --primera <n>             Número de la primera instancia (por defecto 1)" << endl;
+  cout << "  --distribucion <nombre>   uniforme, agrupada o corredor (por defecto uniforme)" << endl;
+  cout << "  --grupos <n>              Centros de la distribución agrupada (por defecto 5)" << endl;
+  cout << "  --swts <n>                Estaciones de transferencia (por defecto 2)" << endl;
+  cout << "  --lx <n>, --ly <n>        Tamaño del plano (por defecto proporcional a sqrt(zonas))" << endl;
+  cout << "  --velocidad <n>           Velocidad de los vehículos (por defecto según el tamaño del plano)" << endl;
+  cout << "  --contenido <t:min:max>   Distribución del contenido (por defecto uniforme:300:400)" << endl;
+  cout << "  --tiempo <t:min:max>      Distribución del tiempo de procesado (por defecto uniforme:60:120)" << endl;
+  cout << "                            t es uniforme, normal o exponencial" << endl;
+  cout << "  --semilla <n>             Semilla; la instancia i usa semilla + i (por defecto 1)" << endl;
+}
+
+string valorDeOpcion(int argc, char* argv[], int& i) {
+  if (i + 1 >= argc) throw invalid_argument("Error: La opción " + string(argv[i]) + " necesita un valor");
+  return argv[++i];
+}
+
+int enteroDeOpcion(const string& valor) {
+  size_t leidos = 0;
+  int numero = 0;
+  try {
+    numero = stoi(valor, &leidos);
+  } catch (const exception&) {
+    leidos = 0;
+  }
+  if (leidos != valor.size() || valor.empty()) throw invalid_argument("Error: \"" + valor + "\" no es un número entero");
+  return numero;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  ConfiguracionGenerador configuracion;
+  string directorio;
+  int numeroInstancias = 1, primera = 1;
+  try {
+    for (int i = 1; i < argc; i++) {
+      const string argumento = argv[i];
+      if (argumento == "-h" || argumento == "--ayuda") {
+        mostrarUso(argv[0]);
+        return 0;
+      }
+      else if (argumento == "-o" || argumento == "--directorio") directorio = valorDeOpcion(argc, argv, i);
+      else if (argumento == "-n" || argumento == "--zonas") configuracion.numeroZonas = enteroDeOpcion(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--instancias") numeroInstancias = enteroDeOpcion(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--primera") primera = enteroDeOpcion(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--distribucion") configuracion.distribucion = distribucionEspacialDeTexto(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--grupos") configuracion.numeroGrupos = enteroDeOpcion(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--swts") configuracion.numeroSWTS = enteroDeOpcion(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--lx") configuracion.maxX = enteroDeOpcion(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--ly") configuracion.maxY = enteroDeOpcion(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--velocidad") configuracion.velocidad = enteroDeOpcion(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--contenido") configuracion.contenido = distribucionValoresDeTexto(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--tiempo") configuracion.tiempo = distribucionValoresDeTexto(valorDeOpcion(argc, argv, i));
+      else if (argumento == "--semilla") configuracion.semilla = static_cast<unsigned>(enteroDeOpcion(valorDeOpcion(argc, argv, i)));
+      else throw invalid_argument("Error: Opción desconocida " + argumento);
+    }
+    if (directorio.empty()) throw invalid_argument("Error: Falta el directorio de salida (-o)");
+    if (numeroInstancias < 1 || primera < 0) throw invalid_argument("Error: --instancias debe ser positivo y --primera no negativo");
+  } catch (const invalid_argument& e) {
+    cerr << e.what() << endl;
+    mostrarUso(argv[0]);
+    return 1;
+  }
+  try {
+    fs::create_directories(directorio);
+    const unsigned semillaBase = configuracion.semilla;
+    for (int i = 0; i < numeroInstancias; i++) {
+      configuracion.semilla = semillaBase + i;
+      const fs::path ruta = fs::path(directorio) / ("instance" + to_string(primera + i) + ".txt");
+      ofstream salida(ruta);
+      if (!salida.is_open()) throw runtime_error("Error: No se pudo crear el fichero " + ruta.string());
+      generarInstancia(configuracion, salida);
+      cout << "Generada " << ruta.string() << " (" << configuracion.numeroZonas << " zonas)" << endl;
+    }
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
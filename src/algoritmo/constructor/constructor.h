@@ -0,0 +1,161 @@
+/**
+ * @class Motor de construcción de las rutas de recolección, común a Voraz y Grasp. La elección de la
+ *        siguiente zona la decide la política (ver politicas.h), que es un parámetro de la plantilla:
+ *        cada algoritmo instancia el motor con la suya y la selección se resuelve en compilación, sin
+ *        llamadas virtuales en el bucle de construcción. Las consultas de cercanía las resuelve el
+ *        vecindario (ver vecindario.h): con la matriz de distancias o, si la instancia se ha leído sin
+ *        ella, con un índice espacial. construirRutas escoge el que corresponde.
+ */
+
+#ifndef C_Constructor_H
+#define C_Constructor_H
+
+#include "politicas.h"
+#include "vecindario.h"
+#include "../../tools/tools.h"
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+template<typename Politica, typename Vecindario = VecindarioMatriz<double>>
+class Constructor {
+  public:
+    Constructor(Tools& dato, Politica politica) : dato_(dato), politica_(std::move(politica)), vecindario_(dato) {}
+
+    void construir(); // Construye las rutas de recolección y las guarda en dato.rutasRecoleccion
+    int elegirZona(int posicion); // Zona que escoge la política estando en la zona "posicion"
+
+  private:
+    int swtsMasCercana(int posicion) const; // SWTS más cercana a la zona "posicion"
+    int tiempoVolverDeposito(const Recoleccion& vehiculo, int posicion); // Tiempo que tarda en volver al depósito pasando por la zona que se escogería y la swts más cercana
+
+    Tools& dato_;
+    Politica politica_;
+    Vecindario vecindario_; // Zonas de recolección sin visitar
+};
+
+/**
+ * @brief Método para escoger la siguiente zona a visitar con la política del constructor
+ * @param posicion Índice en dato.zonas de la posición actual del vehículo
+ * @return int Índice en dato.zonas de la zona escogida
+ */
+template<typename Politica, typename Vecindario>
+int Constructor<Politica, Vecindario>::elegirZona(int posicion) {
+  instrumentar([&] {
+    dato_.metricas.nucleo.zonaMasCercana++;
+    dato_.metricas.nucleo.candidatosExaminados += vecindario_.pendientes();
+  });
+  const int zona = politica_.elegir(vecindario_, posicion);
+  if (zona < 0) {
+    throw std::runtime_error("Constructor::elegirZona: no quedan zonas de recolección candidatas para el vehículo");
+  }
+  return zona;
+}
+
+/**
+ * @brief Método para obtener la swts más cercana
+ * @param posicion Índice en dato.zonas de la posición actual del vehículo
+ * @return int Índice en dato.zonas de la swts más cercana
+ */
+template<typename Politica, typename Vecindario>
+int Constructor<Politica, Vecindario>::swtsMasCercana(int posicion) const {
+  const int swtsCercana = vecindario_.swtsMasCercana(posicion);
+  if (swtsCercana < 0) {
+    throw std::runtime_error("Constructor::swtsMasCercana: la instancia no tiene estaciones de transferencia alcanzables");
+  }
+  return swtsCercana;
+}
+
+/**
+ * @brief Método para obtener el tiempo en que tarda el vehículo en volver al depósito pasando por la zona
+ *        que escoge la política y la swts más cercana. La zona se vuelve a escoger aquí, como hacían Voraz
+ *        y Grasp: con una política aleatoria consume un sorteo y puede no ser la que se visita después.
+ * @param vehiculo Vehículo que se va a mover
+ * @param posicion Índice en dato.zonas de la posición actual del vehículo
+ * @return Tiempo que tarda en volver al depósito
+ */
+template<typename Politica, typename Vecindario>
+int Constructor<Politica, Vecindario>::tiempoVolverDeposito(const Recoleccion& vehiculo, int posicion) {
+  const Zona& swts = dato_.zonas[swtsMasCercana(posicion)];
+  const Zona& zona = dato_.zonas[elegirZona(posicion)];
+  int tiempo = 0;
+  // Tiempo que tarda en llegar a la zona
+  tiempo += vehiculo.calcularTiempo(vehiculo.getPosicion().getDistancia(zona));
+  // Tiempo que tarda en procesar la zona
+  tiempo += zona.getTiempoDeProcesado();
+  // Tiempo que tarda en llegar a la swts más cercana
+  tiempo += vehiculo.calcularTiempo(zona.getDistancia(swts));
+  // Tiempo que tarda en volver al depósito desde la swts más cercana
+  tiempo += vehiculo.calcularTiempo(dato_.deposito().getDistancia(swts));
+  return tiempo;
+}
+
+/**
+ * @brief Método para construir las rutas de los vehículos de recolección. Cada vehículo sale del depósito
+ *        y va a la zona que escoge la política mientras le quepa su contenido y le dé tiempo a volver;
+ *        si no le cabe, descarga en la swts más cercana y sigue. Al acabar la jornada descarga y vuelve.
+ * @return void
+ */
+template<typename Politica, typename Vecindario>
+void Constructor<Politica, Vecindario>::construir() {
+  std::vector<Recoleccion> rutasDeVehiculos;
+  while (!vecindario_.vacio()) {
+    // Creamos el vehículo
+    Recoleccion vehiculo(dato_.capacidadRecoleccion, dato_.velocidad, dato_.deposito(), dato_.duracionRecoleccion);
+    int posicion = dato_.indiceDeposito;
+    while (!vecindario_.vacio()) {
+      const int siguiente = elegirZona(posicion);
+      const int tiempoEnVolverAlDeposito = tiempoVolverDeposito(vehiculo, posicion);
+      const bool daTiempo = tiempoEnVolverAlDeposito <= (vehiculo.getDuracion() - vehiculo.getTiempoTranscurrido());
+      Zona& zona = dato_.zonas[siguiente];
+      // Si el contendio de la zona es menor a la capacidad del vehículo y le da tiempo a volver al deposito
+      if (vehiculo.llenarVehiculo(zona.getContenido()) && daTiempo) {
+        vehiculo.moverVehiculo(zona, dato_.zonas[posicion].getDistancia(zona));
+        vehiculo.vaciarZona(zona);
+        vecindario_.eliminar(siguiente);
+        posicion = siguiente;
+      } else if (daTiempo) {
+        // Si no puede recoger la zona, descarga en la swts más cercana
+        const int swts = swtsMasCercana(posicion);
+        vehiculo.moverVehiculo(dato_.zonas[swts], dato_.zonas[posicion].getDistancia(dato_.zonas[swts]));
+        vehiculo.vaciarVehiculo(dato_.zonas[swts]);
+        posicion = swts;
+      } else {
+        break; // No se puede añadir más zonas
+      }
+    }
+    // Si la última zona visitada no es una swts, buscamos la más cercana
+    if (!vehiculo.getPosicion().esSWTS()) {
+      const int swts = swtsMasCercana(posicion);
+      vehiculo.moverVehiculo(dato_.zonas[swts], dato_.zonas[posicion].getDistancia(dato_.zonas[swts]));
+      vehiculo.vaciarVehiculo(dato_.zonas[swts]);
+    }
+    vehiculo.volverAlInicio();
+    rutasDeVehiculos.push_back(vehiculo);
+  }
+  dato_.zonasRecoleccion.clear(); // Todas las zonas de recolección han quedado visitadas
+  dato_.rutasRecoleccion = std::move(rutasDeVehiculos); // Guardamos las rutas de los vehículos de recolección
+}
+
+/**
+ * @brief Construye las rutas de recolección de la instancia con la política dada, usando la matriz de
+ *        distancias si la instancia la tiene y el índice espacial si se ha leído sin ella
+ * @param dato Instancia
+ * @param politica Política de selección de la siguiente zona
+ * @return void
+ */
+template<typename Politica>
+void construirRutas(Tools& dato, Politica politica) {
+  std::visit([&](const auto& matriz) {
+    using Matriz = std::decay_t<decltype(matriz)>;
+    if constexpr (std::is_same_v<Matriz, std::monostate>) {
+      Constructor<Politica, VecindarioRejilla>(dato, std::move(politica)).construir();
+    } else {
+      Constructor<Politica, VecindarioMatriz<typename Matriz::Valor>>(dato, std::move(politica)).construir();
+    }
+  }, dato.distancias);
+}
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @brief Políticas de selección de la siguiente zona para el Constructor de rutas de recolección.
+ *        Cada política recibe el vecindario del constructor (las zonas pendientes y sus distancias, ver
+ *        vecindario.h) y el índice en Tools::zonas de la posición actual del vehículo, y devuelve el
+ *        índice de la zona elegida, o -1 si no hay ninguna alcanzable. No tienen métodos virtuales: el
+ *        Constructor se instancia con cada una y la selección queda en línea.
+ */
+
+#ifndef C_Politicas_H
+#define C_Politicas_H
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Voraz: la zona pendiente más cercana (a igual distancia, la de menor índice)
+struct PoliticaMasCercana {
+  template<typename Vecindario>
+  inline int elegir(Vecindario& vecindario, int posicion) { return vecindario.masCercana(posicion); }
+};
+
+// GRASP con LRC por cardinalidad: una zona al azar entre las "tamano" más cercanas
+class PoliticaLRCCardinalidad {
+  public:
+    PoliticaLRCCardinalidad(int tamano, std::mt19937& generador) : tamano_(tamano), generador_(generador) {}
+
+    template<typename Vecindario>
+    inline int elegir(Vecindario& vecindario, int posicion) {
+      vecindario.masCercanas(posicion, tamano_, lista_);
+      if (lista_.empty()) return -1;
+      std::uniform_int_distribution<size_t> dis(0, lista_.size() - 1);
+      return lista_[dis(generador_)].second;
+    }
+
+  private:
+    int tamano_;
+    std::mt19937& generador_;
+    std::vector<std::pair<double, int>> lista_;
+};
+
+// GRASP con LRC por valor: una zona al azar entre las que están a menos de dMin + alfa * (dMax - dMin)
+class PoliticaLRCValor {
+  public:
+    PoliticaLRCValor(double alfa, std::mt19937& generador) : alfa_(alfa), generador_(generador) {}
+
+    template<typename Vecindario>
+    inline int elegir(Vecindario& vecindario, int posicion) {
+      double minDistancia = INFINITY, maxDistancia = -INFINITY;
+      vecindario.paraCadaPendiente(posicion, [&](int, double distancia) {
+        if (!(distancia < INFINITY)) return;
+        minDistancia = std::min(minDistancia, distancia);
+        maxDistancia = std::max(maxDistancia, distancia);
+      });
+      if (!(minDistancia < INFINITY)) return -1;
+      const double umbral = minDistancia + alfa_ * (maxDistancia - minDistancia);
+      lista_.clear();
+      vecindario.paraCadaPendiente(posicion, [&](int j, double distancia) {
+        if (distancia <= umbral) lista_.push_back(j);
+      });
+      std::uniform_int_distribution<size_t> dis(0, lista_.size() - 1);
+      return lista_[dis(generador_)];
+    }
+
+  private:
+    double alfa_;
+    std::mt19937& generador_;
+    std::vector<int> lista_;
+};
+
+// Arrepentimiento: entre las "tamano" más cercanas, la que más costaría dejar para después, es decir, la
+// de mayor diferencia entre la distancia a su zona pendiente más próxima y la distancia desde la posición
+// actual. Es determinista.
+class PoliticaArrepentimiento {
+  public:
+    explicit PoliticaArrepentimiento(int tamano) : tamano_(tamano) {}
+
+    template<typename Vecindario>
+    inline int elegir(Vecindario& vecindario, int posicion) {
+      vecindario.masCercanas(posicion, tamano_, lista_);
+      int mejor = -1;
+      double maxArrepentimiento = -INFINITY;
+      for (const auto& [distancia, j] : lista_) {
+        const int alternativa = vecindario.masCercana(j);
+        const double siguiente = alternativa < 0 ? INFINITY : vecindario.distancia(j, alternativa);
+        // La última zona pendiente no tiene alternativa: se toma sin más
+        const double arrepentimiento = siguiente < INFINITY ? siguiente - distancia : INFINITY;
+        if (arrepentimiento > maxArrepentimiento) {
+          maxArrepentimiento = arrepentimiento;
+          mejor = j;
+        }
+      }
+      return mejor;
+    }
+
+  private:
+    int tamano_;
+    std::vector<std::pair<double, int>> lista_;
+};
+
+#endif
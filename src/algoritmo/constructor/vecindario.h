@@ -0,0 +1,181 @@
+/**
+ * @brief Vecindarios del Constructor: guardan las zonas de recolección pendientes y responden a las
+ *        consultas de cercanía que hacen las políticas (la pendiente más cercana, las k más cercanas,
+ *        recorrer las pendientes y la SWTS más cercana). Hay dos, con la misma interfaz:
+ *        - VecindarioMatriz<T>: lee la matriz Tools::distancias, guardada con el tipo T (ver
+ *          MatrizDistancias), recorriendo todas las pendientes en cada consulta (O(n) por consulta,
+ *          O(n²) de memoria para la matriz).
+ *        - VecindarioRejilla: no usa la matriz; indexa las zonas con un IndiceEspacial y calcula las
+ *          distancias al consultar (O(n) de memoria). Es el que se usa cuando la instancia se ha leído
+ *          sin matriz (ver kMaxZonasMatriz).
+ *        Con la matriz en double las distancias de los dos coinciden (la matriz se calcula con
+ *        Zona::getDistancia, con infinito en la diagonal) y los empates se resuelven por el menor índice,
+ *        así que construyen las mismas rutas. Con un tipo de menos precisión las comparaciones se hacen
+ *        con las distancias redondeadas y la elección puede cambiar.
+ */
+
+#ifndef C_Vecindario_H
+#define C_Vecindario_H
+
+#include "../../tools/tools.h"
+#include "../../tools/indice_espacial/indice_espacial.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Índices en dato.zonas de las zonas de recolección (en orden creciente), para no buscarlas por
+ *        identificador, y de las SWTS
+ * @param dato Instancia
+ * @param recoleccion Vector en el que se dejan las zonas de recolección
+ * @param swts Vector en el que se dejan las SWTS
+ * @return void
+ */
+inline void indicesDeZonas(const Tools& dato, std::vector<int>& recoleccion, std::vector<int>& swts) {
+  std::unordered_set<std::string> ids;
+  for (const Zona& zona : dato.zonasRecoleccion) ids.insert(zona.getId());
+  for (size_t i = 0; i < dato.zonas.size(); i++) {
+    if (ids.count(dato.zonas[i].getId())) recoleccion.push_back(i);
+    if (dato.zonas[i].esSWTS()) swts.push_back(i);
+  }
+}
+
+/**
+ * @brief Las "tamano" zonas pendientes más cercanas, ordenadas por (distancia, índice). Es el orden en
+ *        que las escogía Grasp::zonaMasCercana, por lo que los sorteos posteriores no cambian.
+ * @param matriz Matriz de distancias
+ * @param desde Posición actual
+ * @param pendientes Zonas pendientes en orden creciente
+ * @param tamano Número de zonas a conservar
+ * @param lista Lista en la que se dejan las zonas con su distancia (se reutiliza entre llamadas)
+ * @return void
+ */
+template<typename T>
+inline void zonasMasCercanas(const MatrizDistancias<T>& matriz, int desde, const std::vector<int>& pendientes, const int tamano, std::vector<std::pair<double, int>>& lista) {
+  lista.clear();
+  if (tamano <= 0) return;
+  const T* fila = matriz.fila(desde);
+  for (int j : pendientes) {
+    const double distancia = matriz.decodificar(fila[j]);
+    if (!(distancia < INFINITY)) continue;
+    const bool llena = static_cast<int>(lista.size()) == tamano;
+    // Las pendientes llegan por índice creciente: a igual distancia, la que ya está va antes
+    if (llena && distancia >= lista.back().first) continue;
+    if (llena) lista.pop_back();
+    auto posicion = lista.end();
+    while (posicion != lista.begin() && std::prev(posicion)->first > distancia) --posicion;
+    lista.insert(posicion, std::make_pair(distancia, j));
+  }
+}
+
+template<typename T>
+class VecindarioMatriz {
+  public:
+    explicit VecindarioMatriz(const Tools& dato) : matriz_(std::get<MatrizDistancias<T>>(dato.distancias)) { indicesDeZonas(dato, pendientes_, swts_); }
+
+    inline bool vacio() const { return pendientes_.empty(); }
+    inline size_t pendientes() const { return pendientes_.size(); }
+    inline double distancia(int desde, int hasta) const { return matriz_(desde, hasta); }
+
+    // La pendiente más cercana a la zona "desde", sin contarla a ella (-1 si no hay)
+    inline int masCercana(int desde) const { return masCercanaDe(matriz_.fila(desde), pendientes_); }
+    inline void masCercanas(int desde, int k, std::vector<std::pair<double, int>>& lista) const { zonasMasCercanas(matriz_, desde, pendientes_, k, lista); }
+    inline int swtsMasCercana(int desde) const { return masCercanaDe(matriz_.fila(desde), swts_); }
+
+    // Llama a funcion(j, distancia desde "desde") con cada zona pendiente j, en orden creciente
+    template<typename Funcion>
+    inline void paraCadaPendiente(int desde, Funcion&& funcion) const {
+      const T* fila = matriz_.fila(desde);
+      for (int j : pendientes_) funcion(j, matriz_.decodificar(fila[j]));
+    }
+
+    inline void eliminar(int zona) { pendientes_.erase(std::find(pendientes_.begin(), pendientes_.end(), zona)); }
+
+  private:
+    // Compara los valores guardados, sin decodificarlos: el orden es el mismo
+    static inline int masCercanaDe(const T* fila, const std::vector<int>& zonas) {
+      int mejor = -1;
+      T minDistancia = MatrizDistancias<T>::kInfinito;
+      for (int j : zonas) {
+        if (fila[j] < minDistancia) {
+          minDistancia = fila[j];
+          mejor = j;
+        }
+      }
+      return mejor;
+    }
+
+    const MatrizDistancias<T>& matriz_;
+    std::vector<int> pendientes_; // Zonas de recolección sin visitar, en orden creciente
+    std::vector<int> swts_;
+};
+
+class VecindarioRejilla {
+  public:
+    explicit VecindarioRejilla(const Tools& dato) : zonas_(dato.zonas) {
+      std::vector<int> recoleccion, swts;
+      indicesDeZonas(dato, recoleccion, swts);
+      recoleccion_ = IndiceEspacial(puntos(recoleccion));
+      swts_ = IndiceEspacial(puntos(swts));
+    }
+
+    inline bool vacio() const { return recoleccion_.vacio(); }
+    inline size_t pendientes() const { return recoleccion_.tamano(); }
+    inline double distancia(int desde, int hasta) const { return desde == hasta ? INFINITY : zonas_[desde].getDistancia(zonas_[hasta]); }
+
+    inline int masCercana(int desde) const { return recoleccion_.masCercano(x(desde), y(desde), desde); }
+    inline void masCercanas(int desde, int k, std::vector<std::pair<double, int>>& lista) const {
+      recoleccion_.masCercanos(x(desde), y(desde), std::max(k, 0), lista, desde);
+    }
+    inline int swtsMasCercana(int desde) const { return swts_.masCercano(x(desde), y(desde), desde); }
+
+    // Recorre todas las pendientes (O(n log n)): sólo lo necesita la LRC por valor
+    template<typename Funcion>
+    inline void paraCadaPendiente(int desde, Funcion&& funcion) {
+      recoleccion_.identificadores(ids_);
+      for (int j : ids_) funcion(j, distancia(desde, j));
+    }
+
+    inline void eliminar(int zona) { recoleccion_.eliminar(zona); }
+
+  private:
+    inline double x(int zona) const { return zonas_[zona].getPosicion().first; }
+    inline double y(int zona) const { return zonas_[zona].getPosicion().second; }
+    std::vector<IndiceEspacial::Punto> puntos(const std::vector<int>& indices) const {
+      std::vector<IndiceEspacial::Punto> resultado;
+      resultado.reserve(indices.size());
+      for (int i : indices) resultado.push_back({x(i), y(i), i});
+      return resultado;
+    }
+
+    const std::vector<Zona>& zonas_;
+    IndiceEspacial recoleccion_; // Zonas de recolección sin visitar
+    IndiceEspacial swts_;
+    std::vector<int> ids_;
+};
+
+/**
+ * @brief La SWTS más cercana a cada zona, con el vecindario que usa el Constructor: la matriz de
+ *        distancias si la instancia la tiene y el índice espacial si se ha leído sin ella
+ * @param dato Instancia
+ * @param zonas Índices en dato.zonas de las zonas
+ * @return std::vector<int> Índice en dato.zonas de la SWTS más cercana a cada zona (-1 si no hay ninguna alcanzable)
+ */
+inline std::vector<int> swtsMasCercanas(const Tools& dato, const std::vector<int>& zonas) {
+  std::vector<int> cercanas(zonas.size());
+  auto anotar = [&](const auto& vecindario) {
+    for (size_t i = 0; i < zonas.size(); i++) cercanas[i] = vecindario.swtsMasCercana(zonas[i]);
+  };
+  std::visit([&](const auto& matriz) {
+    using Matriz = std::decay_t<decltype(matriz)>;
+    if constexpr (std::is_same_v<Matriz, std::monostate>) anotar(VecindarioRejilla(dato));
+    else anotar(VecindarioMatriz<typename Matriz::Valor>(dato));
+  }, dato.distancias);
+  return cercanas;
+}
+
+#endif
@@ -0,0 +1,241 @@
+#include "descomposicion.h"
+#include "../constructor/vecindario.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+// Distancia euclídea entre dos puntos (sin redondear, como Zona::getDistancia)
+inline double distancia(const pair<double, double>& a, const pair<double, double>& b) {
+  return hypot(a.first - b.first, a.second - b.second);
+}
+
+inline pair<double, double> posicion(const Zona& zona) {
+  return {static_cast<double>(zona.getPosicion().first), static_cast<double>(zona.getPosicion().second)};
+}
+
+} // namespace
+
+/**
+ * @brief Constructor de la clase: reparte las zonas de recolección de la instancia en como mucho
+ *        configuracion.grupos grupos (los que se quedan vacíos se descartan)
+ * @param dato Instancia
+ * @param configuracion Número de grupos y forma de repartir las zonas
+ * @return Descomposicion
+ */
+Descomposicion::Descomposicion(const Tools& dato, const ConfiguracionDescomposicion& configuracion) {
+  vector<int> recoleccion, swts;
+  indicesDeZonas(dato, recoleccion, swts);
+  const size_t k = min(static_cast<size_t>(max(configuracion.grupos, 1)), recoleccion.size());
+  if (k == 0) return;
+  switch (configuracion.particion) {
+    case TipoParticion::barrido:
+      barrido(dato, recoleccion, k);
+      break;
+    case TipoParticion::kMedias:
+      kMedias(dato, recoleccion, swts, k);
+      break;
+  }
+  grupos_.erase(remove_if(grupos_.begin(), grupos_.end(), [](const vector<int>& grupo) { return grupo.empty(); }), grupos_.end());
+  for (vector<int>& grupo : grupos_) sort(grupo.begin(), grupo.end());
+  grupoDe_.assign(dato.zonas.size(), -1);
+  for (size_t g = 0; g < grupos_.size(); g++) {
+    for (int zona : grupos_[g]) grupoDe_[zona] = static_cast<int>(g);
+  }
+}
+
+/**
+ * @brief Método para repartir las zonas por barrido: se ordenan por su ángulo alrededor del depósito,
+ *        empezando detrás del hueco de ángulo más grande para que ningún sector lo cruce, y se cortan en
+ *        k sectores seguidos con el mismo contenido (el mismo número de zonas si no tienen contenido)
+ * @param dato Instancia
+ * @param recoleccion Índices en dato.zonas de las zonas de recolección
+ * @param k Número de grupos
+ * @return void
+ */
+void Descomposicion::barrido(const Tools& dato, const vector<int>& recoleccion, size_t k) {
+  const pair<double, double> deposito = posicion(dato.zonas[dato.indiceDeposito]);
+  vector<pair<double, int>> angulos;
+  angulos.reserve(recoleccion.size());
+  for (int zona : recoleccion) {
+    const pair<double, double> punto = posicion(dato.zonas[zona]);
+    angulos.emplace_back(atan2(punto.second - deposito.second, punto.first - deposito.first), zona);
+  }
+  sort(angulos.begin(), angulos.end());
+  size_t inicio = 0;
+  double hueco = angulos.front().first + 2 * M_PI - angulos.back().first;
+  for (size_t i = 1; i < angulos.size(); i++) {
+    if (angulos[i].first - angulos[i - 1].first > hueco) {
+      hueco = angulos[i].first - angulos[i - 1].first;
+      inicio = i;
+    }
+  }
+  rotate(angulos.begin(), angulos.begin() + inicio, angulos.end());
+  double total = 0.0;
+  for (int zona : recoleccion) total += dato.zonas[zona].getContenido();
+  const bool porContenido = total > 0;
+  if (!porContenido) total = static_cast<double>(recoleccion.size());
+  grupos_.assign(k, {});
+  double acumulado = 0.0;
+  for (const auto& [angulo, zona] : angulos) {
+    const double peso = porContenido ? dato.zonas[zona].getContenido() : 1.0;
+    // Cada zona va al sector en el que cae la mitad de su contenido
+    const size_t g = min(k - 1, static_cast<size_t>((acumulado + peso / 2) / total * k));
+    grupos_[g].push_back(zona);
+    acumulado += peso;
+  }
+}
+
+/**
+ * @brief Método para repartir las zonas por k-medias. Los centros iniciales son las SWTS, elegidas de
+ *        la más alejada de los centros ya elegidos a la que menos, y, si hay menos SWTS que grupos, las
+ *        zonas más alejadas de los centros; así cada grupo tiende a quedar alrededor de una SWTS. Después
+ *        se asigna cada zona a su centro más cercano y se mueve cada centro a la media de sus zonas, hasta
+ *        que ninguna cambia de grupo o se llega a kMaxIteraciones.
+ * @param dato Instancia
+ * @param recoleccion Índices en dato.zonas de las zonas de recolección
+ * @param swts Índices en dato.zonas de las SWTS
+ * @param k Número de grupos
+ * @return void
+ */
+void Descomposicion::kMedias(const Tools& dato, const vector<int>& recoleccion, const vector<int>& swts, size_t k) {
+  const size_t m = recoleccion.size();
+  vector<pair<double, double>> puntos(m);
+  for (size_t i = 0; i < m; i++) puntos[i] = posicion(dato.zonas[recoleccion[i]]);
+  vector<pair<double, double>> centros;
+  vector<double> alCentro(m, INFINITY); // Distancia de cada zona a su centro más cercano
+  auto anadirCentro = [&](const pair<double, double>& centro) {
+    centros.push_back(centro);
+    for (size_t i = 0; i < m; i++) alCentro[i] = min(alCentro[i], distancia(puntos[i], centro));
+  };
+  vector<char> elegida(swts.size(), 0);
+  for (size_t n = 0; n < min(k, swts.size()); n++) {
+    size_t mejor = swts.size();
+    double lejania = -1.0;
+    for (size_t s = 0; s < swts.size(); s++) {
+      if (elegida[s]) continue;
+      double cercano = INFINITY;
+      for (const auto& centro : centros) cercano = min(cercano, distancia(posicion(dato.zonas[swts[s]]), centro));
+      if (cercano > lejania) {
+        lejania = cercano;
+        mejor = s;
+      }
+    }
+    elegida[mejor] = 1;
+    anadirCentro(posicion(dato.zonas[swts[mejor]]));
+  }
+  while (centros.size() < k) {
+    anadirCentro(puntos[max_element(alCentro.begin(), alCentro.end()) - alCentro.begin()]);
+  }
+  vector<size_t> asignacion(m, k);
+  for (int iteracion = 0; iteracion < kMaxIteraciones; iteracion++) {
+    bool cambia = false;
+    for (size_t i = 0; i < m; i++) {
+      size_t cercano = 0;
+      for (size_t c = 1; c < k; c++) {
+        if (distancia(puntos[i], centros[c]) < distancia(puntos[i], centros[cercano])) cercano = c;
+      }
+      if (cercano != asignacion[i]) {
+        asignacion[i] = cercano;
+        cambia = true;
+      }
+    }
+    if (!cambia) break;
+    // Un centro sin zonas se queda donde está
+    vector<pair<double, double>> sumas(k, {0.0, 0.0});
+    vector<size_t> cuenta(k, 0);
+    for (size_t i = 0; i < m; i++) {
+      sumas[asignacion[i]].first += puntos[i].first;
+      sumas[asignacion[i]].second += puntos[i].second;
+      cuenta[asignacion[i]]++;
+    }
+    for (size_t c = 0; c < k; c++) {
+      if (cuenta[c] > 0) centros[c] = {sumas[c].first / cuenta[c], sumas[c].second / cuenta[c]};
+    }
+  }
+  grupos_.assign(k, {});
+  for (size_t i = 0; i < m; i++) grupos_[asignacion[i]].push_back(recoleccion[i]);
+}
+
+/**
+ * @brief Método para repartir por grupos unas rutas que no salen de construir (p.ej. las que cambia el
+ *        reencadenamiento de trayectorias), para mejorarlas con mejorar: cada ruta va al grupo al que
+ *        pertenecen más de sus zonas (el primero si empatan). El orden de las rutas de un grupo se conserva.
+ * @param rutas Rutas que se ordenan por grupo
+ * @param indices Posición de cada zona en Tools::zonas
+ * @return vector<size_t> Posición de la primera ruta de cada grupo, más el número de rutas al final
+ */
+vector<size_t> Descomposicion::agrupar(vector<Recoleccion>& rutas, const unordered_map<string, int>& indices) const {
+  vector<vector<Recoleccion>> porGrupo(grupos_.size());
+  vector<int> cuenta(grupos_.size());
+  for (Recoleccion& ruta : rutas) {
+    fill(cuenta.begin(), cuenta.end(), 0);
+    for (const Zona& zona : ruta.getZonasVisitadas()) {
+      const int g = grupoDe_[indices.at(zona.getId())];
+      if (g >= 0) cuenta[g]++;
+    }
+    porGrupo[max_element(cuenta.begin(), cuenta.end()) - cuenta.begin()].push_back(std::move(ruta));
+  }
+  rutas.clear();
+  vector<size_t> inicios;
+  for (vector<Recoleccion>& grupo : porGrupo) {
+    inicios.push_back(rutas.size());
+    for (Recoleccion& ruta : grupo) rutas.push_back(std::move(ruta));
+  }
+  inicios.push_back(rutas.size());
+  return inicios;
+}
+
+/**
+ * @brief Método para crear la copia de la instancia con la que se construye un grupo: sólo tiene
+ *        pendientes las zonas del grupo. Comparte la matriz de distancias con la instancia y las zonas
+ *        conservan su índice, así que las rutas del grupo valen tal cual para la instancia.
+ * @param dato Instancia
+ * @param g Grupo
+ * @return Tools Copia de la instancia para el grupo
+ */
+Tools Descomposicion::subinstancia(const Tools& dato, size_t g) const {
+  Tools subinstancia = dato;
+  subinstancia.zonasRecoleccion.clear();
+  for (int zona : grupos_[g]) subinstancia.zonasRecoleccion.push_back(dato.zonas[zona]);
+  subinstancia.rutasRecoleccion.clear();
+  subinstancia.rutasTransporte.clear();
+  subinstancia.metricas = Metricas();
+  return subinstancia;
+}
+
+/**
+ * @brief Método para juntar en la instancia las rutas de los grupos, en el orden de los grupos. Las
+ *        zonas de cada grupo quedan con el contenido que les deja su construcción, y cada SWTS con lo que
+ *        le han descargado los vehículos de todos los grupos, como si se hubiera construido de una vez.
+ * @param dato Instancia
+ * @param subinstancias Copia de cada grupo, con sus rutas construidas (se mueven a dato)
+ * @param inicios Se deja la posición de la primera ruta de cada grupo, más el número de rutas al final
+ * @return void
+ */
+void Descomposicion::fusionar(Tools& dato, vector<Tools>& subinstancias, vector<size_t>& inicios) const {
+  vector<int> swts;
+  for (size_t i = 0; i < dato.zonas.size(); i++) {
+    if (dato.zonas[i].esSWTS()) swts.push_back(i);
+  }
+  vector<double> contenidoInicial(swts.size());
+  for (size_t s = 0; s < swts.size(); s++) contenidoInicial[s] = dato.zonas[swts[s]].getContenido();
+  dato.rutasRecoleccion.clear();
+  inicios.clear();
+  for (size_t g = 0; g < grupos_.size(); g++) {
+    Tools& subinstancia = subinstancias[g];
+    inicios.push_back(dato.rutasRecoleccion.size());
+    for (Recoleccion& ruta : subinstancia.rutasRecoleccion) dato.rutasRecoleccion.push_back(std::move(ruta));
+    for (int zona : grupos_[g]) dato.zonas[zona].setContenido(subinstancia.zonas[zona].getContenido());
+    for (size_t s = 0; s < swts.size(); s++) {
+      Zona& estacion = dato.zonas[swts[s]];
+      estacion.setContenido(estacion.getContenido() + subinstancia.zonas[swts[s]].getContenido() - contenidoInicial[s]);
+    }
+    dato.metricas.acumular(subinstancia.metricas);
+  }
+  inicios.push_back(dato.rutasRecoleccion.size());
+  dato.zonasRecoleccion.clear(); // Todas las zonas de recolección han quedado visitadas
+}
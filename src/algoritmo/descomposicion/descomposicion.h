@@ -0,0 +1,95 @@
+/**
+ * @class Descomposición de una instancia en grupos de zonas de recolección (cluster first, route second).
+ *        Reparte las zonas en grupos, por sectores de ángulo alrededor del depósito (barrido) o por
+ *        k-medias con los centros iniciales en las SWTS, para que cada grupo quede alrededor de una. Cada
+ *        grupo se construye por separado sobre una copia de la instancia que sólo tiene pendientes sus
+ *        zonas (las SWTS, el depósito y la matriz de distancias son los de la instancia), y las rutas se
+ *        juntan después, antes de la fase de transporte. Los grupos se reparten entre hilos y el
+ *        resultado no depende de cuántos haya.
+ */
+
+#ifndef C_Descomposicion_H
+#define C_Descomposicion_H
+
+#include "../../tools/tools.h"
+#include "../../tools/paralelo/paralelo.h"
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Descomposicion {
+  public:
+    static constexpr int kMaxIteraciones = 100; // Iteraciones como mucho de k-medias
+
+    Descomposicion(const Tools& dato, const ConfiguracionDescomposicion& configuracion);
+
+    inline size_t numeroGrupos() const { return grupos_.size(); }
+    inline const std::vector<int>& grupo(size_t g) const { return grupos_[g]; } // Índices en Tools::zonas
+
+    template<typename Construir>
+    std::vector<size_t> construir(Tools& dato, int hilos, Construir&& construirGrupo) const;
+    // Ordena unas rutas por el grupo de la mayoría de sus zonas y devuelve sus inicios (ver construir)
+    std::vector<size_t> agrupar(std::vector<Recoleccion>& rutas, const std::unordered_map<std::string, int>& indices) const;
+    template<typename Mejorar>
+    static void mejorar(std::vector<Recoleccion>& rutas, const std::vector<size_t>& inicios, int hilos, Mejorar&& mejorarGrupo);
+
+  private:
+    void barrido(const Tools& dato, const std::vector<int>& recoleccion, size_t k);
+    void kMedias(const Tools& dato, const std::vector<int>& recoleccion, const std::vector<int>& swts, size_t k);
+    Tools subinstancia(const Tools& dato, size_t g) const;
+    void fusionar(Tools& dato, std::vector<Tools>& subinstancias, std::vector<size_t>& inicios) const;
+
+    std::vector<std::vector<int>> grupos_; // Zonas de cada grupo (ninguno vacío)
+    std::vector<int> grupoDe_; // Grupo de cada zona, por índice en Tools::zonas (-1 si no es de recolección)
+};
+
+/**
+ * @brief Método para construir las rutas de recolección de la instancia grupo a grupo, en paralelo:
+ *        construirGrupo(subinstancia, g) deja en subinstancia.rutasRecoleccion las rutas del grupo g, y
+ *        al terminar se juntan en dato.rutasRecoleccion en el orden de los grupos
+ * @param dato Instancia (sin rutas de recolección)
+ * @param hilos Hilos entre los que se reparten los grupos (0 = los que tenga la máquina)
+ * @param construirGrupo Construcción de un grupo
+ * @return vector<size_t> Posición en dato.rutasRecoleccion de la primera ruta de cada grupo, más el
+ *         número de rutas al final, para mejorar cada grupo por separado
+ */
+template<typename Construir>
+std::vector<size_t> Descomposicion::construir(Tools& dato, int hilos, Construir&& construirGrupo) const {
+  std::vector<Tools> subinstancias(grupos_.size());
+  paraleloPara(grupos_.size(), hilos, [&](size_t g) {
+    subinstancias[g] = subinstancia(dato, g);
+    construirGrupo(subinstancias[g], g);
+  });
+  std::vector<size_t> inicios;
+  fusionar(dato, subinstancias, inicios);
+  return inicios;
+}
+
+/**
+ * @brief Método para mejorar por separado, en paralelo, las rutas de cada grupo: mejorarGrupo(rutas, g)
+ *        recibe una copia de las rutas del grupo g y la deja mejorada. Las rutas originales sólo se leen
+ *        desde los otros hilos y se sustituyen en el hilo llamador, porque pueden estar en su arena.
+ * @param rutas Rutas de todos los grupos, seguidas
+ * @param inicios Posición de la primera ruta de cada grupo, más el número de rutas al final (ver construir)
+ * @param hilos Hilos entre los que se reparten los grupos (0 = los que tenga la máquina)
+ * @param mejorarGrupo Mejora de las rutas de un grupo
+ * @return void
+ */
+template<typename Mejorar>
+void Descomposicion::mejorar(std::vector<Recoleccion>& rutas, const std::vector<size_t>& inicios, int hilos, Mejorar&& mejorarGrupo) {
+  const size_t grupos = inicios.empty() ? 0 : inicios.size() - 1;
+  std::vector<std::vector<Recoleccion>> mejoradas(grupos);
+  paraleloPara(grupos, hilos, [&](size_t g) {
+    mejoradas[g].reserve(inicios[g + 1] - inicios[g]);
+    for (size_t r = inicios[g]; r < inicios[g + 1]; r++) mejoradas[g].emplace_back(rutas[r], std::pmr::new_delete_resource());
+    mejorarGrupo(mejoradas[g], g);
+  });
+  rutas.clear();
+  for (std::vector<Recoleccion>& grupo : mejoradas) {
+    for (Recoleccion& ruta : grupo) rutas.push_back(std::move(ruta));
+  }
+}
+
+#endif
@@ -1,4 +1,14 @@
 #include "busqueda_local.h"
+#include "../../../tools/traza/traza.h"
+#include "../../../tools/memoria/memoria.h"
+#include "../../../tools/paralelo/paralelo.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 
 using namespace std;
 
@@ -7,17 +17,45 @@ using namespace std;
  * @return true si se ha mejorado alguna ruta, false en caso contrario
  */
 void BusquedaLocal::mejorarRutas() {
+  AmbitoMemoria memoria(FaseMemoria::busquedaLocal);
   bool mejorado = true;
+  int pasadas = 0;
   while (mejorado) {
     mejorado = false;
-    mejorado |= swapInter();
-    mejorado |= swapIntra();
-    mejorado |= reinsertIntra();
-    mejorado |= reinsertInter();
-    mejorado |= twoOptIntra();
+    pasadas++;
+    mejorado |= aplicarOperador(Operador::swapInter, &BusquedaLocal::swapInter);
+    if (maxTramo_ > 0) mejorado |= aplicarOperador(Operador::tramosExactos, &BusquedaLocal::tramosExactos);
+    mejorado |= aplicarOperador(Operador::swapIntra, &BusquedaLocal::swapIntra);
+    mejorado |= aplicarOperador(Operador::reinsertIntra, &BusquedaLocal::reinsertIntra);
+    mejorado |= aplicarOperador(Operador::reinsertInter, &BusquedaLocal::reinsertInter);
+    mejorado |= aplicarOperador(Operador::twoOptIntra, &BusquedaLocal::twoOptIntra);
+  }
+  if (metricas_ != nullptr) metricas_->pasadas.push_back(pasadas);
+  // Las rutas finales son un óptimo local de los operadores intra-ruta: se guardan para otras ejecuciones
+  if (memo_ != nullptr) {
+    for (const Recoleccion& ruta : *vehiculos_) {
+      memo_->paradas(ruta, paradasMemo_);
+      memo_->guardar(paradasMemo_, calcularCostoRuta(ruta, metricas_));
+    }
   }
 }
 
+/**
+ * @brief Método para aplicar un operador acumulando en las métricas el tiempo que pasa en él
+ * @param operador Operador que se aplica
+ * @param metodo Método que lo implementa
+ * @return true si el operador ha mejorado alguna ruta, false en caso contrario
+ */
+bool BusquedaLocal::aplicarOperador(Operador operador, bool (BusquedaLocal::*metodo)()) {
+  IntervaloTraza intervalo(nombreOperador(operador), "operador");
+  if constexpr (!kInstrumentacion) return (this->*metodo)();
+  if (metricas_ == nullptr) return (this->*metodo)();
+  const auto inicio = chrono::steady_clock::now();
+  const bool mejorado = (this->*metodo)();
+  metricas_->operador(operador).tiempo += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+  return mejorado;
+}
+
 /**
  * @brief Método para realizar la búsqueda local por intercambio de zonas
  * @return true si se ha mejorado alguna ruta, false en caso contrario
@@ -25,14 +63,22 @@ void BusquedaLocal::mejorarRutas() {
 bool BusquedaLocal::twoOptIntra() {
   bool mejorado = false;
   for (size_t i = 0; i < vehiculos_->size(); ++i) {
+    if (memo_ != nullptr && resueltaPorMemo(i, mejorado)) continue;
     Recoleccion& ruta = (*vehiculos_)[i];
-    vector<Zona>& zonas = ruta.getZonasVisitadas();
+    pmr::vector<Zona>& zonas = ruta.getZonasVisitadas();
+    tramosResueltos(i, tramosRuta_);
     for (size_t j = 1; j < zonas.size() - 2; ++j) {
       for (size_t k = j + 1; k < zonas.size() - 1; ++k) {
+        if (mismoTramo(tramosRuta_, j, k)) continue; // Invertir dentro de un tramo resuelto no mejora
         Recoleccion copia = ruta;
         reverse(copia.getZonasVisitadas().begin() + j, copia.getZonasVisitadas().begin() + k + 1);
-        if (esFactible(copia) && calcularCostoRuta(copia) < calcularCostoRuta(ruta)) {
+        contar(Operador::twoOptIntra, Suceso::evaluado);
+        if (!esFactible(copia, metricas_)) continue;
+        contar(Operador::twoOptIntra, Suceso::factible);
+        if (calcularCostoRuta(copia, metricas_) < calcularCostoRuta(ruta, metricas_)) {
           (*vehiculos_)[i] = copia;
+          tramosRuta_.clear();
+          contar(Operador::twoOptIntra, Suceso::aceptado);
           mejorado = true;
         }
       }
@@ -46,13 +92,17 @@ bool BusquedaLocal::twoOptIntra() {
  * @return true si se ha mejorado alguna ruta, false en caso contrario
  */
 bool BusquedaLocal::swapInter() {
+  if (paralelo_) return swapInterParalelo();
   bool mejorado = false;
+  actualizarIndices();
   // Recorremos los vehículos
   for (size_t i = 0; i < vehiculos_->size(); i++) {
     for (size_t j = i + 1; j < vehiculos_->size(); j++) {
       // Obtengo las zonas de los vehículos
       Recoleccion& ruta1 = (*vehiculos_)[i];
       Recoleccion& ruta2 = (*vehiculos_)[j];
+      const vector<int>& indices1 = indices_[i];
+      const vector<int>& indices2 = indices_[j];
 
       // Para cada zona en la primera ruta
       for (size_t k = 1; k < ruta1.getZonasVisitadas().size() - 1; k++) {
@@ -60,20 +110,27 @@ bool BusquedaLocal::swapInter() {
           // Para cada zona en la segunda ruta
           for (size_t l = 1; l < ruta2.getZonasVisitadas().size() - 1; l++) {
             if (!ruta2.getZonasVisitadas()[l].esSWTS() && !ruta2.getZonasVisitadas()[l].esDeposito()) {
+              // Granular: alguna de las dos zonas tiene que quedar junto a una de sus vecinas
+              if (grafo_ != nullptr && !junto(indices1[k], indices2[l - 1], indices2[l + 1]) &&
+                  !junto(indices2[l], indices1[k - 1], indices1[k + 1])) continue;
               Recoleccion ruta1Copia = ruta1;
               Recoleccion ruta2Copia = ruta2;
               // Intercambio las zonas
               swap(ruta1Copia.getZonasVisitadas()[k], ruta2Copia.getZonasVisitadas()[l]);
 
+              contar(Operador::swapInter, Suceso::evaluado);
               // Verifico que las rutas sean factibles
-              if (esFactible(ruta1Copia) && esFactible(ruta2Copia)) {
+              if (esFactible(ruta1Copia, metricas_) && esFactible(ruta2Copia, metricas_)) {
+                contar(Operador::swapInter, Suceso::factible);
                 // Calculo el costo total
-                double costoNuevo = calcularCostoRuta(ruta1Copia) + calcularCostoRuta(ruta2Copia);
-                double costoAntiguo = calcularCostoRuta(ruta1) + calcularCostoRuta(ruta2);
+                double costoNuevo = calcularCostoRuta(ruta1Copia, metricas_) + calcularCostoRuta(ruta2Copia, metricas_);
+                double costoAntiguo = calcularCostoRuta(ruta1, metricas_) + calcularCostoRuta(ruta2, metricas_);
                 if (costoNuevo < costoAntiguo) {
                   // Si el costo nuevo es menor, actualizo las rutas
                   (*vehiculos_)[i] = ruta1Copia;
                   (*vehiculos_)[j] = ruta2Copia;
+                  if (grafo_ != nullptr) swap(indices_[i][k], indices_[j][l]);
+                  contar(Operador::swapInter, Suceso::aceptado);
                   mejorado = true;
                 }
               }
@@ -92,20 +149,29 @@ bool BusquedaLocal::swapInter() {
  */
 bool BusquedaLocal::swapIntra() {
   bool mejorado = false;
+  if (memo_ != nullptr) consultasMemo_.assign(vehiculos_->size(), ConsultaMemo()); // Primer operador intra-ruta de la pasada
   for (size_t i = 0; i < vehiculos_->size(); ++i) {
+    if (memo_ != nullptr && resueltaPorMemo(i, mejorado)) continue;
     Recoleccion& ruta = (*vehiculos_)[i];
     // Recorremos las zonas de la ruta
-    vector<Zona>& zonas = ruta.getZonasVisitadas();
+    pmr::vector<Zona>& zonas = ruta.getZonasVisitadas();
+    tramosResueltos(i, tramosRuta_);
     for (size_t j = 1; j < zonas.size() - 1; ++j) {
       if (zonas[j].esSWTS() || zonas[j].esDeposito()) continue; // Ignoramos SWTS y depósitos
       for (size_t k = j + 1; k < zonas.size() - 1; ++k) {
         if (zonas[k].esSWTS() || zonas[k].esDeposito()) continue; // Ignoramos SWTS y depósitos
+        if (mismoTramo(tramosRuta_, j, k)) continue; // Ya están en el orden óptimo de su tramo
         // Intercambiamos las zonas
         Recoleccion copia = ruta;
         swap(copia.getZonasVisitadas()[j], copia.getZonasVisitadas()[k]);
-        if (esFactible(copia) && calcularCostoRuta(copia) < calcularCostoRuta(ruta)) {
+        contar(Operador::swapIntra, Suceso::evaluado);
+        if (!esFactible(copia, metricas_)) continue;
+        contar(Operador::swapIntra, Suceso::factible);
+        if (calcularCostoRuta(copia, metricas_) < calcularCostoRuta(ruta, metricas_)) {
           // Si la ruta es factible y el costo es menor, actualizamos la ruta
           (*vehiculos_)[i] = copia;
+          tramosRuta_.clear();
+          contar(Operador::swapIntra, Suceso::aceptado);
           mejorado = true;
         }
       }
@@ -115,28 +181,50 @@ bool BusquedaLocal::swapIntra() {
 }
 
 /**
- * @brief Implementación del método reinsertIntra
+ * @brief Implementación del método reinsertIntra. Las posiciones a las que se puede mover cada zona se
+ *        evalúan todas a la vez (EvaluadorInsercion) y sólo las que mejoran según el kernel se
+ *        comprueban con la copia completa de la ruta, que es la que decide como antes.
  * @return true si se ha mejorado alguna ruta, false en caso contrario
  */
 bool BusquedaLocal::reinsertIntra() {
   bool mejorado = false;
+  EvaluadorInsercion& evaluador = insercion_;
   for (size_t i = 0; i < vehiculos_->size(); ++i) {
+    if (memo_ != nullptr && resueltaPorMemo(i, mejorado)) continue;
     Recoleccion& ruta = (*vehiculos_)[i];
-    vector<Zona>& zonas = ruta.getZonasVisitadas();
+    pmr::vector<Zona>& zonas = ruta.getZonasVisitadas();
+    tramosResueltos(i, tramosRuta_);
     for (size_t j = 1; j < zonas.size() - 1; ++j) {
       if (zonas[j].esSWTS() || zonas[j].esDeposito()) continue; // Ignoramos SWTS y depósitos
+      bool evaluar = true; // Hay que volver a evaluar cuando cambia la ruta
+      double costoRuta = 0.0;
       // Probar todas las opciones disponibles
       for (size_t k = 1; k < zonas.size() - 1; ++k) {
         if (j == k) continue; // No intercambiar la misma zona
+        if (mismoTramo(tramosRuta_, j, k)) continue; // Moverla dentro de su tramo resuelto no mejora
+        if (evaluar) {
+          evaluador.cargar(ruta, j);
+          evaluador.evaluar(zonas[j]);
+          costoRuta = calcularCostoRuta(ruta, metricas_);
+          evaluar = false;
+        }
+        contar(Operador::reinsertIntra, Suceso::evaluado);
+        if (!evaluador.factible(k)) continue;
+        contar(Operador::reinsertIntra, Suceso::factible);
+        if (!(evaluador.coste() + evaluador.delta(k) < costoRuta + kToleranciaInsercion)) continue;
         Recoleccion copia = ruta;
         Zona zona = copia.getZonasVisitadas()[j];
         // Mover la zona a la posición k
         copia.getZonasVisitadas().erase(copia.getZonasVisitadas().begin() + j);
         copia.getZonasVisitadas().insert(copia.getZonasVisitadas().begin() + k, zona);
-        if (esFactible(copia) && calcularCostoRuta(copia) < calcularCostoRuta(ruta)) {
+        if (!esFactible(copia, metricas_)) continue;
+        if (calcularCostoRuta(copia, metricas_) < costoRuta) {
           // Si la ruta es factible y el costo es menor, actualizamos la ruta
           (*vehiculos_)[i] = copia;
+          tramosRuta_.clear();
+          contar(Operador::reinsertIntra, Suceso::aceptado);
           mejorado = true;
+          evaluar = true;
         }
       }
     }
@@ -145,56 +233,389 @@ bool BusquedaLocal::reinsertIntra() {
 }
 
 /**
- * @brief Implementación del método reinsertInter
+ * @brief Implementación del método reinsertInter. Como en reinsertIntra, las posiciones de la ruta
+ *        destino se evalúan todas a la vez y sólo las que mejoran se comprueban con las copias.
  * @return true si se ha mejorado alguna ruta, false en caso contrario
  */
 bool BusquedaLocal::reinsertInter() {
+  if (paralelo_) return reinsertInterParalelo();
   bool mejorado = false;
+  actualizarIndices();
+  EvaluadorInsercion& evaluador = insercion_;
   for (size_t i = 0; i < vehiculos_->size(); ++i) {
     for (size_t j = 0; j < vehiculos_->size(); ++j) {
       if (i == j) continue; // No intercambiar la misma ruta
       Recoleccion& rutaOrigen = (*vehiculos_)[i];
       Recoleccion& rutaDestino = (*vehiculos_)[j];
-      vector<Zona>& zonasOrigen = rutaOrigen.getZonasVisitadas();
+      pmr::vector<Zona>& zonasOrigen = rutaOrigen.getZonasVisitadas();
+      bool cargarDestino = true; // Hay que volver a cargar el destino cuando cambia
 
       for (size_t k = 1; k < zonasOrigen.size() - 1; ++k) {
         if (zonasOrigen[k].esSWTS() || zonasOrigen[k].esDeposito()) continue; // Ignoramos SWTS y depósitos
+        const int zona = grafo_ != nullptr ? indices_[i][k] : -1;
+        if (grafo_ != nullptr && !tieneVecinaEn(zona, indices_[j])) continue; // Granular: ninguna posición sirve
+        if (cargarDestino) {
+          evaluador.cargar(rutaDestino);
+          cargarDestino = false;
+        }
+        // La ruta origen sin la zona es la misma para todas las posiciones de destino
+        Recoleccion copiaOrigen = rutaOrigen;
+        copiaOrigen.getZonasVisitadas().erase(copiaOrigen.getZonasVisitadas().begin() + k);
+        const bool origenFactible = esFactible(copiaOrigen, metricas_);
+        evaluador.evaluar(zonasOrigen[k]);
+        const double costoAntiguo = calcularCostoRuta(rutaOrigen, metricas_) + calcularCostoRuta(rutaDestino, metricas_);
+        const double costoOrigen = calcularCostoRuta(copiaOrigen, metricas_);
         // Probar insertar en todas las posiciones de la ruta destino
         for (size_t l = 1; l < rutaDestino.getZonasVisitadas().size() - 1; ++l) {
-          Recoleccion copiaOrigen = rutaOrigen;
+          if (grafo_ != nullptr && !junto(zona, indices_[j][l - 1], indices_[j][l])) continue; // Granular
+          contar(Operador::reinsertInter, Suceso::evaluado);
+          if (!origenFactible || !evaluador.factible(l)) continue;
+          contar(Operador::reinsertInter, Suceso::factible);
+          if (!(costoOrigen + evaluador.coste() + evaluador.delta(l) < costoAntiguo + kToleranciaInsercion)) continue;
           Recoleccion copiaDestino = rutaDestino;
-          Zona zona = copiaOrigen.getZonasVisitadas()[k];
-          // Mover la zona a la ruta destino
-          copiaOrigen.getZonasVisitadas().erase(copiaOrigen.getZonasVisitadas().begin() + k);
-          copiaDestino.getZonasVisitadas().insert(copiaDestino.getZonasVisitadas().begin() + l, zona);
-          if (esFactible(copiaOrigen) && esFactible(copiaDestino)) {
-            double costoAntiguo = calcularCostoRuta(rutaOrigen) + calcularCostoRuta(rutaDestino);
-            double costoNuevo = calcularCostoRuta(copiaOrigen) + calcularCostoRuta(copiaDestino);
-
-            if (costoNuevo < costoAntiguo) {
-              // Si la ruta es factible y el costo es menor, actualizamos las rutas
-              (*vehiculos_)[i] = copiaOrigen;
-              (*vehiculos_)[j] = copiaDestino;
+          copiaDestino.getZonasVisitadas().insert(copiaDestino.getZonasVisitadas().begin() + l, zonasOrigen[k]);
+          if (!esFactible(copiaDestino, metricas_)) continue;
+          if (costoOrigen + calcularCostoRuta(copiaDestino, metricas_) < costoAntiguo) {
+            // Si la ruta es factible y el costo es menor, actualizamos las rutas
+            (*vehiculos_)[i] = copiaOrigen;
+            (*vehiculos_)[j] = copiaDestino;
+            if (grafo_ != nullptr) {
+              indices_[j].insert(indices_[j].begin() + l, zona);
+              indices_[i].erase(indices_[i].begin() + k);
+            }
+            contar(Operador::reinsertInter, Suceso::aceptado);
+            mejorado = true;
+            cargarDestino = true;
+            break;
+          }
+        }
+      }
+    }
+  }
+  return mejorado;
+}
+
+/**
+ * @brief Método para evaluar en paralelo el mejor movimiento de cada par de rutas. Cada hilo tiene un
+ *        trabajador (una búsqueda local vacía con sus propias métricas, que se suman al terminar) con el
+ *        que evalúa los pares que va cogiendo; las rutas y los índices se leen de esta búsqueda local,
+ *        que no cambia mientras tanto, así que los hilos no comparten nada que escriban.
+ * @param pares Pares de rutas (i, j) a evaluar
+ * @param evaluar Función (trabajador, i, j) que devuelve el mejor movimiento del par, con ganancia 0 si no hay ninguno que mejore
+ * @return vector<Movimiento> Mejor movimiento de cada par, en el orden de "pares"
+ */
+template<typename Evaluar>
+vector<BusquedaLocal::Movimiento> BusquedaLocal::mejoresMovimientos(const vector<pair<size_t, size_t>>& pares, Evaluar&& evaluar) {
+  vector<Movimiento> movimientos(pares.size());
+  const size_t numeroHilos = min<size_t>(hilosEfectivos(hilos_), pares.size());
+  const bool conMetricas = kInstrumentacion && metricas_ != nullptr;
+  vector<Metricas> metricasHilos(conMetricas ? numeroHilos : 0);
+  atomic<size_t> siguiente{0};
+  paraleloPara(numeroHilos, numeroHilos, [&](size_t h) {
+    AmbitoMemoria memoria(FaseMemoria::busquedaLocal);
+    BusquedaLocal trabajador;
+    trabajador.metricas_ = conMetricas ? &metricasHilos[h] : nullptr;
+    for (size_t p = siguiente++; p < pares.size(); p = siguiente++) movimientos[p] = evaluar(trabajador, pares[p].first, pares[p].second);
+  });
+  for (const auto& metricas : metricasHilos) metricas_->acumular(metricas);
+  return movimientos;
+}
+
+/**
+ * @brief Método para escoger qué movimientos de mejora se aplican juntos: del que más ahorra al que
+ *        menos, cada uno siempre que no toque una ruta ya modificada por otro (así la ganancia evaluada
+ *        sigue siendo válida). A igual ganancia decide (i, j, k, l), por lo que el resultado no depende
+ *        del número de hilos ni del orden en que terminen.
+ * @param movimientos Mejor movimiento de cada par de rutas
+ * @return vector<Movimiento> Movimientos compatibles entre sí, en el orden en que se aplican
+ */
+vector<BusquedaLocal::Movimiento> BusquedaLocal::movimientosCompatibles(vector<Movimiento> movimientos) const {
+  erase_if(movimientos, [](const Movimiento& movimiento) { return !(movimiento.ganancia > 0.0); });
+  sort(movimientos.begin(), movimientos.end(), [](const Movimiento& a, const Movimiento& b) {
+    if (a.ganancia != b.ganancia) return a.ganancia > b.ganancia;
+    return tie(a.i, a.j, a.k, a.l) < tie(b.i, b.j, b.k, b.l);
+  });
+  vector<bool> rutaUsada(vehiculos_->size(), false);
+  vector<Movimiento> compatibles;
+  for (const auto& movimiento : movimientos) {
+    if (rutaUsada[movimiento.i] || rutaUsada[movimiento.j]) continue;
+    rutaUsada[movimiento.i] = rutaUsada[movimiento.j] = true;
+    compatibles.push_back(movimiento);
+  }
+  return compatibles;
+}
+
+/**
+ * @brief Versión paralela de swapInter: evalúa a la vez todos los pares de rutas sobre la solución
+ *        actual, se queda con el mejor intercambio de cada par y aplica los que no comparten rutas
+ * @return true si se ha mejorado alguna ruta, false en caso contrario
+ */
+bool BusquedaLocal::swapInterParalelo() {
+  actualizarIndices();
+  vector<pair<size_t, size_t>> pares;
+  for (size_t i = 0; i < vehiculos_->size(); i++) {
+    for (size_t j = i + 1; j < vehiculos_->size(); j++) pares.emplace_back(i, j);
+  }
+  const vector<Movimiento> movimientos = movimientosCompatibles(mejoresMovimientos(pares, [this](BusquedaLocal& trabajador, size_t i, size_t j) {
+    const Recoleccion& ruta1 = (*vehiculos_)[i];
+    const Recoleccion& ruta2 = (*vehiculos_)[j];
+    const double costoAntiguo = calcularCostoRuta(ruta1, trabajador.metricas_) + calcularCostoRuta(ruta2, trabajador.metricas_);
+    // Se intercambia sobre una única copia de cada ruta y se deshace después de evaluar
+    Recoleccion ruta1Copia = ruta1;
+    Recoleccion ruta2Copia = ruta2;
+    pmr::vector<Zona>& zonas1 = ruta1Copia.getZonasVisitadas();
+    pmr::vector<Zona>& zonas2 = ruta2Copia.getZonasVisitadas();
+    const vector<int>& indices1 = indices_[i];
+    const vector<int>& indices2 = indices_[j];
+    Movimiento mejor{0.0, i, j, 0, 0};
+    for (size_t k = 1; k < zonas1.size() - 1; k++) {
+      if (zonas1[k].esSWTS() || zonas1[k].esDeposito()) continue;
+      for (size_t l = 1; l < zonas2.size() - 1; l++) {
+        if (zonas2[l].esSWTS() || zonas2[l].esDeposito()) continue;
+        if (grafo_ != nullptr && !junto(indices1[k], indices2[l - 1], indices2[l + 1]) &&
+            !junto(indices2[l], indices1[k - 1], indices1[k + 1])) continue; // Granular
+        swap(zonas1[k], zonas2[l]);
+        trabajador.contar(Operador::swapInter, Suceso::evaluado);
+        if (esFactible(ruta1Copia, trabajador.metricas_) && esFactible(ruta2Copia, trabajador.metricas_)) {
+          trabajador.contar(Operador::swapInter, Suceso::factible);
+          const double ganancia = costoAntiguo - (calcularCostoRuta(ruta1Copia, trabajador.metricas_) + calcularCostoRuta(ruta2Copia, trabajador.metricas_));
+          if (ganancia > mejor.ganancia) mejor = Movimiento{ganancia, i, j, k, l};
+        }
+        swap(zonas1[k], zonas2[l]);
+      }
+    }
+    return mejor;
+  }));
+  for (const auto& movimiento : movimientos) {
+    swap((*vehiculos_)[movimiento.i].getZonasVisitadas()[movimiento.k], (*vehiculos_)[movimiento.j].getZonasVisitadas()[movimiento.l]);
+    contar(Operador::swapInter, Suceso::aceptado);
+  }
+  return !movimientos.empty();
+}
+
+/**
+ * @brief Versión paralela de reinsertInter: evalúa a la vez todos los pares (origen, destino) sobre la
+ *        solución actual, se queda con la mejor reinserción de cada par y aplica las que no comparten rutas
+ * @return true si se ha mejorado alguna ruta, false en caso contrario
+ */
+bool BusquedaLocal::reinsertInterParalelo() {
+  actualizarIndices();
+  vector<pair<size_t, size_t>> pares;
+  for (size_t i = 0; i < vehiculos_->size(); i++) {
+    for (size_t j = 0; j < vehiculos_->size(); j++) {
+      if (i != j) pares.emplace_back(i, j);
+    }
+  }
+  const vector<Movimiento> movimientos = movimientosCompatibles(mejoresMovimientos(pares, [this](BusquedaLocal& trabajador, size_t i, size_t j) {
+    const Recoleccion& rutaOrigen = (*vehiculos_)[i];
+    const Recoleccion& rutaDestino = (*vehiculos_)[j];
+    const pmr::vector<Zona>& zonasOrigen = rutaOrigen.getZonasVisitadas();
+    const double costoAntiguo = calcularCostoRuta(rutaOrigen, trabajador.metricas_) + calcularCostoRuta(rutaDestino, trabajador.metricas_);
+    EvaluadorInsercion& evaluador = trabajador.insercion_; // Se reutiliza entre los pares del mismo hilo
+    evaluador.cargar(rutaDestino);
+    const vector<int>& indicesDestino = indices_[j];
+    Movimiento mejor{0.0, i, j, 0, 0};
+    for (size_t k = 1; k < zonasOrigen.size() - 1; k++) {
+      if (zonasOrigen[k].esSWTS() || zonasOrigen[k].esDeposito()) continue;
+      const int zona = grafo_ != nullptr ? indices_[i][k] : -1;
+      if (grafo_ != nullptr && !tieneVecinaEn(zona, indicesDestino)) continue;
+      Recoleccion copiaOrigen = rutaOrigen;
+      copiaOrigen.getZonasVisitadas().erase(copiaOrigen.getZonasVisitadas().begin() + k);
+      // La ruta origen sin la zona es la misma para todas las posiciones de destino
+      const bool origenFactible = esFactible(copiaOrigen, trabajador.metricas_);
+      const double costoOrigen = origenFactible ? calcularCostoRuta(copiaOrigen, trabajador.metricas_) : 0.0;
+      evaluador.evaluar(zonasOrigen[k]);
+      for (size_t l = 1; l < evaluador.tamano() - 1; l++) {
+        if (grafo_ != nullptr && !junto(zona, indicesDestino[l - 1], indicesDestino[l])) continue; // Granular
+        trabajador.contar(Operador::reinsertInter, Suceso::evaluado);
+        if (!origenFactible || !evaluador.factible(l)) continue;
+        trabajador.contar(Operador::reinsertInter, Suceso::factible);
+        const double ganancia = costoAntiguo - (costoOrigen + evaluador.coste() + evaluador.delta(l));
+        if (ganancia > kToleranciaInsercion && ganancia > mejor.ganancia) mejor = Movimiento{ganancia, i, j, k, l};
+      }
+    }
+    return mejor;
+  }));
+  for (const auto& movimiento : movimientos) {
+    pmr::vector<Zona>& zonasOrigen = (*vehiculos_)[movimiento.i].getZonasVisitadas();
+    pmr::vector<Zona>& zonasDestino = (*vehiculos_)[movimiento.j].getZonasVisitadas();
+    zonasDestino.insert(zonasDestino.begin() + movimiento.l, zonasOrigen[movimiento.k]);
+    zonasOrigen.erase(zonasOrigen.begin() + movimiento.k);
+    contar(Operador::reinsertInter, Suceso::aceptado);
+  }
+  return !movimientos.empty();
+}
+
+/**
+ * @brief Método para obtener el índice en Tools::zonas de cada parada de cada ruta, para los vecindarios
+ *        granulares (así no se buscan las zonas por identificador al evaluar). Sin grafo no hace nada.
+ * @return void
+ */
+void BusquedaLocal::actualizarIndices() {
+  if (grafo_ == nullptr) return;
+  indices_.resize(vehiculos_->size());
+  for (size_t i = 0; i < vehiculos_->size(); i++) {
+    indices_[i].clear();
+    for (const Zona& zona : (*vehiculos_)[i].getZonasVisitadas()) indices_[i].push_back(grafo_->indice(zona));
+  }
+}
+
+/**
+ * @brief Método para consultar la memoria de rutas antes de aplicar un operador intra-ruta. Si la ruta
+ *        ya está en el orden guardado para sus paradas, el operador no necesita evaluarla: ese orden es un
+ *        óptimo local de los operadores intra-ruta. Si el orden guardado es más corto, la ruta pasa a él y
+ *        tampoco se evalúa; si no (otro orden igual de largo o más), se evalúa como siempre. La respuesta se
+ *        recuerda hasta la siguiente pasada, mientras la ruta siga con las mismas paradas en el mismo
+ *        orden, para no volver a consultar la memoria en cada operador.
+ * @param i Índice de la ruta
+ * @param mejorado Se pone a true si la ruta se sustituye por el orden guardado
+ * @return true si el operador puede saltarse la ruta, false en caso contrario
+ */
+bool BusquedaLocal::resueltaPorMemo(size_t i, bool& mejorado) {
+  Recoleccion& ruta = (*vehiculos_)[i];
+  memo_->paradas(ruta, paradasMemo_);
+  ConsultaMemo sinRecordar;
+  ConsultaMemo& consulta = i < consultasMemo_.size() ? consultasMemo_[i] : sinRecordar;
+  if (consulta.paradas == paradasMemo_) return consulta.resuelta;
+  consulta = ConsultaMemo{paradasMemo_, false};
+  double coste = 0.0;
+  const bool guardada = memo_->consultar(paradasMemo_, ordenMemo_, coste);
+  if (metricas_ != nullptr) (guardada ? metricas_->memo.aciertos : metricas_->memo.fallos)++;
+  if (!guardada) return false;
+  if (ordenMemo_ != paradasMemo_) {
+    if (!(coste < calcularCostoRuta(ruta, metricas_))) return false; // El orden guardado no es mejor: se evalúa como siempre
+    // Cada índice del orden guardado se busca entre las paradas de la ruta, que son las mismas
+    vector<pair<int32_t, size_t>> posiciones;
+    posiciones.reserve(paradasMemo_.size());
+    for (size_t p = 0; p < paradasMemo_.size(); p++) posiciones.emplace_back(paradasMemo_[p], p);
+    sort(posiciones.begin(), posiciones.end());
+    Recoleccion copia = ruta;
+    for (size_t p = 0; p < ordenMemo_.size(); p++) {
+      const auto posicion = lower_bound(posiciones.begin(), posiciones.end(), make_pair(ordenMemo_[p], size_t{0}));
+      copia.getZonasVisitadas()[p] = ruta.getZonasVisitadas()[posicion->second];
+    }
+    ruta = copia;
+    mejorado = true;
+  }
+  consulta = ConsultaMemo{ordenMemo_, true};
+  return true;
+}
+
+/**
+ * @brief Método para activar la ordenación exacta de los tramos
+ * @param maxZonas Zonas máximas de los tramos que se ordenan (0 = no se aplica)
+ * @return void
+ * @throws std::invalid_argument si maxZonas es negativo o mayor que SecuenciadorExacto::kMaxZonas
+ */
+void BusquedaLocal::setTramosExactos(int maxZonas) {
+  if (maxZonas < 0 || maxZonas > SecuenciadorExacto::kMaxZonas) {
+    throw invalid_argument("Error: Los tramos exactos deben tener entre 0 y " + to_string(SecuenciadorExacto::kMaxZonas) + " zonas");
+  }
+  maxTramo_ = maxZonas;
+}
+
+/**
+ * @brief Implementación del operador tramosExactos. Cada tramo de una ruta entre dos paradas fijas
+ *        (depósito o SWTS) con entre 2 y maxTramo_ zonas se ordena con SecuenciadorExacto. El contenido de
+ *        un tramo no depende del orden de sus zonas, así que el nuevo orden sólo puede cambiar la duración:
+ *        se comprueba con la copia completa de la ruta, como en el resto de operadores. Los tramos que
+ *        quedan en su orden óptimo se anotan por sus paradas (no por la ruta en la que están), para no
+ *        volver a ordenarlos y para que swapIntra, reinsertIntra y twoOptIntra no prueben los movimientos
+ *        dentro de ellos, que no pueden mejorar. Las rutas que no han cambiado desde que se recorrieron se
+ *        saltan enteras.
+ * @return true si se ha mejorado alguna ruta, false en caso contrario
+ */
+bool BusquedaLocal::tramosExactos() {
+  bool mejorado = false;
+  for (size_t i = 0; i < vehiculos_->size(); ++i) {
+    Recoleccion& ruta = (*vehiculos_)[i];
+    const pmr::vector<Zona>& zonas = ruta.getZonasVisitadas();
+    if (rutasRecorridas_.count(firmaTramo(zonas, 0, zonas.size() - 1))) continue; // No ha cambiado desde la pasada anterior
+    size_t inicio = 0; // Parada fija con la que empieza el tramo
+    for (size_t p = 1; p < zonas.size(); ++p) {
+      if (!zonas[p].esSWTS() && !zonas[p].esDeposito()) continue;
+      const size_t m = p - inicio - 1;
+      if (m >= 2 && m <= static_cast<size_t>(maxTramo_) && !tramosOptimos_.count(firmaTramo(zonas, inicio, p))) {
+        contar(Operador::tramosExactos, Suceso::evaluado);
+        double costeTramo = 0.0;
+        for (size_t q = inicio; q < p; ++q) costeTramo += zonas[q].getDistancia(zonas[q + 1]);
+        const double costeOptimo = secuenciador_.ordenar(zonas[inicio], span<const Zona>(zonas.data() + inicio + 1, m), zonas[p], ordenTramo_);
+        if (!(costeOptimo < costeTramo - kToleranciaTramo)) {
+          tramosOptimos_.insert(firmaTramo(zonas, inicio, p)); // Ya está en su orden óptimo
+        } else {
+          Recoleccion copia = ruta;
+          for (size_t q = 0; q < m; ++q) copia.getZonasVisitadas()[inicio + 1 + q] = zonas[inicio + 1 + ordenTramo_[q]];
+          // Si el orden óptimo no cabe en la duración, el tramo queda para los demás operadores
+          if (esFactible(copia, metricas_)) {
+            contar(Operador::tramosExactos, Suceso::factible);
+            if (calcularCostoRuta(copia, metricas_) < calcularCostoRuta(ruta, metricas_)) {
+              ruta = copia;
+              contar(Operador::tramosExactos, Suceso::aceptado);
               mejorado = true;
-              break;
+              tramosOptimos_.insert(firmaTramo(zonas, inicio, p));
             }
           }
         }
       }
+      inicio = p;
     }
+    rutasRecorridas_.insert(firmaTramo(zonas, 0, zonas.size() - 1));
   }
   return mejorado;
 }
 
+/**
+ * @brief Firma de un tramo: sus paradas, en orden, de la parada fija inicial a la final
+ * @param zonas Paradas de la ruta
+ * @param inicio Posición de la parada fija inicial
+ * @param fin Posición de la parada fija final
+ * @return uint64_t Hash FNV-1a de los identificadores de las paradas
+ */
+uint64_t BusquedaLocal::firmaTramo(const pmr::vector<Zona>& zonas, size_t inicio, size_t fin) {
+  uint64_t firma = 14695981039346656037ull;
+  for (size_t q = inicio; q <= fin; ++q) firma = (firma ^ hash<string>{}(zonas[q].getId())) * 1099511628211ull;
+  return firma;
+}
+
+/**
+ * @brief Método para saber qué paradas de la ruta i están en un tramo que tramosExactos dejó en su orden
+ *        óptimo. Los tramos se buscan por sus paradas, en orden, así que no importa si la ruta ha cambiado
+ *        fuera de ellos ni en qué posición del vector de rutas está; sin tramosExactos no hay ninguno.
+ * @param i Índice de la ruta
+ * @param tramos Vector en el que se deja el tramo de cada parada (-1 en las paradas fijas y en los
+ *        tramos sin resolver), o vacío si no hay ninguno resuelto
+ * @return void
+ */
+void BusquedaLocal::tramosResueltos(size_t i, vector<int>& tramos) {
+  tramos.clear();
+  if (maxTramo_ == 0 || tramosOptimos_.empty()) return;
+  const pmr::vector<Zona>& zonas = (*vehiculos_)[i].getZonasVisitadas();
+  int tramo = 0;
+  size_t inicio = 0;
+  for (size_t p = 1; p < zonas.size(); ++p) {
+    if (!zonas[p].esSWTS() && !zonas[p].esDeposito()) continue;
+    if (p - inicio > 2 && tramosOptimos_.count(firmaTramo(zonas, inicio, p))) {
+      tramos.resize(zonas.size(), -1);
+      for (size_t q = inicio + 1; q < p; ++q) tramos[q] = tramo;
+    }
+    tramo++;
+    inicio = p;
+  }
+}
+
 /**
  * @brief Método para verificar si la ruta del vehículo es factible
  * @param vehiculo Vehículo de recolección
+ * @param metricas Dónde contar la comprobación (nulo = no se cuenta)
  * @return true si la ruta es factible, false en caso contrario
  */
-bool BusquedaLocal::esFactible(const Recoleccion& vehiculo) {
+bool BusquedaLocal::esFactible(const Recoleccion& vehiculo, Metricas* metricas) {
+  instrumentar([&] {
+    if (metricas != nullptr) metricas->nucleo.esFactible++;
+  });
   // Verifico que el vehículo no exceda su capacidad
   double contenidoTotal = 0.0;
-  const vector<Zona>& zonasVisitadas = vehiculo.getZonasVisitadas();
+  const pmr::vector<Zona>& zonasVisitadas = vehiculo.getZonasVisitadas();
   for (const auto& zona : zonasVisitadas) {
     if (!zona.esSWTS() && !zona.esDeposito()) {
       contenidoTotal += zona.getContenido();
@@ -222,9 +643,13 @@ bool BusquedaLocal::esFactible(const Recoleccion& vehiculo) {
 /**
  * @brief Método para calcular el costo de una ruta
  * @param vehiculo Vehiculo de recolección
+ * @param metricas Dónde contar el cálculo (nulo = no se cuenta)
  * @return Costo de la ruta
  */
-double BusquedaLocal::calcularCostoRuta(const Recoleccion& vehiculo) {
+double BusquedaLocal::calcularCostoRuta(const Recoleccion& vehiculo, Metricas* metricas) {
+  instrumentar([&] {
+    if (metricas != nullptr) metricas->nucleo.calcularCostoRuta++;
+  });
   double costo = 0.0;
   // Calcular el costo de la ruta del vehículo
   for (size_t i = 0; i < vehiculo.getZonasVisitadas().size() - 1; i++) {
@@ -7,7 +7,13 @@
 
 #include "../../../tools/tools.h"
 #include "../grasp.h"
+#include "../../../tools/metricas/metricas.h"
+#include "../../insercion/insercion.h"
+#include "../memo_rutas/memo_rutas.h"
+#include "../secuenciador_exacto/secuenciador_exacto.h"
 #include <algorithm>
+#include <cmath>
+#include <unordered_set>
 
 class BusquedaLocal {
   public:
@@ -23,16 +29,99 @@ class BusquedaLocal {
     bool reinsertIntra();
     bool reinsertInter();
     bool twoOptIntra();
+    bool tramosExactos();
 
-    // Métodos auxiliares
-    double calcularCostoRuta(const Recoleccion& vehiculo);
-    bool esFactible(const Recoleccion& vehiculo); // Comprobar si la ruta del vehículo es factible
+    // Métodos auxiliares (sin estado: los usan también las búsquedas que mueven zonas entre rutas)
+    static double calcularCostoRuta(const Recoleccion& vehiculo, Metricas* metricas = nullptr);
+    static bool esFactible(const Recoleccion& vehiculo, Metricas* metricas = nullptr); // Comprobar si la ruta del vehículo es factible
 
     // Setters
-    void setVehiculos(std::vector<Recoleccion>& vehiculos) { vehiculos_ = &vehiculos; }
+    // Las anotaciones de tramosExactos se descartan: pueden ser rutas de otra instancia con los mismos identificadores
+    void setVehiculos(std::vector<Recoleccion>& vehiculos) { vehiculos_ = &vehiculos; tramosOptimos_.clear(); rutasRecorridas_.clear(); }
+    void setMetricas(Metricas& metricas) { metricas_ = &metricas; } // Opcional: dónde acumular los contadores por operador
+    // Opcional: evaluar los pares de rutas de swapInter/reinsertInter en paralelo (hilos: 0 = los de la máquina)
+    void setParalelo(bool activo, int hilos = 0) { paralelo_ = activo; hilos_ = hilos; }
+    // Opcional: vecindarios granulares. swapInter/reinsertInter sólo evalúan los movimientos que dejan alguna
+    // de las zonas movidas junto a una de sus vecinas del grafo (nulo = todos los movimientos)
+    void setVecinos(const GrafoVecinos* grafo) { grafo_ = grafo; }
+    // Opcional: memoria de rutas compartida. Los operadores intra-ruta no evalúan las rutas que ya están en el
+    // orden guardado para sus paradas, o en uno más corto, y al terminar se guardan las rutas resultantes (nulo = sin memoria)
+    void setMemo(MemoRutas* memo) { memo_ = memo; }
+    // Opcional: antes de los operadores intra-ruta, ordenar de forma exacta los tramos entre SWTS de hasta
+    // maxZonas zonas (ver tramosExactos); 0 = no se aplica
+    void setTramosExactos(int maxZonas);
 
   private:
+    // Suceso de un movimiento que se cuenta en las métricas del operador
+    enum class Suceso { evaluado, factible, aceptado };
+    inline void contar(Operador operador, Suceso suceso) {
+      if constexpr (!kInstrumentacion) return;
+      if (metricas_ == nullptr) return;
+      ContadorOperador& contador = metricas_->operador(operador);
+      switch (suceso) {
+        case Suceso::evaluado: contador.evaluados++; break;
+        case Suceso::factible: contador.factibles++; break;
+        case Suceso::aceptado: contador.aceptados++; break;
+      }
+    }
+    bool aplicarOperador(Operador operador, bool (BusquedaLocal::*metodo)()); // Aplica un operador midiendo su tiempo
+
+    // Margen de redondeo de las distancias de EvaluadorInsercion: las reinserciones que según el evaluador no
+    // mejoran por menos de esto se comprueban igualmente con la copia completa; en paralelo, hay que ganar más
+    static constexpr double kToleranciaInsercion = 1e-9;
+    // Un tramo cuyo orden exacto no ahorra más que esto ya se considera en su orden óptimo
+    static constexpr double kToleranciaTramo = 1e-9;
+
+    // Modo paralelo: el mejor movimiento de cada par de rutas (i, j), moviendo la zona k de i a la posición l de j
+    struct Movimiento {
+      double ganancia = 0.0; // Distancia que se ahorra
+      size_t i = 0, j = 0, k = 0, l = 0;
+    };
+    bool swapInterParalelo();
+    bool reinsertInterParalelo();
+    template<typename Evaluar>
+    std::vector<Movimiento> mejoresMovimientos(const std::vector<std::pair<size_t, size_t>>& pares, Evaluar&& evaluar);
+    std::vector<Movimiento> movimientosCompatibles(std::vector<Movimiento> movimientos) const;
+
+    // Memoria de rutas
+    bool resueltaPorMemo(size_t i, bool& mejorado); // Si los operadores intra-ruta pueden saltarse la ruta i
+
+    // Tramos exactos
+    void tramosResueltos(size_t i, std::vector<int>& tramos); // Tramo resuelto de cada parada de la ruta i (ver el .cc)
+    static uint64_t firmaTramo(const std::pmr::vector<Zona>& zonas, size_t inicio, size_t fin);
+    // Si las paradas a y b están en el mismo tramo resuelto: los movimientos entre ellas no pueden mejorar
+    static inline bool mismoTramo(const std::vector<int>& tramos, size_t a, size_t b) { return !tramos.empty() && tramos[a] >= 0 && tramos[a] == tramos[b]; }
+
+    // Vecindarios granulares
+    void actualizarIndices(); // Rellena indices_ con las rutas actuales (sólo con grafo)
+    // Si la zona (índice en Tools::zonas) queda junto a una de sus vecinas al ponerla entre las paradas a y b
+    inline bool junto(int zona, int a, int b) const { return grafo_->sonVecinos(zona, a) || grafo_->sonVecinos(zona, b); }
+    // Si alguna parada de la ruta es vecina de la zona, es decir, si alguna posición de inserción pasa el filtro
+    inline bool tieneVecinaEn(int zona, const std::vector<int>& indices) const {
+      return std::any_of(indices.begin(), indices.end(), [&](int parada) { return grafo_->sonVecinos(zona, parada); });
+    }
+
     std::vector<Recoleccion>* vehiculos_; // Vector de vehículos
+    Metricas* metricas_ = nullptr;
+    EvaluadorInsercion insercion_; // Se reutiliza entre llamadas de reinsertIntra/reinsertInter para no reservar memoria
+    bool paralelo_ = false;
+    int hilos_ = 0;
+    const GrafoVecinos* grafo_ = nullptr;
+    std::vector<std::vector<int>> indices_; // Índice en Tools::zonas de cada parada de cada ruta (sólo con grafo)
+    MemoRutas* memo_ = nullptr;
+    std::vector<int32_t> paradasMemo_, ordenMemo_; // Se reutilizan entre consultas a la memoria
+    // Última consulta de cada ruta a la memoria en esta pasada: mientras sus paradas no cambien, vale la respuesta
+    struct ConsultaMemo {
+      std::vector<int32_t> paradas; // En el orden de la ruta
+      bool resuelta = false;
+    };
+    std::vector<ConsultaMemo> consultasMemo_;
+    int maxTramo_ = 0;
+    SecuenciadorExacto secuenciador_;
+    std::vector<int> ordenTramo_, tramosRuta_; // Se reutilizan entre tramos y entre rutas
+    // Tramos que tramosExactos dejó en su orden óptimo y rutas que ya ha recorrido tal como están (ver
+    // firmaTramo; una ruta es el tramo de su primera parada a la última). Valen en cualquier ruta y posición
+    std::unordered_set<uint64_t> tramosOptimos_, rutasRecorridas_;
 };
 
 #endif
\ No newline at end of file
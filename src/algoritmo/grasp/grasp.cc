@@ -1,182 +1,403 @@
 #include "grasp.h"
 #include "../../tools/tools.h"
+#include "../../tools/paralelo/paralelo.h"
+#include "../../solucion/solucion.h"
+#include "../constructor/constructor.h"
+#include "memo_rutas/memo_rutas.h"
+#include "ruina_recreacion/ruina_recreacion.h"
+#include "reencadenamiento_trayectorias/reencadenamiento_trayectorias.h"
+#include "../descomposicion/descomposicion.h"
 #include <iomanip>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 
-/**
- * @brief Método para obtener la zona más cercana al vehículo que no haya sido visitada aún.
- *        Para ello se calculara la distancia euclídea entre el vehículo y las zonas que no han sido visitadas.
- * @param vehiculo Vehículo que se va a mover
- * @param numeroMejoresZonas Número de mejores zonas a considerar
- * @return Zona más cercana al vehículo con su distancia
- */
-pair<Zona&, double> Grasp::zonaMasCercana(const Recoleccion& vehiculo, const int numeroMejoresZonas) {
-  const vector<vector<double>>& distancias = dato_->distancias;
-  const Zona& zonaActual = vehiculo.getPosicion();
-  auto it = find(dato_->zonas.begin(), dato_->zonas.end(), zonaActual); // Obtengo la posicion de la zona
-
-  int index = distance(dato_->zonas.begin(), it);
-
-  vector<pair<Zona*, double>> mejoresZonas; // Vector para almacenar las mejores zonas y sus distancias
-
-  for (int i = 1; i <= numeroMejoresZonas; i++) {
-    double minDistanciaZona = INFINITY;
-    Zona* mejorZona = nullptr;
-
-    for (size_t j = 0; j < distancias[index].size(); j++) {
-      if (distancias[index][j] < minDistanciaZona &&
-          find(vehiculo.getZonasVisitadas().begin(), vehiculo.getZonasVisitadas().end(), dato_->zonas[j]) == vehiculo.getZonasVisitadas().end() &&
-          find(dato_->zonasRecoleccion.begin(), dato_->zonasRecoleccion.end(), dato_->zonas[j]) != dato_->zonasRecoleccion.end() &&
-          find(mejoresZonas.begin(), mejoresZonas.end(), make_pair(&dato_->zonas[j], distancias[index][j])) == mejoresZonas.end()) {
-        minDistanciaZona = distancias[index][j];
-        mejorZona = &dato_->zonas[j];
-      }
-    }
-    if (mejorZona != nullptr) {
-      mejoresZonas.push_back(make_pair(mejorZona, minDistanciaZona));
-    }
-  }
-  if (mejoresZonas.empty()) {
-    throw runtime_error("Grasp::zonaMasCercana: no quedan zonas de recolección candidatas para el vehículo");
-  }
-  // Escogemos una zona al azar entre las mejores zonas
-  static mt19937 gen(random_device{}());
-  uniform_int_distribution<size_t> dis(0, mejoresZonas.size() - 1);
-  const size_t indiceAleatorio = dis(gen);
-
-  return pair<Zona&, double>(*mejoresZonas[indiceAleatorio].first, mejoresZonas[indiceAleatorio].second);
-}
+namespace {
 
 /**
- * @brief Método para obtener la swts más cercana
- * @param vehiculo Vehículo que se va a mover
- * @return SWTS más cercana al vehículo con su distancia
+ * @brief Función para sacar de unas rutas las que no están en otras (con las mismas paradas en el mismo orden)
+ * @param rutas Rutas de las que se sacan las cambiadas
+ * @param originales Rutas con las que se comparan
+ * @param indices Posición de cada zona en Tools::zonas
+ * @return vector<Recoleccion> Rutas cambiadas, en el orden en que estaban
  */
-pair<Zona&, double> Grasp::swtsMasCercana(const Recoleccion& vehiculo) {
-  const vector<vector<double>>& distancias = dato_->distancias;
-  const Zona& zonaActual = vehiculo.getPosicion();
-  Zona* swtsCercana = nullptr;
-  double minDistancia = INFINITY;
-
-  auto it = find(dato_->zonas.begin(), dato_->zonas.end(), zonaActual);
-
-  int posicion = distance(dato_->zonas.begin(), it);
-
-  for (size_t i = 0; i < distancias[posicion].size(); i++) {
-    Zona& zona = dato_->zonas[i];
-    if (!zona.esSWTS()) continue;
-    else {
-      if (distancias[posicion][i] < minDistancia) {
-        minDistancia = distancias[posicion][i];
-        swtsCercana = &dato_->zonas[i];
-      }
-    }
+vector<Recoleccion> separarCambiadas(vector<Recoleccion>& rutas, const vector<Recoleccion>& originales, const unordered_map<string, int>& indices) {
+  auto paradas = [&](const Recoleccion& ruta) {
+    vector<int32_t> resultado;
+    for (const Zona& zona : ruta.getZonasVisitadas()) resultado.push_back(indices.at(zona.getId()));
+    return resultado;
+  };
+  unordered_set<vector<int32_t>, Solucion::HashFirma> vistas;
+  for (const Recoleccion& ruta : originales) vistas.insert(paradas(ruta));
+  vector<Recoleccion> cambiadas, iguales;
+  for (Recoleccion& ruta : rutas) {
+    if (vistas.count(paradas(ruta))) iguales.push_back(std::move(ruta));
+    else cambiadas.push_back(std::move(ruta));
   }
-  return pair<Zona&, double>(*swtsCercana, minDistancia);
+  rutas = std::move(iguales);
+  return cambiadas;
 }
 
-/**
- * @brief Método para obtener el tiempo en que tarda el vehículo en volver al depósito pasando por las zonas y la swts más cercana
- * @param vehiculo Vehículo que se va a mover
- * @param numeroMejoresZonas Número de mejores zonas a considerar
- * @return Tiempo que tarda en volver al depósito
- */
-int Grasp::TiempoVolverDeposito(const Recoleccion& vehiculo, const int numeroMejoresZonas) {
-  int tiempo = 0;
-  pair<Zona&, double> zonaTransferenciaCercana = swtsMasCercana(vehiculo);
-  pair<Zona&, double> zonaCercana = zonaMasCercana(vehiculo, numeroMejoresZonas);
-
-  Recoleccion vehiculoAux = vehiculo;
-  vehiculoAux.setPosicion(zonaTransferenciaCercana.first);
-  // Tiempo que tarda en llegar a la zona más cercana
-  tiempo += vehiculo.calcularTiempo(vehiculo.getPosicion().getDistancia(zonaCercana.first));
-  // Tiempo que tarda en procesar la zona más cercana
-  tiempo += zonaCercana.first.getTiempoDeProcesado();
-  // Tiempo que tarda en llegar a la swts más cercana
-  tiempo += vehiculo.calcularTiempo(zonaCercana.first.getDistancia(zonaTransferenciaCercana.first));
-  // Tiempo que tarda en volver al depósito desde la swts más cercana
-  tiempo += vehiculoAux.calcularTiempo(dato_->zonas[0].getDistancia(vehiculoAux.getPosicion()));
-
-  return tiempo;
-}
+} // namespace
 
 /**
- * @brief Método para calcular las rutas de los vehículos de recolección
+ * @brief Método para calcular las rutas de los vehículos de recolección con el Constructor y la política
+ *        de selección de la instancia de Grasp (por defecto, al azar entre las mejores zonas)
+ * @param dato Instancia sobre la que se construye la solución (se guardan en ella las rutas)
  * @param numeroMejoresZonas Número de mejores zonas a considerar
- * @param ejecucion Número de ejecución
+ * @param generador Generador aleatorio de la ejecución
  * @return void
  */
-void Grasp::calcularRutasRecoleccion(const int numeroMejoresZonas, const int ejecucion) {
-  vector<Recoleccion> rutasDeVehiculos;
-  vector<Zona>& zonasPendientes = dato_->zonasRecoleccion;
-  while (!zonasPendientes.empty()) {
-    // Creamos el vehículo
-    Recoleccion vehiculo(dato_->capacidadRecoleccion, dato_->velocidad, dato_->zonas[0], dato_->duracionRecoleccion);
-    do {
-      if (zonasPendientes.empty()) break;
-      pair<Zona&, double> zonaCercana = zonaMasCercana(vehiculo, numeroMejoresZonas);
-      int tiempoEnVolverAlDeposito = TiempoVolverDeposito(vehiculo, numeroMejoresZonas);
-      // Si el contendio de la zona es menor a la capacidad del vehículo y le da tiempo a volver al deposito
-      if (vehiculo.llenarVehiculo(zonaCercana.first.getContenido()) && tiempoEnVolverAlDeposito <= (vehiculo.getDuracion() - vehiculo.getTiempoTranscurrido())) {
-        vehiculo.moverVehiculo(zonaCercana.first, zonaCercana.second);
-        vehiculo.vaciarZona(zonaCercana.first);
-        zonasPendientes.erase(remove(zonasPendientes.begin(), zonasPendientes.end(), zonaCercana.first), zonasPendientes.end());
-      } else if (tiempoEnVolverAlDeposito <= (vehiculo.getDuracion() - vehiculo.getTiempoTranscurrido())) {
-        // Si no puede recoger la zona, buscamos la swts más cercana
-        pair<Zona&, double> swtsCercana = swtsMasCercana(vehiculo);
-        vehiculo.moverVehiculo(swtsCercana.first, swtsCercana.second);
-        vehiculo.vaciarVehiculo(swtsCercana.first);
-      } else {
-        break; // No se puede añadir más zonas
-      }
-    } while (true);
-    // Si la última zona visitada no es una swts, buscamos la más cercana
-    if (!vehiculo.getPosicion().esSWTS()) {
-      pair<Zona&, double> swtsCercana = swtsMasCercana(vehiculo);
-      vehiculo.moverVehiculo(swtsCercana.first, swtsCercana.second);
-      vehiculo.vaciarVehiculo(swtsCercana.first);
-      vehiculo.volverAlInicio();
-    }
-    else {
-      vehiculo.volverAlInicio();
-    }
-    rutasDeVehiculos.push_back(vehiculo);
+void Grasp::calcularRutasRecoleccion(Tools& dato, const int numeroMejoresZonas, mt19937& generador) {
+  switch (seleccion_) {
+    case TipoSeleccion::lrcCardinalidad:
+      construirRutas(dato, PoliticaLRCCardinalidad(numeroMejoresZonas, generador));
+      break;
+    case TipoSeleccion::lrcValor:
+      construirRutas(dato, PoliticaLRCValor(alfa_, generador));
+      break;
+    case TipoSeleccion::arrepentimiento:
+      construirRutas(dato, PoliticaArrepentimiento(numeroMejoresZonas));
+      break;
   }
-  dato_->rutasRecoleccion = std::move(rutasDeVehiculos);
-  // dato_ apunta a un Tools creado con "new" en Grasp::ejecutar: el shared_ptr toma posesión
-  // para liberarlo automáticamente y mantenerlo con vida mientras alguien lo siga referenciando
-  // (p.ej. RVND, que consulta estos resultados después de que Grasp haya terminado).
-  datos_.push_back(shared_ptr<Tools>(dato_));
-  mejoresZonasYEjecuciones_.push_back(make_pair(numeroMejoresZonas, ejecucion)); // Guardamos el número de mejores zonas y la ejecución
 }
 
 /**
- * @brief Método para ejecutar el algoritmo GRASP
+ * @brief Método para ejecutar el algoritmo GRASP. Cada combinación (LRC, ejecución) es independiente:
+ *        trabaja sobre su propia copia de la instancia y con su propio generador aleatorio, por lo que
+ *        se reparten entre hilos_ hilos. Se hace en dos pasadas: primero se construyen las rutas de
+ *        todas las combinaciones y después se mejoran y se calcula el transporte, pero sólo de la
+ *        primera de cada grupo de construcciones repetidas (misma Solucion::firmaRecoleccion); las
+ *        demás reutilizan su resultado. Los grupos se forman en el orden de las combinaciones, así que
+ *        el resultado no depende del número de hilos. Si hay tiempo límite, no se empiezan
+ *        combinaciones nuevas una vez agotado (la primera se ejecuta siempre). Con vecindarioParalelo_,
+ *        los hilos que sobran cuando hay menos combinaciones que hilos se reparten entre las búsquedas
+ *        locales. Con memoRutas_, todas las búsquedas locales de la instancia comparten una MemoRutas;
+ *        como su contenido depende del orden en que terminan, con varios hilos el resultado puede variar.
+ *        Con lns_, después de la búsqueda local (o en su lugar, sin busquedaLocal_) se aplica la ruina y
+ *        recreación, con un generador sembrado también por la combinación (las repetidas sólo reutilizan
+ *        la búsqueda local de su original y aplican cada una la suya). Con grupos en descomposicion_,
+ *        cada combinación construye y mejora por separado cada grupo de zonas (con un generador por
+ *        grupo), repartiendo los grupos entre los hilos que le tocan, y la ruina y recreación y el
+ *        transporte se aplican a las rutas de todos juntas. Con reencadenamiento_, al terminar la segunda
+ *        pasada se toman las mejores soluciones distintas (la élite) y cada una recorre el camino hacia
+ *        cada una de las demás (ver ReencadenamientoTrayectorias), en paralelo, partiendo cada vez de la
+ *        mejor solución intermedia hasta entonces; se aplica la búsqueda local a las rutas que han
+ *        cambiado y se queda con el resultado si, con su transporte, mejora la suya.
  * @return void
  */
 void Grasp::ejecutar() {
-  Tools datoOriginal = *dato_;
-  auto voraz = make_unique<Voraz>();
-  BusquedaLocal local;
+  const Tools datoOriginal = [&] {
+    AmbitoMemoria memoria(FaseMemoria::copiaInstancia);
+    return *dato_;
+  }();
+  vector<pair<int, int>> combinaciones;
   for (int i = 2; i <= numeroMejoresZonasCercanas_; i++) {
     for (int j = 1; j <= numeroEjecuciones_; j++) {
-      dato_ = new Tools(datoOriginal); // Creamos una nueva instancia de Tools a partir del dato original
-      auto start = chrono::high_resolution_clock::now();
-      calcularRutasRecoleccion(i, j); // Calculamos las rutas de recolección
-      distanciaSinMejoras.push_back(dato_->calcularDistanciaRecoleccion());
-      // Mejoro las rutas
-      local.setVehiculos(dato_->rutasRecoleccion);
-      local.mejorarRutas();
-      distanciasConMejoras_.push_back(dato_->calcularDistanciaRecoleccion());
+      combinaciones.push_back(make_pair(i, j));
+    }
+  }
+  const auto indices = Solucion::indicesDeZonas(datoOriginal);
+  // Los grupos sólo dependen de la instancia: son los mismos en todas las combinaciones
+  unique_ptr<Descomposicion> descomposicion;
+  if (descomposicion_.grupos > 1) descomposicion = make_unique<Descomposicion>(datoOriginal, descomposicion_);
+  struct Resultado {
+    shared_ptr<Tools> dato;
+    Solucion solucion;
+    vector<int32_t> firma; // Firma de las rutas construidas (antes de mejorarlas)
+    double distanciaSinMejoras = 0.0;
+    double distanciaConMejoras = 0.0;
+    double fin = 0.0; // Segundos desde el inicio hasta que termina la combinación
+    bool buscada = false; // Ya tiene búsqueda local
+    bool mejorada = false; // Ya tiene búsqueda local, LNS y transporte
+    vector<size_t> inicios; // Primera ruta de cada grupo de la descomposición (vacío sin ella)
+  };
+  vector<Resultado> resultados(combinaciones.size());
+  const int hilosTotales = hilosEfectivos(hilos_);
+  const int hilosBusqueda = max(1, hilosTotales / max(1, min(hilosTotales, static_cast<int>(combinaciones.size()))));
+  const auto inicio = chrono::steady_clock::now();
+  auto agotado = [&](size_t c) {
+    const double transcurrido = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    return c > 0 && tiempoLimite_ > 0 && transcurrido >= tiempoLimite_;
+  };
+  auto nombreTraza = [&](size_t c) {
+    return Traza::global().activa() ? "GRASP " + datoOriginal.nombreInstancia + " LRC=" + to_string(combinaciones[c].first) + " #" + to_string(combinaciones[c].second) : string();
+  };
+  // Primera pasada: construcción
+  paraleloPara(combinaciones.size(), hilos_, [&](size_t c) {
+    if (agotado(c)) return;
+    const auto [mejoresZonas, ejecucion] = combinaciones[c];
+    IntervaloTraza intervalo(nombreTraza(c), "grasp");
+    seed_seq semillas{semilla_, static_cast<unsigned>(mejoresZonas), static_cast<unsigned>(ejecucion)};
+    mt19937 generador(semillas);
+    // El shared_ptr es dueño de la copia, así sigue con vida mientras alguien la referencie
+    // (p.ej. RVND, que consulta estos resultados después de que Grasp haya terminado).
+    shared_ptr<Tools> dato;
+    {
+      AmbitoMemoria memoria(FaseMemoria::copiaInstancia);
+      dato = make_shared<Tools>(datoOriginal);
+    }
+    auto start = chrono::high_resolution_clock::now();
+    dato->metricas = Metricas();
+    {
+      // Las rutas se construyen en la arena del hilo y se sacan de ella para la segunda pasada
+      ArenaIteracion arena;
+      MedidorFase medidor(dato->metricas.construccion);
+      IntervaloTraza intervaloConstruccion("construccion", "construccion");
+      AmbitoMemoria memoria(FaseMemoria::construccion);
+      if (descomposicion) {
+        resultados[c].inicios = descomposicion->construir(*dato, hilosBusqueda, [&](Tools& grupo, size_t g) {
+          seed_seq semillasGrupo{semilla_, static_cast<unsigned>(mejoresZonas), static_cast<unsigned>(ejecucion), 2u, static_cast<unsigned>(g)};
+          mt19937 generadorGrupo(semillasGrupo);
+          calcularRutasRecoleccion(grupo, mejoresZonas, generadorGrupo);
+        });
+      } else {
+        calcularRutasRecoleccion(*dato, mejoresZonas, generador); // Calculamos las rutas de recolección
+      }
+      reubicarVehiculos(dato->rutasRecoleccion, pmr::new_delete_resource());
+    }
+    resultados[c].distanciaSinMejoras = dato->calcularDistanciaRecoleccion();
+    resultados[c].firma = Solucion::firmaRecoleccion(*dato, indices);
+    auto end = chrono::high_resolution_clock::now();
+    dato->tiempoCPU = std::chrono::duration<double>(end - start).count();
+    resultados[c].dato = std::move(dato);
+  });
+  // Cada combinación se mejora o reutiliza el resultado de la primera con su misma firma
+  vector<size_t> original(combinaciones.size());
+  vector<size_t> aMejorar;
+  {
+    unordered_map<vector<int32_t>, size_t, Solucion::HashFirma> vistas;
+    for (size_t c = 0; c < combinaciones.size(); c++) {
+      if (!resultados[c].dato) continue;
+      const auto [posicion, nueva] = vistas.emplace(std::move(resultados[c].firma), c);
+      original[c] = posicion->second;
+      if (nueva) aMejorar.push_back(c);
+    }
+  }
+  // Segunda pasada: búsqueda local y transporte de las construcciones distintas
+  unique_ptr<MemoRutas> memo;
+  if (memoRutas_ > 0) memo = make_unique<MemoRutas>(datoOriginal.zonas, memoRutas_);
+  auto mejorarRutas = [&](vector<Recoleccion>& rutas, Metricas& metricas, int hilos) {
+    BusquedaLocal local;
+    local.setVehiculos(rutas);
+    local.setMetricas(metricas);
+    local.setParalelo(vecindarioParalelo_, hilos);
+    local.setVecinos(datoOriginal.vecinos.get());
+    local.setMemo(memo.get());
+    local.setTramosExactos(tramosExactos_);
+    local.mejorarRutas();
+  };
+  // Con descomposición, cada grupo por separado, con sus propias métricas, que se suman al terminar
+  auto mejorarGrupos = [&](vector<Recoleccion>& rutas, const vector<size_t>& inicios, Metricas& metricas) {
+    const int grupos = static_cast<int>(inicios.size()) - 1;
+    vector<Metricas> metricasGrupos(grupos);
+    Descomposicion::mejorar(rutas, inicios, hilosBusqueda, [&](vector<Recoleccion>& rutasGrupo, size_t g) {
+      mejorarRutas(rutasGrupo, metricasGrupos[g], max(1, hilosBusqueda / grupos));
+    });
+    for (const Metricas& metricasGrupo : metricasGrupos) metricas.acumular(metricasGrupo);
+  };
+  // LNS y transporte de una combinación que ya tiene búsqueda local (en la arena del hilo que la llama)
+  auto terminar = [&](size_t c) {
+    Tools* dato = resultados[c].dato.get();
+    auto start = chrono::high_resolution_clock::now();
+    if (lns_.iteraciones > 0) {
+      MedidorFase medidor(dato->metricas.busquedaLocal);
+      // Generador propio, para que la construcción de la combinación no dependa de si hay LNS
+      const auto [mejoresZonas, ejecucion] = combinaciones[c];
+      seed_seq semillas{semilla_, static_cast<unsigned>(mejoresZonas), static_cast<unsigned>(ejecucion), 1u};
+      mt19937 generador(semillas);
+      RuinaRecreacion lns(*dato, lns_, generador);
+      lns.setVehiculos(dato->rutasRecoleccion);
+      lns.setMetricas(dato->metricas);
+      lns.mejorar();
+    }
+    resultados[c].distanciaConMejoras = dato->calcularDistanciaRecoleccion();
+    {
       // Calculo las rutas de transporte
-      voraz->setDato(*dato_);
-      voraz->calcularRutasTransporte();
+      MedidorFase medidor(dato->metricas.transporte);
+      Voraz voraz(*dato);
+      voraz.calcularRutasTransporte();
+    }
 
+    auto end = chrono::high_resolution_clock::now();
+    dato->tiempoCPU += std::chrono::duration<double>(end - start).count();
+    resultados[c].fin = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    // El resultado sobrevive a la iteración: se copian sus rutas fuera de la arena antes de liberarla
+    reubicarVehiculos(dato->rutasRecoleccion, pmr::new_delete_resource());
+    reubicarVehiculos(dato->rutasTransporte, pmr::new_delete_resource());
+    resultados[c].solucion = Solucion(*dato, indices);
+    resultados[c].mejorada = true;
+  };
+  paraleloPara(aMejorar.size(), hilos_, [&](size_t i) {
+    const size_t c = aMejorar[i];
+    if (agotado(c)) return;
+    IntervaloTraza intervalo(nombreTraza(c), "grasp");
+    Tools* dato = resultados[c].dato.get();
+    // Las copias que hace la búsqueda local viven en la arena del hilo
+    ArenaIteracion arena;
+    auto start = chrono::high_resolution_clock::now();
+    {
+      // Mejoro las rutas
+      MedidorFase medidor(dato->metricas.busquedaLocal);
+      IntervaloTraza intervaloBusqueda("busquedaLocal", "busquedaLocal");
+      const vector<size_t>& inicios = resultados[c].inicios;
+      if (busquedaLocal_ && inicios.empty()) {
+        mejorarRutas(dato->rutasRecoleccion, dato->metricas, hilosBusqueda);
+      } else if (busquedaLocal_) {
+        mejorarGrupos(dato->rutasRecoleccion, inicios, dato->metricas);
+      }
+    }
+    dato->tiempoCPU += std::chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    resultados[c].buscada = true;
+    if (lns_.iteraciones == 0) terminar(c);
+    else reubicarVehiculos(dato->rutasRecoleccion, pmr::new_delete_resource());
+  });
+  if (lns_.iteraciones > 0) {
+    // Con LNS las repetidas sólo reutilizan la búsqueda local: parten de las rutas mejoradas de su original
+    // y aplican su propia LNS, con el generador de su combinación
+    vector<size_t> aTerminar;
+    for (size_t c = 0; c < combinaciones.size(); c++) {
+      if (!resultados[c].dato || !resultados[original[c]].buscada) continue;
+      if (original[c] != c) {
+        resultados[c].dato->rutasRecoleccion = resultados[original[c]].dato->rutasRecoleccion;
+        resultados[c].dato->metricas.duplicadas = 1;
+      }
+      aTerminar.push_back(c);
+    }
+    paraleloPara(aTerminar.size(), hilos_, [&](size_t i) {
+      const size_t c = aTerminar[i];
+      if (original[c] != c && agotado(c)) return;
+      IntervaloTraza intervalo(nombreTraza(c), "grasp");
+      ArenaIteracion arena;
+      terminar(c);
+    });
+  }
+  // Reencadenamiento de trayectorias entre las mejores soluciones mejoradas
+  const bool sinTiempo = tiempoLimite_ > 0 && chrono::duration<double>(chrono::steady_clock::now() - inicio).count() >= tiempoLimite_;
+  if (reencadenamiento_ > 1 && !sinTiempo) {
+    vector<size_t> candidatas;
+    for (size_t c = 0; c < combinaciones.size(); c++) {
+      if (resultados[c].mejorada) candidatas.push_back(c);
+    }
+    stable_sort(candidatas.begin(), candidatas.end(), [&](size_t a, size_t b) { return resultados[a].solucion.mejorQue(resultados[b].solucion); });
+    // Construcciones distintas pueden acabar en la misma solución tras la búsqueda local
+    vector<size_t> elite;
+    for (size_t c : candidatas) {
+      if (elite.size() == static_cast<size_t>(reencadenamiento_)) break;
+      if (none_of(elite.begin(), elite.end(), [&](size_t e) { return resultados[e].solucion == resultados[c].solucion; })) elite.push_back(c);
+    }
+    // Cada camino parte de una copia: las rutas de la élite son las guías de los demás hilos
+    vector<vector<Recoleccion>> reencadenadas(elite.size());
+    vector<char> reencadenada(elite.size(), 0);
+    paraleloPara(elite.size(), hilos_, [&](size_t i) {
+      IntervaloTraza intervalo(nombreTraza(elite[i]), "grasp");
+      Tools& dato = *resultados[elite[i]].dato;
+      // Las copias del reencadenamiento y de la búsqueda local viven en la arena del hilo
+      ArenaIteracion arena;
+      auto start = chrono::high_resolution_clock::now();
+      {
+        MedidorFase medidor(dato.metricas.busquedaLocal);
+        IntervaloTraza intervaloReencadenamiento("reencadenamiento", "busquedaLocal");
+        ReencadenamientoTrayectorias reencadenamiento(datoOriginal);
+        reencadenamiento.setMetricas(dato.metricas);
+        reencadenadas[i] = dato.rutasRecoleccion;
+        for (size_t guia : elite) {
+          if (guia != elite[i] && reencadenamiento.recorrer(reencadenadas[i], resultados[guia].dato->rutasRecoleccion)) reencadenada[i] = 1;
+        }
+        if (reencadenada[i] && busquedaLocal_) {
+          // La mejor solución de los caminos no suele ser un óptimo local: se mejoran las rutas que han cambiado
+          vector<Recoleccion> cambiadas = separarCambiadas(reencadenadas[i], dato.rutasRecoleccion, indices);
+          if (descomposicion) mejorarGrupos(cambiadas, descomposicion->agrupar(cambiadas, indices), dato.metricas);
+          else mejorarRutas(cambiadas, dato.metricas, hilosBusqueda);
+          for (Recoleccion& ruta : cambiadas) reencadenadas[i].push_back(std::move(ruta));
+        }
+      }
+      reubicarVehiculos(reencadenadas[i], pmr::new_delete_resource());
+      auto end = chrono::high_resolution_clock::now();
+      dato.tiempoCPU += std::chrono::duration<double>(end - start).count();
+    });
+    // El transporte se vuelve a calcular con las rutas nuevas, desde el vertedero vacío de la instancia; si
+    // la solución completa no mejora (p.ej. porque el transporte necesita un vehículo más), se descarta
+    const double contenidoVertedero = datoOriginal.zonas[datoOriginal.indiceVertedero].getContenido();
+    for (size_t i = 0; i < elite.size(); i++) {
+      if (!reencadenada[i]) continue;
+      Resultado& resultado = resultados[elite[i]];
+      Tools& dato = *resultado.dato;
+      auto start = chrono::high_resolution_clock::now();
+      swap(dato.rutasRecoleccion, reencadenadas[i]);
+      vector<Transporte> transporte = std::move(dato.rutasTransporte);
+      const double vertedero = dato.vertedero().getContenido();
+      dato.vertedero().setContenido(contenidoVertedero);
+      {
+        MedidorFase medidor(dato.metricas.transporte);
+        Voraz voraz(dato);
+        voraz.calcularRutasTransporte();
+      }
+      Solucion solucion(dato, indices);
+      if (solucion.mejorQue(resultado.solucion)) {
+        resultado.solucion = std::move(solucion);
+        resultado.distanciaConMejoras = dato.calcularDistanciaRecoleccion();
+        resultado.fin = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+      } else {
+        swap(dato.rutasRecoleccion, reencadenadas[i]);
+        dato.rutasTransporte = std::move(transporte);
+        dato.vertedero().setContenido(vertedero);
+      }
       auto end = chrono::high_resolution_clock::now();
-      dato_->tiempoCPU = std::chrono::duration<double>(end - start).count();
+      dato.tiempoCPU += std::chrono::duration<double>(end - start).count();
     }
   }
+  // Sin LNS, las repetidas copian el resultado de su original, que incluye lo que el transporte deja en las
+  // zonas (se descartan si la original no llegó a mejorarse); conservan sus propios tiempos de construcción
+  for (size_t c = 0; c < combinaciones.size(); c++) {
+    if (!resultados[c].dato || resultados[c].mejorada) continue;
+    const Resultado& base = resultados[original[c]];
+    if (!base.mejorada || lns_.iteraciones > 0) {
+      resultados[c].dato.reset();
+      continue;
+    }
+    Tools& dato = *resultados[c].dato;
+    Metricas metricas = std::move(dato.metricas);
+    const double tiempoCPU = dato.tiempoCPU;
+    {
+      AmbitoMemoria memoria(FaseMemoria::copiaInstancia);
+      dato = *base.dato;
+    }
+    dato.metricas = std::move(metricas);
+    dato.metricas.duplicadas = 1;
+    dato.tiempoCPU = tiempoCPU;
+    resultados[c].solucion = base.solucion;
+    resultados[c].distanciaConMejoras = base.distanciaConMejoras;
+    resultados[c].fin = base.fin;
+  }
+  // Guardo los resultados en el orden de las combinaciones (las no ejecutadas por tiempo se descartan)
+  for (size_t c = 0; c < combinaciones.size(); c++) {
+    if (!resultados[c].dato) continue;
+    datos_.push_back(resultados[c].dato);
+    soluciones_.push_back(resultados[c].solucion);
+    mejoresZonasYEjecuciones_.push_back(combinaciones[c]); // Guardamos el número de mejores zonas y la ejecución
+    distanciaSinMejoras.push_back(resultados[c].distanciaSinMejoras);
+    distanciasConMejoras_.push_back(resultados[c].distanciaConMejoras);
+  }
+  // Trayectoria de la mejor solución: se recorren las combinaciones en el orden en que terminaron
+  // y se anota cada una que mejore a la mejor hasta entonces (menos vehículos o, con los mismos, menos distancia)
+  vector<size_t> orden;
+  for (size_t c = 0; c < combinaciones.size(); c++) {
+    if (resultados[c].dato) orden.push_back(c);
+  }
+  stable_sort(orden.begin(), orden.end(), [&](size_t a, size_t b) { return resultados[a].fin < resultados[b].fin; });
+  vector<PuntoConvergencia> convergencia;
+  const Resultado* incumbente = nullptr;
+  for (size_t i = 0; i < orden.size(); i++) {
+    const Resultado& resultado = resultados[orden[i]];
+    if (incumbente != nullptr && !resultado.solucion.mejorQue(incumbente->solucion)) continue;
+    const Solucion& solucion = resultado.solucion;
+    convergencia.push_back(PuntoConvergencia{resultado.fin, static_cast<int>(i) + 1, static_cast<int>(solucion.numRutasRecoleccion()),
+                                             static_cast<int>(solucion.numRutasTransporte()), solucion.getDistanciaRecoleccion()});
+    incumbente = &resultado;
+  }
+  if (incumbente != nullptr) incumbente->dato->convergencia = std::move(convergencia);
 }
 
 /**
@@ -194,6 +415,22 @@ vector<shared_ptr<Tools>> Grasp::getDato(const Tools& dato) {
   return datos;
 }
 
+/**
+ * @brief Método para obtener las soluciones de las diferentes ejecuciones de una misma instancia,
+ *        en el mismo orden que getDato
+ * @param dato Instancia
+ * @return vector<Solucion> Soluciones de la instancia
+ */
+vector<Solucion> Grasp::getSoluciones(const Tools& dato) {
+  vector<Solucion> soluciones;
+  for (size_t i = 0; i < datos_.size(); i++) {
+    if (datos_[i]->nombreInstancia == dato.nombreInstancia) {
+      soluciones.push_back(soluciones_[i]);
+    }
+  }
+  return soluciones;
+}
+
 /**
  * @brief Método para mostrar los resultados del algoritmo GRASP
  * @return void
@@ -262,6 +499,7 @@ void Grasp::mostrarResultados() {
   cout << "--------------------------------------------------------------------------------------------" << endl;
 
   mostrarDistancias();
+  mostrarMetricas(datos_);
 }
 
 /**
@@ -8,6 +8,8 @@
 #include "../../vehiculo/recoleccion/recoleccion.h"
 #include "../voraz/voraz.h"
 #include "busqueda_local/busqueda_local.h"
+#include "../../solucion/solucion.h"
+#include "../../tools/opciones/opciones.h"
 #include <random>
 
 class Grasp : public Algoritmo {
@@ -19,23 +21,47 @@ class Grasp : public Algoritmo {
     // Métodos de la clase
     void ejecutar() override;
     void mostrarResultados() override;
-    void calcularRutasRecoleccion(const int mejorezZonas, const int ejecucion); // Método para calcular las rutas de recolección
+    void calcularRutasRecoleccion(Tools& dato, const int numeroMejoresZonas, std::mt19937& generador); // Método para calcular las rutas de recolección
     void mostrarDistancias();
 
+    // Setters
+    inline void setSemilla(unsigned semilla) { semilla_ = semilla; }
+    inline void setSeleccion(TipoSeleccion seleccion, double alfa) { seleccion_ = seleccion; alfa_ = alfa; } // alfa sólo lo usa la LRC por valor
+    inline void setHilos(int hilos) { hilos_ = hilos; } // 0 = los que tenga la máquina
+    inline void setVecindarioParalelo(bool activo) { vecindarioParalelo_ = activo; } // Ver BusquedaLocal::setParalelo
+    inline void setTiempoLimite(double segundos) { tiempoLimite_ = segundos; } // 0 = sin límite
+    inline void setMemoRutas(int capacidad) { memoRutas_ = capacidad; } // Ver MemoRutas; 0 = sin memoria
+    inline void setTramosExactos(int maxZonas) { tramosExactos_ = maxZonas; } // Ver BusquedaLocal::setTramosExactos
+    inline void setLNS(const ConfiguracionLNS& lns, bool busquedaLocal = true) { lns_ = lns; busquedaLocal_ = busquedaLocal; } // Ver RuinaRecreacion
+    inline void setDescomposicion(const ConfiguracionDescomposicion& descomposicion) { descomposicion_ = descomposicion; } // Ver Descomposicion
+    inline void setReencadenamiento(int elite) { reencadenamiento_ = elite; } // Ver ReencadenamientoTrayectorias; 0 = sin reencadenamiento
+
     // Getters
     std::vector<std::shared_ptr<Tools>> getDato(const Tools& dato);
+    std::vector<Solucion> getSoluciones(const Tools& dato); // Soluciones de cada ejecución, en el orden de getDato
 
   private:
-    // Métodos para calcular el GRASP de las rutas de recolección
-    std::pair<Zona&, double> zonaMasCercana(const Recoleccion& vehiculo, const int numeroMejoresZonas); // Zona más cercana al vehículo
-    std::pair<Zona&, double> swtsMasCercana(const Recoleccion& vehiculo); // SWTS más cercana a la zona
-    int TiempoVolverDeposito(const Recoleccion& vehiculo, const int numeroMejoresZonas); // Tiempo que tarda en volver al depósito pasando por las zonas y la swts más cercanas
     // Atributos para cuántas zonas cercanas se van a considerar y el número de ejecuciones
     int numeroMejoresZonasCercanas_;
     int numeroEjecuciones_;
+    TipoSeleccion seleccion_ = TipoSeleccion::lrcCardinalidad;
+    double alfa_ = 0.2;
+    // Parámetros de ejecución: cada ejecución (LRC, ejecución) usa su propio generador, sembrado a partir
+    // de semilla_, para que el resultado no dependa del número de hilos ni del orden en que terminen
+    unsigned semilla_ = std::random_device{}();
+    int hilos_ = 1;
+    bool vecindarioParalelo_ = false;
+    double tiempoLimite_ = 0.0;
+    int memoRutas_ = 0;
+    int tramosExactos_ = 0;
+    ConfiguracionLNS lns_; // 0 iteraciones = sin ruina y recreación
+    bool busquedaLocal_ = true;
+    ConfiguracionDescomposicion descomposicion_; // Sin grupos = toda la instancia de una vez
+    int reencadenamiento_ = 0; // Mejores soluciones distintas entre las que se reencadenan trayectorias (élite)
     std::vector<double> distanciaSinMejoras;
     std::vector<double> distanciasConMejoras_;
     std::vector<std::pair<int, int>> mejoresZonasYEjecuciones_;
+    std::vector<Solucion> soluciones_; // Solución de cada elemento de datos_, para compararlas sin recorrer los vehículos
 };
 
-#endif
\ No newline at end of file
+#endif
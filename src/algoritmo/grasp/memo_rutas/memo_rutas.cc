@@ -0,0 +1,111 @@
+#include "memo_rutas.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Constructor de la memoria
+ * @param zonas Zonas de la instancia (Tools::zonas)
+ * @param capacidad Número máximo de rutas guardadas
+ * @throws std::invalid_argument si la capacidad es 0
+ */
+MemoRutas::MemoRutas(const vector<Zona>& zonas, size_t capacidad) : capacidad_(capacidad) {
+  if (capacidad == 0) throw invalid_argument("Error: La memoria de rutas debe poder guardar al menos una ruta");
+  indices_.reserve(zonas.size());
+  for (size_t i = 0; i < zonas.size(); i++) indices_.emplace(zonas[i].getId(), static_cast<int>(i));
+}
+
+/**
+ * @brief Método para obtener las paradas de una ruta como índices en Tools::zonas
+ * @param ruta Ruta de recolección
+ * @param resultado Vector en el que se dejan, en el orden de la ruta (se reutiliza entre llamadas)
+ * @return void
+ */
+void MemoRutas::paradas(const Recoleccion& ruta, vector<int32_t>& resultado) const {
+  resultado.clear();
+  resultado.reserve(ruta.getZonasVisitadas().size());
+  for (const Zona& zona : ruta.getZonasVisitadas()) resultado.push_back(indices_.at(zona.getId()));
+}
+
+/**
+ * @brief Método para obtener la clave de una ruta: sus paradas ordenadas por índice
+ * @param paradas Paradas de la ruta
+ * @return vector<int32_t> Clave de la ruta
+ */
+vector<int32_t> MemoRutas::clave(const vector<int32_t>& paradas) {
+  vector<int32_t> resultado(paradas);
+  sort(resultado.begin(), resultado.end());
+  return resultado;
+}
+
+/**
+ * @brief Método para buscar el mejor orden guardado de las paradas de una ruta. Si lo encuentra, pasa a
+ *        ser la ruta usada más recientemente.
+ * @param paradas Paradas de la ruta, en cualquier orden
+ * @param orden Vector en el que se deja el mejor orden guardado
+ * @param coste Distancia de la ruta en ese orden
+ * @return true si el conjunto de paradas estaba guardado, false en caso contrario
+ */
+bool MemoRutas::consultar(const vector<int32_t>& paradas, vector<int32_t>& orden, double& coste) {
+  const vector<int32_t> buscada = clave(paradas);
+  lock_guard<mutex> bloqueo(mutex_);
+  const auto encontrada = entradas_.find(buscada);
+  if (encontrada == entradas_.end()) {
+    estadisticas_.fallos++;
+    return false;
+  }
+  estadisticas_.aciertos++;
+  lista_.splice(lista_.begin(), lista_, encontrada->second);
+  orden = encontrada->second->orden;
+  coste = encontrada->second->coste;
+  return true;
+}
+
+/**
+ * @brief Método para guardar el orden de una ruta. Sustituye al guardado para el mismo conjunto de paradas
+ *        sólo si es más corto; si el conjunto es nuevo y no hay sitio, expulsa la ruta que hace más
+ *        tiempo que no se usa.
+ * @param paradas Paradas de la ruta, en su orden (factible)
+ * @param coste Distancia de la ruta
+ * @return void
+ */
+void MemoRutas::guardar(const vector<int32_t>& paradas, double coste) {
+  vector<int32_t> nueva = clave(paradas);
+  lock_guard<mutex> bloqueo(mutex_);
+  const auto encontrada = entradas_.find(nueva);
+  if (encontrada != entradas_.end()) {
+    Entrada& entrada = *encontrada->second;
+    if (coste < entrada.coste) {
+      entrada.orden = paradas;
+      entrada.coste = coste;
+    }
+    lista_.splice(lista_.begin(), lista_, encontrada->second);
+    return;
+  }
+  if (entradas_.size() == capacidad_) {
+    entradas_.erase(lista_.back().clave);
+    lista_.pop_back();
+    estadisticas_.expulsiones++;
+  }
+  lista_.push_front(Entrada{nueva, paradas, coste});
+  entradas_.emplace(std::move(nueva), lista_.begin());
+}
+
+/**
+ * @brief Método para obtener el número de rutas guardadas
+ * @return size_t Rutas guardadas
+ */
+size_t MemoRutas::tamano() const {
+  lock_guard<mutex> bloqueo(mutex_);
+  return entradas_.size();
+}
+
+/**
+ * @brief Método para obtener los contadores de la memoria
+ * @return Estadisticas Aciertos, fallos y expulsiones desde que se creó
+ */
+MemoRutas::Estadisticas MemoRutas::estadisticas() const {
+  lock_guard<mutex> bloqueo(mutex_);
+  return estadisticas_;
+}
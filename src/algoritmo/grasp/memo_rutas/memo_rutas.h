@@ -0,0 +1,59 @@
+/**
+ * @class Memoria de rutas de recolección para la búsqueda local, compartida por todas las ejecuciones de
+ *        GRASP sobre una instancia. Para cada conjunto de paradas (zonas de recolección, SWTS y depósito,
+ *        sin importar el orden) guarda el mejor orden que ha dejado la búsqueda local al terminar, que
+ *        es un óptimo local de swapIntra, reinsertIntra y twoOptIntra. Cuando otra ejecución llega a una
+ *        ruta con las mismas paradas, la mejora dentro de la ruta es una consulta. Tiene un número máximo
+ *        de rutas y expulsa la usada hace más tiempo (LRU). Se puede usar desde varios hilos a la vez.
+ */
+
+#ifndef C_MemoRutas_H
+#define C_MemoRutas_H
+
+#include "../../../vehiculo/recoleccion/recoleccion.h"
+#include "../../../solucion/solucion.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MemoRutas {
+  public:
+    struct Estadisticas {
+      uint64_t aciertos = 0; // Consultas de un conjunto de paradas que estaba guardado
+      uint64_t fallos = 0;
+      uint64_t expulsiones = 0; // Rutas descartadas por falta de sitio
+    };
+
+    MemoRutas(const std::vector<Zona>& zonas, size_t capacidad);
+
+    void paradas(const Recoleccion& ruta, std::vector<int32_t>& resultado) const; // Índice en Tools::zonas de cada parada
+    bool consultar(const std::vector<int32_t>& paradas, std::vector<int32_t>& orden, double& coste); // Mejor orden conocido
+    void guardar(const std::vector<int32_t>& paradas, double coste); // Se queda con él si es el mejor de su conjunto
+
+    // Getters
+    inline size_t capacidad() const { return capacidad_; }
+    size_t tamano() const;
+    Estadisticas estadisticas() const;
+
+  private:
+    struct Entrada {
+      std::vector<int32_t> clave; // Paradas ordenadas por índice
+      std::vector<int32_t> orden; // Paradas en el orden de la ruta
+      double coste;
+    };
+    using Lista = std::list<Entrada>;
+
+    static std::vector<int32_t> clave(const std::vector<int32_t>& paradas);
+
+    size_t capacidad_;
+    std::unordered_map<std::string, int> indices_; // Posición de cada zona en Tools::zonas, por identificador
+    mutable std::mutex mutex_;
+    Lista lista_; // De la usada más recientemente a la que hace más tiempo que no se usa
+    std::unordered_map<std::vector<int32_t>, Lista::iterator, Solucion::HashFirma> entradas_;
+    Estadisticas estadisticas_;
+};
+
+#endif
@@ -0,0 +1,321 @@
+#include "reencadenamiento_trayectorias.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+using namespace std;
+
+/**
+ * @brief Constructor: indexa las zonas de la instancia (O(n), una vez para todos los caminos)
+ * @param dato Instancia de las soluciones que se reencadenan
+ * @return ReencadenamientoTrayectorias
+ */
+ReencadenamientoTrayectorias::ReencadenamientoTrayectorias(const Tools& dato) : dato_(dato) {
+  tipo_.resize(dato.zonas.size());
+  for (size_t i = 0; i < dato.zonas.size(); i++) {
+    const Zona& zona = dato.zonas[i];
+    indiceDe_.emplace(zona.getId(), static_cast<int>(i));
+    tipo_[i] = zona.esSWTS() ? 1 : (zona.esDeposito() || zona.esDumpsite() ? 2 : 0);
+    if (tipo_[i] == 1) swts_.push_back(i);
+  }
+}
+
+/**
+ * @brief Método para recorrer el camino de una solución a otra. En cada paso se mueve, de las zonas que
+ *        no están en su ruta destino, la que menos distancia añade; si su ruta o la destino dejan de ser
+ *        factibles, se deshace y la zona no se vuelve a probar hasta que cambie alguna de las dos. El
+ *        camino termina cuando todas están en su ruta o ninguna cabe en la suya. Una solución del camino
+ *        es mejor que otra si tiene menos rutas o, con las mismas, menos distancia.
+ * @param vehiculos Rutas de la solución inicial; se dejan las de la mejor solución del camino
+ * @param guia Rutas de la solución guía (sólo se leen)
+ * @return true si alguna solución del camino mejora la inicial
+ * @throws std::runtime_error si alguna ruta visita una zona que no es de la instancia
+ */
+bool ReencadenamientoTrayectorias::recorrer(vector<Recoleccion>& vehiculos, const vector<Recoleccion>& guia) {
+  const auto inicio = chrono::steady_clock::now();
+  vehiculos_ = &vehiculos;
+  vector<Recoleccion> inicial = vehiculos;
+  cargarSolucion();
+  emparejar(guia);
+  const size_t rutasCamino = vehiculos.size(); // Con las rutas vacías nuevas
+  double distanciaMejor = distancia_;
+  int rutasMejor = rutas_;
+  size_t pasosMejor = 0;
+  hechos_.clear();
+  while (!pendientes_.empty()) {
+    evaluarPendientes();
+    size_t elegida = pendientes_.size();
+    for (size_t i = 0; i < pendientes_.size(); i++) {
+      const Movimiento& movimiento = movimiento_[pendientes_[i]];
+      if (movimiento.posicion == EvaluadorInsercion::kNinguna) continue;
+      if (elegida == pendientes_.size() || movimiento.delta < movimiento_[pendientes_[elegida]].delta) elegida = i;
+    }
+    if (elegida == pendientes_.size()) break; // Ninguna zona cabe en su ruta destino
+    const Movimiento movimiento = movimiento_[pendientes_[elegida]];
+    if (!aplicar(movimiento, true)) {
+      movimiento_[movimiento.zona].posicion = EvaluadorInsercion::kNinguna;
+      continue;
+    }
+    hechos_.push_back(movimiento);
+    pendientes_.erase(pendientes_.begin() + elegida);
+    if (rutas_ < rutasMejor || (rutas_ == rutasMejor && distancia_ < distanciaMejor - kTolerancia)) {
+      distanciaMejor = distancia_;
+      rutasMejor = rutas_;
+      pasosMejor = hechos_.size();
+    }
+  }
+  if (pasosMejor < hechos_.size()) {
+    // Se vuelve a la inicial y se rehacen los movimientos hasta la mejor solución del camino
+    vehiculos = std::move(inicial);
+    cargarSolucion();
+    while (vehiculos.size() < rutasCamino) anadirRutaVacia();
+    for (size_t i = 0; i < pasosMejor; i++) aplicar(hechos_[i], false);
+  }
+  // Las rutas que se han quedado sin zonas de recolección sobran
+  erase_if(vehiculos, [](const Recoleccion& vehiculo) {
+    return all_of(vehiculo.getZonasVisitadas().begin(), vehiculo.getZonasVisitadas().end(), [](const Zona& zona) { return zona.esSWTS() || zona.esDeposito(); });
+  });
+  if (metricas_ != nullptr) {
+    metricas_->reencadenamiento.trayectorias++;
+    metricas_->reencadenamiento.pasos += hechos_.size();
+    metricas_->reencadenamiento.mejoras += pasosMejor > 0;
+    metricas_->reencadenamiento.tiempo += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+  }
+  return pasosMejor > 0;
+}
+
+/**
+ * @brief Método para anotar el índice de cada parada de los vehículos, la ruta de cada zona y el coste de
+ *        cada ruta (O(n), una vez por camino)
+ * @return void
+ * @throws std::runtime_error si alguna ruta visita una zona que no es de la instancia
+ */
+void ReencadenamientoTrayectorias::cargarSolucion() {
+  const vector<Recoleccion>& vehiculos = *vehiculos_;
+  indices_.assign(vehiculos.size(), {});
+  costes_.assign(vehiculos.size(), 0.0);
+  zonasEnRuta_.assign(vehiculos.size(), 0);
+  rutaDe_.assign(dato_.zonas.size(), -1);
+  distancia_ = 0.0;
+  rutas_ = 0;
+  for (size_t r = 0; r < vehiculos.size(); r++) {
+    for (const Zona& parada : vehiculos[r].getZonasVisitadas()) {
+      const auto encontrada = indiceDe_.find(parada.getId());
+      if (encontrada == indiceDe_.end()) throw runtime_error("ReencadenamientoTrayectorias: la ruta visita una zona que no es de la instancia (" + parada.getId() + ")");
+      const int zona = encontrada->second;
+      indices_[r].push_back(zona);
+      if (!esRecoleccion(zona)) continue;
+      rutaDe_[zona] = static_cast<int>(r);
+      zonasEnRuta_[r]++;
+    }
+    costes_[r] = comprobador_.calcularCostoRuta(vehiculos[r]);
+    distancia_ += costes_[r];
+    if (zonasEnRuta_[r] > 0) rutas_++;
+  }
+}
+
+/**
+ * @brief Método para emparejar las rutas de la guía con las de la solución actual y anotar la ruta destino
+ *        de cada zona. Las parejas se eligen de más a menos zonas en común (sin repetir ninguna ruta); a
+ *        cada ruta de la guía que se queda sin pareja le corresponde una ruta vacía nueva.
+ * @param guia Rutas de la solución guía
+ * @return void
+ * @throws std::runtime_error si alguna ruta de la guía visita una zona que no es de la instancia
+ */
+void ReencadenamientoTrayectorias::emparejar(const vector<Recoleccion>& guia) {
+  vector<int> rutaGuia(dato_.zonas.size(), -1);
+  for (size_t g = 0; g < guia.size(); g++) {
+    for (const Zona& parada : guia[g].getZonasVisitadas()) {
+      const auto encontrada = indiceDe_.find(parada.getId());
+      if (encontrada == indiceDe_.end()) throw runtime_error("ReencadenamientoTrayectorias: la guía visita una zona que no es de la instancia (" + parada.getId() + ")");
+      if (esRecoleccion(encontrada->second)) rutaGuia[encontrada->second] = static_cast<int>(g);
+    }
+  }
+  // Zonas en común de cada pareja (ruta actual, ruta de la guía), de más a menos
+  vector<pair<int, int>> parejas;
+  for (size_t zona = 0; zona < dato_.zonas.size(); zona++) {
+    if (rutaDe_[zona] >= 0 && rutaGuia[zona] >= 0) parejas.emplace_back(rutaDe_[zona], rutaGuia[zona]);
+  }
+  sort(parejas.begin(), parejas.end());
+  vector<tuple<int, int, int>> comunes; // (-zonas en común, ruta actual, ruta de la guía)
+  for (size_t i = 0; i < parejas.size();) {
+    size_t j = i;
+    while (j < parejas.size() && parejas[j] == parejas[i]) j++;
+    comunes.emplace_back(-static_cast<int>(j - i), parejas[i].first, parejas[i].second);
+    i = j;
+  }
+  sort(comunes.begin(), comunes.end());
+  vector<int> pareja(guia.size(), -1);
+  vector<char> emparejada(vehiculos_->size(), 0);
+  for (const auto& [menosComunes, ruta, rutaDeGuia] : comunes) {
+    if (pareja[rutaDeGuia] >= 0 || emparejada[ruta]) continue;
+    pareja[rutaDeGuia] = ruta;
+    emparejada[ruta] = 1;
+  }
+  destino_.assign(dato_.zonas.size(), -1);
+  pendientes_.clear();
+  for (size_t zona = 0; zona < dato_.zonas.size(); zona++) {
+    if (rutaDe_[zona] < 0 || rutaGuia[zona] < 0) continue;
+    int& ruta = pareja[rutaGuia[zona]];
+    if (ruta < 0) ruta = static_cast<int>(anadirRutaVacia());
+    destino_[zona] = ruta;
+    if (rutaDe_[zona] != ruta) pendientes_.push_back(static_cast<int>(zona));
+  }
+  movimiento_.resize(dato_.zonas.size(), Movimiento{0});
+  evaluada_.assign(dato_.zonas.size(), 0);
+}
+
+/**
+ * @brief Método para añadir una ruta vacía (depósito, depósito) al final de la solución actual
+ * @return size_t Índice de la ruta
+ */
+size_t ReencadenamientoTrayectorias::anadirRutaVacia() {
+  const Zona& deposito = dato_.zonas[dato_.indiceDeposito];
+  Recoleccion vehiculo(dato_.capacidadRecoleccion, dato_.velocidad, deposito, dato_.duracionRecoleccion);
+  vehiculo.getZonasVisitadas().push_back(deposito);
+  vehiculo.getZonasVisitadas().push_back(deposito);
+  vehiculos_->push_back(std::move(vehiculo));
+  indices_.push_back({dato_.indiceDeposito, dato_.indiceDeposito});
+  costes_.push_back(0.0);
+  zonasEnRuta_.push_back(0);
+  return vehiculos_->size() - 1;
+}
+
+/**
+ * @brief Método para calcular el mejor movimiento de las zonas pendientes que no lo tienen al día. Se
+ *        agrupan por ruta destino, para cargar cada una una vez. Sólo se consideran las posiciones
+ *        anteriores a la última SWTS de la ruta, para que la zona se descargue antes de volver al
+ *        depósito, y la de un tramo nuevo con su SWTS más cercana justo detrás de ella.
+ * @return void
+ */
+void ReencadenamientoTrayectorias::evaluarPendientes() {
+  vector<pair<int, int>> porEvaluar; // (ruta destino, zona)
+  for (int zona : pendientes_) {
+    if (!evaluada_[zona]) porEvaluar.emplace_back(destino_[zona], zona);
+  }
+  sort(porEvaluar.begin(), porEvaluar.end());
+  int cargada = -1;
+  size_t hasta = 0;
+  for (const auto& [ruta, zona] : porEvaluar) {
+    const Recoleccion& destino = (*vehiculos_)[ruta];
+    if (ruta != cargada) {
+      insercion_.cargar(destino);
+      hasta = ultimaSWTS(ruta);
+      cargada = ruta;
+    }
+    const size_t origen = rutaDe_[zona];
+    const size_t p = find(indices_[origen].begin(), indices_[origen].end(), zona) - indices_[origen].begin();
+    const Zona& parada = (*vehiculos_)[origen].getZonasVisitadas()[p];
+    Movimiento& movimiento = movimiento_[zona];
+    movimiento = Movimiento{zona};
+    if (hasta > 0) {
+      movimiento.posicion = insercion_.mejorPosicion(parada, hasta);
+      if (movimiento.posicion != EvaluadorInsercion::kNinguna) movimiento.delta = insercion_.delta(movimiento.posicion);
+    }
+    const int swts = swtsMasCercana(zona);
+    const double tramo = insercion_.tramoNuevo(destino, hasta, parada, dato_.zonas[swts]);
+    if (tramo < INFINITY && (movimiento.posicion == EvaluadorInsercion::kNinguna || tramo < movimiento.delta)) {
+      movimiento.posicion = hasta + 1;
+      movimiento.delta = tramo;
+      movimiento.swts = swts;
+    }
+    movimiento.delta += deltaRetirada(origen, p);
+    evaluada_[zona] = 1;
+  }
+}
+
+/**
+ * @brief Método para calcular la distancia que añade quitar una parada de su ruta (negativa). Si su tramo
+ *        se queda vacío, se quita también la SWTS que lo cierra, como al aplicar el movimiento.
+ * @param ruta Índice de la ruta
+ * @param posicion Posición de la parada (una zona de recolección) en la ruta
+ * @return double Distancia añadida
+ */
+double ReencadenamientoTrayectorias::deltaRetirada(size_t ruta, size_t posicion) const {
+  const vector<int>& indices = indices_[ruta];
+  const Zona& anterior = dato_.zonas[indices[posicion - 1]];
+  const Zona& zona = dato_.zonas[indices[posicion]];
+  const Zona& siguiente = dato_.zonas[indices[posicion + 1]];
+  double delta = anterior.getDistancia(siguiente) - anterior.getDistancia(zona) - zona.getDistancia(siguiente);
+  if (tipo_[indices[posicion + 1]] == 1 && !esRecoleccion(indices[posicion - 1])) {
+    const Zona& despues = dato_.zonas[indices[posicion + 2]];
+    delta += anterior.getDistancia(despues) - anterior.getDistancia(siguiente) - siguiente.getDistancia(despues);
+  }
+  return delta;
+}
+
+/**
+ * @brief Método para aplicar un movimiento: la zona se quita de su ruta (con la SWTS de su tramo, si se
+ *        queda vacío) y se inserta en la destino. Se marcan para recalcular los movimientos de las zonas
+ *        cuya ruta o ruta destino es una de las dos.
+ * @param movimiento Zona, posición en la ruta destino y SWTS del tramo nuevo, si lo abre
+ * @param comprobar Si hay que comprobar que las dos rutas siguen siendo factibles
+ * @return true si se ha aplicado, false si no es factible (se deja la solución como estaba)
+ */
+bool ReencadenamientoTrayectorias::aplicar(const Movimiento& movimiento, bool comprobar) {
+  vector<Recoleccion>& vehiculos = *vehiculos_;
+  const int zona = movimiento.zona;
+  const size_t origen = rutaDe_[zona];
+  const size_t destino = destino_[zona];
+  const Recoleccion vehiculoOrigen = vehiculos[origen], vehiculoDestino = vehiculos[destino];
+  const vector<int> indicesOrigen = indices_[origen], indicesDestino = indices_[destino];
+  vector<int>& indices = indices_[origen];
+  pmr::vector<Zona>& paradas = vehiculos[origen].getZonasVisitadas();
+  const size_t p = find(indices.begin(), indices.end(), zona) - indices.begin();
+  const Zona parada = paradas[p];
+  indices.erase(indices.begin() + p);
+  paradas.erase(paradas.begin() + p);
+  if (tipo_[indices[p]] == 1 && !esRecoleccion(indices[p - 1])) {
+    indices.erase(indices.begin() + p);
+    paradas.erase(paradas.begin() + p);
+  }
+  pmr::vector<Zona>& paradasDestino = vehiculos[destino].getZonasVisitadas();
+  if (movimiento.swts >= 0) {
+    // Tramo nuevo: la SWTS va detrás de la zona
+    paradasDestino.insert(paradasDestino.begin() + movimiento.posicion, dato_.zonas[movimiento.swts]);
+    indices_[destino].insert(indices_[destino].begin() + movimiento.posicion, movimiento.swts);
+  }
+  paradasDestino.insert(paradasDestino.begin() + movimiento.posicion, parada);
+  indices_[destino].insert(indices_[destino].begin() + movimiento.posicion, zona);
+  if (comprobar && !(comprobador_.esFactible(vehiculos[origen]) && comprobador_.esFactible(vehiculos[destino]))) {
+    vehiculos[origen] = vehiculoOrigen;
+    vehiculos[destino] = vehiculoDestino;
+    indices_[origen] = indicesOrigen;
+    indices_[destino] = indicesDestino;
+    return false;
+  }
+  rutaDe_[zona] = static_cast<int>(destino);
+  rutas_ -= (zonasEnRuta_[origen] > 0) + (zonasEnRuta_[destino] > 0);
+  zonasEnRuta_[origen]--;
+  zonasEnRuta_[destino]++;
+  rutas_ += (zonasEnRuta_[origen] > 0) + (zonasEnRuta_[destino] > 0);
+  for (size_t ruta : {origen, destino}) {
+    distancia_ -= costes_[ruta];
+    costes_[ruta] = comprobador_.calcularCostoRuta(vehiculos[ruta]);
+    distancia_ += costes_[ruta];
+  }
+  for (int otra : pendientes_) {
+    const size_t ruta = rutaDe_[otra], rutaDestino = destino_[otra];
+    if (ruta == origen || ruta == destino || rutaDestino == origen || rutaDestino == destino) evaluada_[otra] = 0;
+  }
+  return true;
+}
+
+size_t ReencadenamientoTrayectorias::ultimaSWTS(size_t ruta) const {
+  const vector<int>& indices = indices_[ruta];
+  for (size_t p = indices.size(); p-- > 0;) {
+    if (tipo_[indices[p]] == 1) return p;
+  }
+  return 0;
+}
+
+int ReencadenamientoTrayectorias::swtsMasCercana(int zona) const {
+  int mejor = swts_.front();
+  for (int swts : swts_) {
+    if (dato_.zonas[zona].getDistancia(dato_.zonas[swts]) < dato_.zonas[zona].getDistancia(dato_.zonas[mejor])) mejor = swts;
+  }
+  return mejor;
+}
@@ -0,0 +1,83 @@
+/**
+ * @class Reencadenamiento de trayectorias (path relinking) entre dos soluciones de recolección: se parte
+ *        de una (la inicial) y se va hacia la otra (la guía) moviendo cada vez una zona de recolección a
+ *        la ruta que le corresponde en la guía, hasta que todas están en su ruta. Cada ruta de la guía
+ *        se empareja con la ruta inicial con la que comparte más zonas (o con una ruta vacía nueva), y en
+ *        cada paso se mueve la zona cuyo cambio de ruta añade menos distancia, insertada donde menos
+ *        añade (en un tramo entre SWTS o en un tramo nuevo al final de la ruta). Los costes de los
+ *        movimientos se guardan y sólo se recalculan los de las zonas cuyas rutas cambian. Las
+ *        soluciones intermedias no se copian: se anotan los movimientos y, al terminar, se rehacen desde
+ *        la inicial hasta la mejor del camino.
+ */
+
+#ifndef C_ReencadenamientoTrayectorias_H
+#define C_ReencadenamientoTrayectorias_H
+
+#include "../../../tools/tools.h"
+#include "../../insercion/insercion.h"
+#include "../busqueda_local/busqueda_local.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ReencadenamientoTrayectorias {
+  public:
+    static constexpr double kTolerancia = 1e-9; // Diferencia de distancia que se considera un empate
+
+    explicit ReencadenamientoTrayectorias(const Tools& dato);
+
+    // Recorre el camino de "vehiculos" a "guia"; deja en los vehículos la mejor solución del camino (la
+    // inicial si ninguna la mejora), sin las rutas que se quedan vacías
+    bool recorrer(std::vector<Recoleccion>& vehiculos, const std::vector<Recoleccion>& guia);
+
+    // Setters
+    void setMetricas(Metricas& metricas) { metricas_ = &metricas; comprobador_.setMetricas(metricas); }
+
+  private:
+    // Cambio de una zona a su ruta destino: en la posición "posicion" de un tramo o, con swts >= 0, en
+    // un tramo nuevo (la zona y la SWTS) detrás de la última SWTS
+    struct Movimiento {
+      int zona; // Índice en Tools::zonas
+      size_t posicion = EvaluadorInsercion::kNinguna; // kNinguna si no cabe en la ruta destino
+      int swts = -1;
+      double delta = 0.0; // Distancia añadida al quitar la zona de su ruta y ponerla en la destino
+    };
+
+    void cargarSolucion();
+    void emparejar(const std::vector<Recoleccion>& guia);
+    size_t anadirRutaVacia();
+    void evaluarPendientes();
+    double deltaRetirada(size_t ruta, size_t posicion) const; // Distancia añadida al quitar la parada "posicion" de la ruta
+    bool aplicar(const Movimiento& movimiento, bool comprobar);
+    size_t ultimaSWTS(size_t ruta) const; // Posición de la última SWTS de la ruta (0 si no tiene)
+    int swtsMasCercana(int zona) const;
+    inline bool esRecoleccion(int zona) const { return tipo_[zona] == 0; }
+
+    const Tools& dato_;
+    std::vector<Recoleccion>* vehiculos_ = nullptr;
+    Metricas* metricas_ = nullptr;
+    BusquedaLocal comprobador_; // esFactible y calcularCostoRuta, con las mismas reglas que la búsqueda local
+    EvaluadorInsercion insercion_;
+
+    // Datos fijos de la instancia
+    std::unordered_map<std::string, int> indiceDe_; // Índice en Tools::zonas de cada identificador
+    std::vector<char> tipo_; // 0 = recolección, 1 = SWTS, 2 = depósito o vertedero
+    std::vector<int> swts_;
+
+    // Solución actual
+    std::vector<std::vector<int>> indices_; // Índice en Tools::zonas de cada parada de cada ruta
+    std::vector<double> costes_; // Distancia de cada ruta
+    std::vector<int> zonasEnRuta_; // Zonas de recolección de cada ruta (0 = vacía)
+    std::vector<int> rutaDe_; // Ruta de cada zona de recolección
+    double distancia_ = 0.0;
+    int rutas_ = 0; // Rutas no vacías
+
+    // Estado del camino
+    std::vector<int> destino_; // Ruta en la que acaba cada zona de recolección (-1 si la guía no la visita)
+    std::vector<int> pendientes_; // Zonas que todavía no están en su ruta destino
+    std::vector<Movimiento> movimiento_; // Mejor movimiento de cada zona pendiente, por índice en Tools::zonas
+    std::vector<char> evaluada_; // Si movimiento_ está al día
+    std::vector<Movimiento> hechos_; // Movimientos aplicados, en orden
+};
+
+#endif
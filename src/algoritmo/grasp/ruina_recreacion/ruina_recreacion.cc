@@ -0,0 +1,364 @@
+#include "ruina_recreacion.h"
+#include "../busqueda_local/busqueda_local.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Constructor: indexa las zonas de la instancia (O(n), una vez por búsqueda)
+ * @param dato Instancia cuyas rutas se van a mejorar
+ * @param configuracion Iteraciones, zonas que se quitan como mucho y criterio de aceptación
+ * @param generador Generador aleatorio de la ejecución
+ * @throws std::invalid_argument si maxRuina es menor que 1
+ */
+RuinaRecreacion::RuinaRecreacion(const Tools& dato, const ConfiguracionLNS& configuracion, mt19937& generador)
+    : dato_(dato), configuracion_(configuracion), generador_(generador), solucion_(dato) {
+  if (configuracion_.maxRuina < 1) throw invalid_argument("Error: La ruina y recreación debe quitar al menos una zona por iteración");
+  vector<IndiceEspacial::Punto> puntos;
+  for (size_t i = 0; i < dato.zonas.size(); i++) {
+    const Zona& zona = dato.zonas[i];
+    if (!solucion_.esRecoleccion(i)) continue;
+    recoleccion_.push_back(i);
+    puntos.push_back({double(zona.getPosicion().first), double(zona.getPosicion().second), static_cast<int>(i)});
+  }
+  cercanas_ = IndiceEspacial(puntos);
+}
+
+/**
+ * @brief Método para aplicar las iteraciones de ruina y recreación. Con el criterio "mejora" la solución
+ *        actual es siempre la mejor; con los demás se guarda una copia de la mejor cada vez que cambia y
+ *        se devuelve esa al terminar. Una solución con más rutas que la actual no se acepta nunca, y una
+ *        con menos, siempre.
+ * @return true si se ha mejorado la solución (menos rutas o, con las mismas, menos distancia)
+ */
+bool RuinaRecreacion::mejorar() {
+  const auto inicio = chrono::steady_clock::now();
+  vector<Recoleccion>& vehiculos = *vehiculos_;
+  cargarSolucion();
+  const double distanciaInicial = solucion_.distancia;
+  const int rutasIniciales = solucion_.rutas;
+  distanciaMejor_ = solucion_.distancia;
+  rutasMejor_ = solucion_.rutas;
+  // La temperatura del recocido es relativa a la distancia media de un arco de la solución inicial
+  temperaturaInicial_ = configuracion_.parametro * solucion_.distancia / max<size_t>(recoleccion_.size() + vehiculos.size(), 1);
+  const bool guardarMejor = configuracion_.aceptacion != CriterioAceptacion::mejora;
+  vector<Recoleccion> mejor;
+  if (guardarMejor) mejor = vehiculos;
+  bool actualEsMejor = true;
+  const int maxRuina = min<int>(configuracion_.maxRuina, recoleccion_.size());
+  for (int iteracion = 0; iteracion < configuracion_.iteraciones && maxRuina > 0 && !vehiculos.empty(); iteracion++) {
+    const size_t rutasAntes = vehiculos.size();
+    const TipoRuina tipo = static_cast<TipoRuina>(uniform_int_distribution<int>(0, 2)(generador_));
+    arruinar(tipo, uniform_int_distribution<int>(1, maxRuina)(generador_));
+    recrear();
+    // Sólo cambian las rutas copiadas y las nuevas
+    double distancia = solucion_.distancia;
+    int rutas = solucion_.rutas;
+    bool factible = true;
+    auto actualizar = [&](size_t r) {
+      solucion_.costes[r] = BusquedaLocal::calcularCostoRuta(vehiculos[r], metricas_);
+      distancia += solucion_.costes[r];
+      rutas += solucion_.zonasEnRuta[r] > 0;
+      factible = factible && BusquedaLocal::esFactible(vehiculos[r], metricas_);
+    };
+    for (const Copia& copia : copias_) {
+      distancia -= copia.coste;
+      rutas -= copia.zonas > 0;
+      actualizar(copia.ruta);
+    }
+    for (size_t r = rutasAntes; r < vehiculos.size(); r++) actualizar(r);
+    if (metricas_ != nullptr) metricas_->lns.iteraciones++;
+    if (!factible || !aceptar(distancia, rutas, iteracion)) {
+      deshacer(rutasAntes);
+      continue;
+    }
+    if (metricas_ != nullptr) metricas_->lns.aceptadas++;
+    solucion_.distancia = distancia;
+    solucion_.rutas = rutas;
+    for (const Copia& copia : copias_) copiada_[copia.ruta] = 0;
+    for (size_t r = rutasAntes; r < vehiculos.size(); r++) copiada_[r] = 0;
+    copias_.clear();
+    actualEsMejor = rutas < rutasMejor_ || (rutas == rutasMejor_ && distancia < distanciaMejor_ - kTolerancia);
+    if (actualEsMejor) {
+      if (metricas_ != nullptr) metricas_->lns.mejoras++;
+      distanciaMejor_ = distancia;
+      rutasMejor_ = rutas;
+      if (guardarMejor) mejor = vehiculos;
+    }
+  }
+  if (guardarMejor && !actualEsMejor) vehiculos = std::move(mejor);
+  SolucionIndexada::quitarRutasVacias(vehiculos);
+  if (metricas_ != nullptr) metricas_->lns.tiempo += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+  return rutasMejor_ < rutasIniciales || (rutasMejor_ == rutasIniciales && distanciaMejor_ < distanciaInicial - kTolerancia);
+}
+
+/**
+ * @brief Método para anotar el índice de cada parada de los vehículos, la ruta de cada zona y el coste de
+ *        cada ruta (O(n), una vez por búsqueda)
+ * @return void
+ * @throws std::runtime_error si alguna ruta visita una zona que no es de la instancia
+ */
+void RuinaRecreacion::cargarSolucion() {
+  solucion_.cargar(*vehiculos_, metricas_);
+  copiada_.assign(vehiculos_->size(), 0);
+}
+
+/**
+ * @brief Método para quitar zonas de la solución
+ * @param tipo radial: una zona al azar y sus más cercanas; aleatoria: zonas al azar; ruta: zonas de
+ *        recolección consecutivas de la ruta de una zona al azar (toda la ruta si tiene pocas)
+ * @param cantidad Zonas que se quitan (menos con la ruina por ruta si la ruta no tiene tantas)
+ * @return void
+ */
+void RuinaRecreacion::arruinar(TipoRuina tipo, int cantidad) {
+  retiradas_.clear();
+  uniform_int_distribution<size_t> azar(0, recoleccion_.size() - 1);
+  const int semilla = recoleccion_[azar(generador_)];
+  switch (tipo) {
+    case TipoRuina::radial: {
+      const Zona& centro = dato_.zonas[semilla];
+      cercanas_.masCercanos(centro.getPosicion().first, centro.getPosicion().second, cantidad, lista_);
+      for (const auto& [distancia, zona] : lista_) retirar(zona);
+      break;
+    }
+    case TipoRuina::aleatoria: {
+      retirar(semilla);
+      while (static_cast<int>(retiradas_.size()) < cantidad) {
+        const int zona = recoleccion_[azar(generador_)];
+        if (solucion_.rutaDe[zona] >= 0) retirar(zona);
+      }
+      break;
+    }
+    case TipoRuina::ruta: {
+      trozo_.clear();
+      for (int zona : solucion_.indices[solucion_.rutaDe[semilla]]) {
+        if (solucion_.esRecoleccion(zona)) trozo_.push_back(zona);
+      }
+      const int longitud = min<int>(cantidad, trozo_.size());
+      const int posicion = find(trozo_.begin(), trozo_.end(), semilla) - trozo_.begin();
+      // Un trozo de "longitud" zonas que contiene a la semilla
+      const int desde = uniform_int_distribution<int>(max(0, posicion - longitud + 1), min(posicion, static_cast<int>(trozo_.size()) - longitud))(generador_);
+      for (int i = desde; i < desde + longitud; i++) retirar(trozo_[i]);
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Método para quitar una zona de su ruta. Si su tramo se queda vacío, se quita también la SWTS que
+ *        lo cierra: ir a descargar sin carga sólo añade distancia, y el tramo siguiente lleva la misma carga.
+ * @param zona Índice en Tools::zonas de la zona
+ * @return void
+ */
+void RuinaRecreacion::retirar(int zona) {
+  const size_t r = solucion_.rutaDe[zona];
+  guardarCopia(r);
+  const vector<int>& indices = solucion_.indices[r];
+  const size_t p = find(indices.begin(), indices.end(), zona) - indices.begin();
+  retiradas_.push_back(Retirada{zona, r, solucion_.quitarParada((*vehiculos_)[r], r, p), {}});
+  solucion_.rutaDe[zona] = -1;
+  solucion_.zonasEnRuta[r]--;
+}
+
+/**
+ * @brief Método para volver a insertar las zonas quitadas. Las rutas candidatas de cada zona son la suya
+ *        y las de sus kVecinas zonas más cercanas; la mejor inserción en cada una se guarda y sólo se
+ *        vuelve a calcular en la ruta en la que se acaba de insertar. En cada paso se inserta la zona
+ *        que menos distancia añade; si ninguna cabe en ninguna candidata, la primera pendiente abre una
+ *        ruta nueva (depósito, zona, SWTS más cercana, depósito).
+ * @return void
+ */
+void RuinaRecreacion::recrear() {
+  rutasCandidatas_.clear();
+  for (Retirada& retirada : retiradas_) {
+    const Zona& zona = dato_.zonas[retirada.zona];
+    cercanas_.masCercanos(zona.getPosicion().first, zona.getPosicion().second, kVecinas, lista_, retirada.zona);
+    auto anadir = [&](int ruta) {
+      if (ruta < 0) return; // Vecina también retirada
+      for (const Insercion& insercion : retirada.candidatas) {
+        if (insercion.ruta == static_cast<size_t>(ruta)) return;
+      }
+      retirada.candidatas.push_back(Insercion{static_cast<size_t>(ruta)});
+      rutasCandidatas_.push_back(ruta);
+    };
+    anadir(static_cast<int>(retirada.origen));
+    for (const auto& [distancia, vecina] : lista_) anadir(solucion_.rutaDe[vecina]);
+  }
+  // Cada ruta candidata se carga una vez para todas las zonas que la tienen
+  sort(rutasCandidatas_.begin(), rutasCandidatas_.end());
+  rutasCandidatas_.erase(unique(rutasCandidatas_.begin(), rutasCandidatas_.end()), rutasCandidatas_.end());
+  for (size_t ruta : rutasCandidatas_) evaluarRuta(ruta);
+  pendientes_.resize(retiradas_.size());
+  for (size_t i = 0; i < retiradas_.size(); i++) pendientes_[i] = i;
+  while (!pendientes_.empty()) {
+    size_t elegida = 0;
+    const Insercion* mejor = nullptr;
+    for (size_t i = 0; i < pendientes_.size(); i++) {
+      for (const Insercion& insercion : retiradas_[pendientes_[i]].candidatas) {
+        if (insercion.posicion == EvaluadorInsercion::kNinguna) continue;
+        if (mejor == nullptr || insercion.delta < mejor->delta) {
+          mejor = &insercion;
+          elegida = i;
+        }
+      }
+    }
+    const size_t retirada = pendientes_[elegida];
+    pendientes_.erase(pendientes_.begin() + elegida);
+    if (mejor == nullptr) abrirRuta(retirada);
+    else insertar(retirada, *mejor);
+  }
+}
+
+/**
+ * @brief Método para insertar una zona quitada y recalcular sus inserciones en esa ruta para las demás
+ * @param retirada Posición en retiradas_ de la zona
+ * @param insercion Ruta y posición en la que se inserta (con la SWTS del tramo nuevo, si lo abre)
+ * @return void
+ */
+void RuinaRecreacion::insertar(size_t retirada, const Insercion& insercion) {
+  const size_t ruta = insercion.ruta;
+  Retirada& zona = retiradas_[retirada];
+  guardarCopia(ruta);
+  solucion_.ponerParada((*vehiculos_)[ruta], ruta, insercion.posicion, zona.parada, zona.zona, insercion.swts);
+  solucion_.rutaDe[zona.zona] = static_cast<int>(ruta);
+  solucion_.zonasEnRuta[ruta]++;
+  zona.insertada = true;
+  evaluarRuta(ruta);
+}
+
+/**
+ * @brief Método para abrir una ruta nueva con una zona quitada que no cabe en ninguna de sus candidatas,
+ *        construida como la haría el Constructor. Pasa a ser candidata de las zonas que quedan.
+ * @param retirada Posición en retiradas_ de la zona
+ * @return void
+ */
+void RuinaRecreacion::abrirRuta(size_t retirada) {
+  Retirada& zona = retiradas_[retirada];
+  const Zona& deposito = dato_.zonas[dato_.indiceDeposito];
+  const int swts = solucion_.swtsMasCercana(zona.zona);
+  Zona parada = zona.parada;
+  Zona estacion = dato_.zonas[swts];
+  Recoleccion vehiculo(dato_.capacidadRecoleccion, dato_.velocidad, deposito, dato_.duracionRecoleccion);
+  vehiculo.moverVehiculo(parada, deposito.getDistancia(parada));
+  vehiculo.vaciarZona(parada);
+  vehiculo.moverVehiculo(estacion, parada.getDistancia(estacion));
+  vehiculo.vaciarVehiculo(estacion);
+  vehiculo.volverAlInicio();
+  const size_t ruta = vehiculos_->size();
+  vehiculos_->push_back(std::move(vehiculo));
+  solucion_.anadirRuta({dato_.indiceDeposito, zona.zona, swts, dato_.indiceDeposito}, 1);
+  copiada_.push_back(1); // Al deshacer se quita entera
+  solucion_.rutaDe[zona.zona] = static_cast<int>(ruta);
+  zona.insertada = true;
+  for (Retirada& otra : retiradas_) {
+    if (!otra.insertada) otra.candidatas.push_back(Insercion{ruta});
+  }
+  evaluarRuta(ruta);
+}
+
+/**
+ * @brief Método para calcular la mejor inserción en una ruta de las zonas pendientes que la tienen como
+ *        candidata. Sólo se consideran las posiciones anteriores a la última SWTS, para que la zona se
+ *        descargue antes de volver al depósito, y la de un tramo nuevo justo detrás de ella.
+ * @param ruta Índice de la ruta
+ * @return void
+ */
+void RuinaRecreacion::evaluarRuta(size_t ruta) {
+  bool cargada = false;
+  size_t hasta = 0;
+  for (Retirada& retirada : retiradas_) {
+    if (retirada.insertada) continue;
+    for (Insercion& insercion : retirada.candidatas) {
+      if (insercion.ruta != ruta) continue;
+      if (!cargada) {
+        insercion_.cargar((*vehiculos_)[ruta]);
+        hasta = solucion_.ultimaSWTS(ruta);
+        cargada = true;
+      }
+      insercion.posicion = hasta > 0 ? insercion_.mejorPosicion(retirada.parada, hasta) : EvaluadorInsercion::kNinguna;
+      insercion.delta = insercion.posicion != EvaluadorInsercion::kNinguna ? insercion_.delta(insercion.posicion) : 0.0;
+      insercion.swts = -1;
+      if (hasta > 0) evaluarTramoNuevo(ruta, hasta, retirada, insercion);
+    }
+  }
+}
+
+/**
+ * @brief Método para evaluar un tramo nuevo con la zona y su SWTS más cercana justo detrás de la última
+ *        SWTS de la ruta cargada en insercion_. Se queda con él si añade menos distancia que la inserción
+ *        de "insercion".
+ * @param ruta Índice de la ruta
+ * @param ultima Posición de la última SWTS de la ruta
+ * @param retirada Zona que se inserta
+ * @param insercion Mejor inserción en un tramo de la ruta, que se actualiza
+ * @return void
+ */
+void RuinaRecreacion::evaluarTramoNuevo(size_t ruta, size_t ultima, const Retirada& retirada, Insercion& insercion) const {
+  const int swts = solucion_.swtsMasCercana(retirada.zona);
+  const double delta = insercion_.tramoNuevo((*vehiculos_)[ruta], ultima, retirada.parada, dato_.zonas[swts]);
+  if (!(delta < INFINITY) || (insercion.posicion != EvaluadorInsercion::kNinguna && !(delta < insercion.delta))) return;
+  insercion.posicion = ultima + 1;
+  insercion.delta = delta;
+  insercion.swts = swts;
+}
+
+/**
+ * @brief Método para guardar el estado de una ruta antes de modificarla por primera vez en la iteración
+ * @param ruta Índice de la ruta
+ * @return void
+ */
+void RuinaRecreacion::guardarCopia(size_t ruta) {
+  if (copiada_[ruta]) return;
+  copiada_[ruta] = 1;
+  copias_.push_back(Copia{ruta, (*vehiculos_)[ruta], solucion_.indices[ruta], solucion_.costes[ruta], solucion_.zonasEnRuta[ruta]});
+}
+
+/**
+ * @brief Método para deshacer la iteración: se quitan las rutas nuevas y se restauran las copiadas
+ * @param rutasAntes Número de rutas antes de la iteración
+ * @return void
+ */
+void RuinaRecreacion::deshacer(size_t rutasAntes) {
+  vehiculos_->erase(vehiculos_->begin() + rutasAntes, vehiculos_->end());
+  solucion_.indices.resize(rutasAntes);
+  solucion_.costes.resize(rutasAntes);
+  solucion_.zonasEnRuta.resize(rutasAntes);
+  copiada_.resize(rutasAntes);
+  for (Copia& copia : copias_) {
+    (*vehiculos_)[copia.ruta] = std::move(copia.vehiculo);
+    solucion_.indices[copia.ruta] = std::move(copia.indices);
+    solucion_.costes[copia.ruta] = copia.coste;
+    solucion_.zonasEnRuta[copia.ruta] = copia.zonas;
+    copiada_[copia.ruta] = 0;
+    for (int zona : solucion_.indices[copia.ruta]) {
+      if (solucion_.esRecoleccion(zona)) solucion_.rutaDe[zona] = static_cast<int>(copia.ruta);
+    }
+  }
+  copias_.clear();
+}
+
+/**
+ * @brief Criterio de aceptación de la solución de la iteración
+ * @param distancia Distancia de recolección de la solución
+ * @param rutas Rutas no vacías de la solución
+ * @param iteracion Número de la iteración (el recocido baja la temperatura hasta la centésima parte)
+ * @return true si la solución se acepta, false si se deshace
+ */
+bool RuinaRecreacion::aceptar(double distancia, int rutas, int iteracion) {
+  if (rutas != solucion_.rutas) return rutas < solucion_.rutas;
+  switch (configuracion_.aceptacion) {
+    case CriterioAceptacion::mejora:
+      return distancia < solucion_.distancia + kTolerancia;
+    case CriterioAceptacion::umbral:
+      return distancia < distanciaMejor_ * (1.0 + configuracion_.parametro) + kTolerancia;
+    case CriterioAceptacion::recocido: {
+      if (distancia < solucion_.distancia + kTolerancia) return true;
+      const double temperatura = temperaturaInicial_ * pow(0.01, static_cast<double>(iteracion) / configuracion_.iteraciones);
+      return uniform_real_distribution<double>(0.0, 1.0)(generador_) < exp(-(distancia - solucion_.distancia) / temperatura);
+    }
+  }
+  return false;
+}
@@ -0,0 +1,100 @@
+/**
+ * @class Búsqueda de vecindario grande por ruina y recreación (LNS) sobre las rutas de recolección de
+ *        una solución. En cada iteración quita unas pocas zonas (las más cercanas a una al azar, zonas al
+ *        azar o un trozo de la ruta de una zona al azar) y las vuelve a insertar una a una donde menos
+ *        distancia añaden (en un tramo entre SWTS o en un tramo nuevo al final de la ruta), con los
+ *        costes de inserción guardados por ruta y recalculados sólo en la ruta que cambia. Sólo se
+ *        prueban las rutas de las zonas vecinas de cada zona quitada, así que el trabajo de una
+ *        iteración depende del número de zonas que se quitan y no del tamaño de la instancia. La
+ *        solución resultante se acepta o se deshace según un CriterioAceptacion.
+ */
+
+#ifndef C_RuinaRecreacion_H
+#define C_RuinaRecreacion_H
+
+#include "../../../tools/tools.h"
+#include "../../../tools/indice_espacial/indice_espacial.h"
+#include "../../insercion/insercion.h"
+#include "../solucion_indexada/solucion_indexada.h"
+#include <random>
+#include <vector>
+
+class RuinaRecreacion {
+  public:
+    static constexpr int kVecinas = 10; // Zonas vecinas cuyas rutas se prueban al reinsertar cada zona
+    static constexpr double kTolerancia = 1e-9; // Diferencia de distancia que se considera un empate
+
+    RuinaRecreacion(const Tools& dato, const ConfiguracionLNS& configuracion, std::mt19937& generador);
+
+    // Aplica las iteraciones; deja en los vehículos la mejor solución, sin las rutas que se quedan vacías
+    bool mejorar();
+
+    // Setters
+    void setVehiculos(std::vector<Recoleccion>& vehiculos) { vehiculos_ = &vehiculos; }
+    void setMetricas(Metricas& metricas) { metricas_ = &metricas; }
+
+  private:
+    enum class TipoRuina { radial, aleatoria, ruta };
+    // Mejor inserción de una zona retirada en una de sus rutas candidatas: en un tramo de la ruta o, con
+    // swts >= 0, en un tramo nuevo (la zona y la SWTS) detrás de la última SWTS
+    struct Insercion {
+      size_t ruta;
+      size_t posicion = EvaluadorInsercion::kNinguna; // kNinguna si no cabe en la ruta
+      double delta = 0.0;
+      int swts = -1;
+    };
+    struct Retirada {
+      int zona; // Índice en Tools::zonas
+      size_t origen; // Ruta de la que se quitó
+      Zona parada; // Copia que estaba en la ruta (con su contenido)
+      std::vector<Insercion> candidatas;
+      bool insertada = false;
+    };
+    // Estado de una ruta antes de la iteración, para deshacerla
+    struct Copia {
+      size_t ruta;
+      Recoleccion vehiculo;
+      std::vector<int> indices;
+      double coste;
+      int zonas;
+    };
+
+    void cargarSolucion();
+    void arruinar(TipoRuina tipo, int cantidad);
+    void retirar(int zona);
+    void recrear();
+    void insertar(size_t retirada, const Insercion& insercion);
+    void abrirRuta(size_t retirada);
+    void evaluarRuta(size_t ruta);
+    void evaluarTramoNuevo(size_t ruta, size_t ultima, const Retirada& retirada, Insercion& insercion) const;
+    void guardarCopia(size_t ruta);
+    void deshacer(size_t rutasAntes);
+    bool aceptar(double distancia, int rutas, int iteracion);
+
+    const Tools& dato_;
+    ConfiguracionLNS configuracion_;
+    std::mt19937& generador_;
+    std::vector<Recoleccion>* vehiculos_ = nullptr;
+    Metricas* metricas_ = nullptr;
+    EvaluadorInsercion insercion_;
+
+    // Datos fijos de la instancia
+    std::vector<int> recoleccion_;
+    IndiceEspacial cercanas_; // Zonas de recolección, para la ruina radial y las rutas candidatas
+
+    // Solución actual (la ruta de una zona es -1 mientras está retirada)
+    SolucionIndexada solucion_;
+    double distanciaMejor_ = 0.0;
+    int rutasMejor_ = 0;
+    double temperaturaInicial_ = 0.0;
+
+    // Estado de la iteración (se reutiliza entre iteraciones)
+    std::vector<Retirada> retiradas_;
+    std::vector<Copia> copias_;
+    std::vector<char> copiada_; // Si la ruta ya está en copias_
+    std::vector<std::pair<double, int>> lista_;
+    std::vector<int> trozo_;
+    std::vector<size_t> rutasCandidatas_, pendientes_;
+};
+
+#endif
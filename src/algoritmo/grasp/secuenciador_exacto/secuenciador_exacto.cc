@@ -0,0 +1,74 @@
+#include "secuenciador_exacto.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Método para ordenar de forma óptima las zonas de un tramo. A igual distancia se queda con el
+ *        primer orden que encuentra, así que el resultado es determinista.
+ * @param inicio Parada con la que empieza el tramo (depósito o SWTS)
+ * @param zonas Zonas que se visitan entre las dos paradas
+ * @param fin Parada con la que termina el tramo
+ * @param orden Vector en el que se deja el orden óptimo, como posiciones en "zonas"
+ * @return double Distancia del tramo en el orden óptimo
+ * @throws std::invalid_argument si hay más de kMaxZonas zonas
+ */
+double SecuenciadorExacto::ordenar(const Zona& inicio, span<const Zona> zonas, const Zona& fin, vector<int>& orden) {
+  const int m = static_cast<int>(zonas.size());
+  if (m > kMaxZonas) throw invalid_argument("Error: El tramo tiene demasiadas zonas para ordenarlo de forma exacta");
+  orden.clear();
+  if (m == 0) return inicio.getDistancia(fin);
+  const int n = m + 2;
+  distancias_.resize(static_cast<size_t>(n) * n);
+  auto zona = [&](int i) -> const Zona& { return i < m ? zonas[i] : (i == m ? inicio : fin); };
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) distancias_[i * n + j] = zona(i).getDistancia(zona(j));
+  }
+  auto distancia = [&](int i, int j) { return distancias_[i * n + j]; };
+
+  const uint32_t completo = (1u << m) - 1;
+  coste_.assign(static_cast<size_t>(completo + 1) * m, INFINITY);
+  anterior_.assign(static_cast<size_t>(completo + 1) * m, 0);
+  for (int j = 0; j < m; j++) coste_[(1u << j) * m + j] = distancia(m, j);
+  // Se recorren sólo los bits a 1 del subconjunto (la última zona) y de su complemento (la siguiente)
+  for (uint32_t subconjunto = 1; subconjunto <= completo; subconjunto++) {
+    const double* costes = &coste_[subconjunto * m];
+    for (uint32_t ultimas = subconjunto; ultimas != 0; ultimas &= ultimas - 1) {
+      const int j = countr_zero(ultimas);
+      const double costeJ = costes[j];
+      const double* desdeJ = &distancias_[j * n];
+      for (uint32_t siguientes = completo & ~subconjunto; siguientes != 0; siguientes &= siguientes - 1) {
+        const int k = countr_zero(siguientes);
+        const size_t posicion = (subconjunto | (1u << k)) * m + k;
+        const double costeK = costeJ + desdeJ[k];
+        if (costeK < coste_[posicion]) {
+          coste_[posicion] = costeK;
+          anterior_[posicion] = static_cast<uint8_t>(j);
+        }
+      }
+    }
+  }
+
+  int ultima = 0;
+  double mejor = INFINITY;
+  for (int j = 0; j < m; j++) {
+    const double total = coste_[completo * m + j] + distancia(j, m + 1);
+    if (total < mejor) {
+      mejor = total;
+      ultima = j;
+    }
+  }
+  // Se reconstruye el camino hacia atrás desde la última zona
+  orden.resize(m);
+  uint32_t subconjunto = completo;
+  for (int posicion = m - 1; posicion >= 0; posicion--) {
+    orden[posicion] = ultima;
+    const int previa = anterior_[subconjunto * m + ultima];
+    subconjunto &= ~(1u << ultima);
+    ultima = previa;
+  }
+  return mejor;
+}
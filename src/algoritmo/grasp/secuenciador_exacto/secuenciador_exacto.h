@@ -0,0 +1,30 @@
+/**
+ * @class Ordenación exacta de un tramo de ruta: dadas una parada inicial, una final y las zonas que se
+ *        visitan entre ellas, encuentra el orden de las zonas que minimiza la distancia recorrida con la
+ *        programación dinámica de Held-Karp sobre subconjuntos (O(2^m · m²) en tiempo y O(2^m · m) en
+ *        memoria para m zonas). Las tablas se reutilizan entre llamadas, así que conviene tener uno por
+ *        búsqueda local.
+ */
+
+#ifndef C_SecuenciadorExacto_H
+#define C_SecuenciadorExacto_H
+
+#include "../../../zona/zona.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class SecuenciadorExacto {
+  public:
+    static constexpr int kMaxZonas = 16; // Con más, la tabla pasa de 8 MB y el tiempo se dispara
+
+    // Orden óptimo de "zonas" entre "inicio" y "fin"; devuelve su distancia
+    double ordenar(const Zona& inicio, std::span<const Zona> zonas, const Zona& fin, std::vector<int>& orden);
+
+  private:
+    std::vector<double> distancias_; // Entre las m zonas (0..m-1), el inicio (m) y el fin (m + 1)
+    std::vector<double> coste_; // coste_[subconjunto · m + j]: mejor camino desde el inicio por el subconjunto acabando en j
+    std::vector<uint8_t> anterior_; // Zona anterior a j en ese camino
+};
+
+#endif
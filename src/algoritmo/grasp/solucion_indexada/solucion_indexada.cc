@@ -0,0 +1,139 @@
+#include "solucion_indexada.h"
+#include "../busqueda_local/busqueda_local.h"
+#include "../../../solucion/solucion.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Constructor: indexa las zonas de la instancia (O(n), una vez por búsqueda)
+ * @param dato Instancia de las rutas que se indexan
+ * @return SolucionIndexada
+ */
+SolucionIndexada::SolucionIndexada(const Tools& dato) : dato_(dato), indiceDe_(Solucion::indicesDeZonas(dato)) {
+  tipo_.resize(dato.zonas.size());
+  for (size_t i = 0; i < dato.zonas.size(); i++) {
+    const Zona& zona = dato.zonas[i];
+    tipo_[i] = zona.esSWTS() ? 1 : (zona.esDeposito() || zona.esDumpsite() ? 2 : 0);
+    if (tipo_[i] == 1) swts_.push_back(i);
+  }
+}
+
+/**
+ * @brief Método para anotar el índice de cada parada de los vehículos, la ruta de cada zona y el coste de
+ *        cada ruta (O(n))
+ * @param vehiculos Rutas de la solución
+ * @param metricas Dónde contar los cálculos de coste (nulo = no se cuentan)
+ * @return void
+ * @throws std::runtime_error si alguna ruta visita una zona que no es de la instancia
+ */
+void SolucionIndexada::cargar(const vector<Recoleccion>& vehiculos, Metricas* metricas) {
+  indices.assign(vehiculos.size(), {});
+  costes.assign(vehiculos.size(), 0.0);
+  zonasEnRuta.assign(vehiculos.size(), 0);
+  rutaDe.assign(dato_.zonas.size(), -1);
+  distancia = 0.0;
+  rutas = 0;
+  for (size_t r = 0; r < vehiculos.size(); r++) {
+    for (const Zona& parada : vehiculos[r].getZonasVisitadas()) {
+      const int zona = indiceDe(parada.getId());
+      if (zona < 0) throw runtime_error("SolucionIndexada: la ruta visita una zona que no es de la instancia (" + parada.getId() + ")");
+      indices[r].push_back(zona);
+      if (!esRecoleccion(zona)) continue;
+      rutaDe[zona] = static_cast<int>(r);
+      zonasEnRuta[r]++;
+    }
+    costes[r] = BusquedaLocal::calcularCostoRuta(vehiculos[r], metricas);
+    distancia += costes[r];
+    if (zonasEnRuta[r] > 0) rutas++;
+  }
+}
+
+/**
+ * @brief Método para añadir el índice de una ruta nueva, que ya está al final de los vehículos
+ * @param paradas Índice en Tools::zonas de cada parada
+ * @param zonas Zonas de recolección de la ruta
+ * @return void
+ */
+void SolucionIndexada::anadirRuta(vector<int> paradas, int zonas) {
+  indices.push_back(std::move(paradas));
+  costes.push_back(0.0);
+  zonasEnRuta.push_back(zonas);
+}
+
+/**
+ * @brief Método para quitar una parada de una ruta. Si su tramo se queda vacío, se quita también la SWTS
+ *        que lo cierra: ir a descargar sin carga sólo añade distancia, y el tramo siguiente lleva la misma
+ *        carga. No cambia la ruta de la zona ni las zonas de la ruta.
+ * @param vehiculo Vehículo de la ruta
+ * @param ruta Índice de la ruta
+ * @param posicion Posición de la parada en la ruta
+ * @return Zona La parada quitada (con su contenido)
+ */
+Zona SolucionIndexada::quitarParada(Recoleccion& vehiculo, size_t ruta, size_t posicion) {
+  vector<int>& paradasRuta = indices[ruta];
+  pmr::vector<Zona>& paradas = vehiculo.getZonasVisitadas();
+  Zona parada = paradas[posicion];
+  paradasRuta.erase(paradasRuta.begin() + posicion);
+  paradas.erase(paradas.begin() + posicion);
+  if (posicion > 0 && posicion < paradasRuta.size() && esSWTS(paradasRuta[posicion]) && !esRecoleccion(paradasRuta[posicion - 1])) {
+    paradasRuta.erase(paradasRuta.begin() + posicion);
+    paradas.erase(paradas.begin() + posicion);
+  }
+  return parada;
+}
+
+/**
+ * @brief Método para poner una zona en una ruta. No cambia la ruta de la zona ni las zonas de la ruta.
+ * @param vehiculo Vehículo de la ruta
+ * @param ruta Índice de la ruta
+ * @param posicion Posición de la zona en la ruta
+ * @param parada Copia de la zona que se pone (con su contenido)
+ * @param zona Índice en Tools::zonas de la zona
+ * @param swts Índice en Tools::zonas de la SWTS que va detrás de la zona, si abre un tramo nuevo (-1 si no)
+ * @return void
+ */
+void SolucionIndexada::ponerParada(Recoleccion& vehiculo, size_t ruta, size_t posicion, const Zona& parada, int zona, int swts) {
+  vector<int>& paradasRuta = indices[ruta];
+  pmr::vector<Zona>& paradas = vehiculo.getZonasVisitadas();
+  if (swts >= 0) {
+    // Tramo nuevo: la SWTS va detrás de la zona
+    paradas.insert(paradas.begin() + posicion, dato_.zonas[swts]);
+    paradasRuta.insert(paradasRuta.begin() + posicion, swts);
+  }
+  paradas.insert(paradas.begin() + posicion, parada);
+  paradasRuta.insert(paradasRuta.begin() + posicion, zona);
+}
+
+/**
+ * @brief Método para quitar las rutas que sólo visitan SWTS y el depósito
+ * @param vehiculos Rutas de la solución
+ * @return void
+ */
+void SolucionIndexada::quitarRutasVacias(vector<Recoleccion>& vehiculos) {
+  erase_if(vehiculos, [](const Recoleccion& vehiculo) {
+    return all_of(vehiculo.getZonasVisitadas().begin(), vehiculo.getZonasVisitadas().end(), [](const Zona& zona) { return zona.esSWTS() || zona.esDeposito(); });
+  });
+}
+
+int SolucionIndexada::indiceDe(const string& id) const {
+  const auto encontrada = indiceDe_.find(id);
+  return encontrada != indiceDe_.end() ? encontrada->second : -1;
+}
+
+size_t SolucionIndexada::ultimaSWTS(size_t ruta) const {
+  const vector<int>& paradas = indices[ruta];
+  for (size_t p = paradas.size(); p-- > 0;) {
+    if (esSWTS(paradas[p])) return p;
+  }
+  return 0;
+}
+
+int SolucionIndexada::swtsMasCercana(int zona) const {
+  int mejor = swts_.front();
+  for (int swts : swts_) {
+    if (dato_.zonas[zona].getDistancia(dato_.zonas[swts]) < dato_.zonas[zona].getDistancia(dato_.zonas[mejor])) mejor = swts;
+  }
+  return mejor;
+}
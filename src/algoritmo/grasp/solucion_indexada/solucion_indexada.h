@@ -0,0 +1,56 @@
+/**
+ * @class Índice de las rutas de recolección de una solución por zona de la instancia, para las búsquedas
+ *        que mueven zonas sueltas entre rutas (ruina y recreación, reencadenamiento de trayectorias): el
+ *        índice en Tools::zonas de cada parada, la ruta de cada zona de recolección, la distancia de cada
+ *        ruta y las rutas no vacías. Las paradas se siguen guardando en los vehículos; quitarParada y
+ *        ponerParada cambian a la vez la ruta y su índice, y el resto lo mantiene al día quien las usa.
+ */
+
+#ifndef C_SolucionIndexada_H
+#define C_SolucionIndexada_H
+
+#include "../../../tools/tools.h"
+#include "../../../tools/metricas/metricas.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SolucionIndexada {
+  public:
+    explicit SolucionIndexada(const Tools& dato);
+
+    // Indexa las rutas de los vehículos (los costes se cuentan en "metricas", si no es nulo)
+    void cargar(const std::vector<Recoleccion>& vehiculos, Metricas* metricas = nullptr);
+    // Añade al final el índice de una ruta nueva con "zonas" zonas de recolección (su coste queda a 0)
+    void anadirRuta(std::vector<int> paradas, int zonas);
+    // Quita la parada "posicion" de la ruta y, si su tramo se queda vacío, la SWTS que lo cierra; devuelve la parada
+    Zona quitarParada(Recoleccion& vehiculo, size_t ruta, size_t posicion);
+    // Pone la zona en la posición "posicion" de la ruta, con swts >= 0 seguida de esa SWTS (un tramo nuevo)
+    void ponerParada(Recoleccion& vehiculo, size_t ruta, size_t posicion, const Zona& parada, int zona, int swts = -1);
+    // Quita las rutas que se han quedado sin zonas de recolección
+    static void quitarRutasVacias(std::vector<Recoleccion>& vehiculos);
+
+    // Getters
+    int indiceDe(const std::string& id) const; // Índice en Tools::zonas del identificador (-1 si no es de la instancia)
+    size_t ultimaSWTS(size_t ruta) const; // Posición de la última SWTS de la ruta (0 si no tiene)
+    int swtsMasCercana(int zona) const;
+    inline bool esRecoleccion(int zona) const { return tipo_[zona] == 0; }
+    inline bool esSWTS(int zona) const { return tipo_[zona] == 1; }
+
+    // Solución indexada
+    std::vector<std::vector<int>> indices; // Índice en Tools::zonas de cada parada de cada ruta
+    std::vector<double> costes; // Distancia de cada ruta
+    std::vector<int> zonasEnRuta; // Zonas de recolección de cada ruta (0 = vacía)
+    std::vector<int> rutaDe; // Ruta de cada zona de recolección (-1 si no está en ninguna)
+    double distancia = 0.0;
+    int rutas = 0; // Rutas no vacías
+
+  private:
+    const Tools& dato_;
+    // Datos fijos de la instancia
+    std::unordered_map<std::string, int> indiceDe_; // Índice en Tools::zonas de cada identificador
+    std::vector<char> tipo_; // 0 = recolección, 1 = SWTS, 2 = depósito o vertedero
+    std::vector<int> swts_;
+};
+
+#endif
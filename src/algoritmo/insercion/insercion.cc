@@ -0,0 +1,258 @@
+#include "insercion.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VRPT_INSERCION_AVX2 1
+#endif
+
+using namespace std;
+
+/**
+ * @brief Kernel escalar de deltasInsercion (el de referencia, y el que se usa sin AVX2)
+ * @param x Coordenada x de cada zona de la ruta
+ * @param y Coordenada y de cada zona de la ruta
+ * @param n Número de zonas de la ruta
+ * @param zx Coordenada x de la zona a insertar
+ * @param zy Coordenada y de la zona a insertar
+ * @param velocidad Velocidad del vehículo
+ * @param deltaDistancia Distancia añadida por cada posición (se escriben las posiciones [1, n))
+ * @param deltaTiempo Tiempo añadido por cada posición, con el redondeo de Vehiculo::calcularTiempo
+ * @return void
+ */
+void deltasInsercionEscalar(const double* x, const double* y, size_t n, double zx, double zy, double velocidad, double* deltaDistancia, int* deltaTiempo) {
+  for (size_t l = 1; l < n; l++) {
+    const double antesZona = sqrt((x[l - 1] - zx) * (x[l - 1] - zx) + (y[l - 1] - zy) * (y[l - 1] - zy));
+    const double zonaDespues = sqrt((zx - x[l]) * (zx - x[l]) + (zy - y[l]) * (zy - y[l]));
+    const double antesDespues = sqrt((x[l - 1] - x[l]) * (x[l - 1] - x[l]) + (y[l - 1] - y[l]) * (y[l - 1] - y[l]));
+    deltaDistancia[l] = (antesZona + zonaDespues) - antesDespues;
+    deltaTiempo[l] = int(antesZona / velocidad * 60) + int(zonaDespues / velocidad * 60) - int(antesDespues / velocidad * 60);
+  }
+}
+
+#ifdef VRPT_INSERCION_AVX2
+namespace {
+
+// Distancia euclídea entre cuatro pares de puntos a la vez
+__attribute__((target("avx2"), always_inline)) inline __m256d distancia4(__m256d ax, __m256d ay, __m256d bx, __m256d by) {
+  const __m256d dx = _mm256_sub_pd(ax, bx);
+  const __m256d dy = _mm256_sub_pd(ay, by);
+  return _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+}
+
+// Minutos de cuatro distancias a la vez, truncados como en Vehiculo::calcularTiempo
+__attribute__((target("avx2"), always_inline)) inline __m128i tiempo4(__m256d distancia, __m256d velocidad) {
+  return _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_div_pd(distancia, velocidad), _mm256_set1_pd(60.0)));
+}
+
+/**
+ * @brief Kernel AVX2 de deltasInsercion: cuatro posiciones por iteración. Sólo usa sumas, productos,
+ *        divisiones y raíces (sin FMA), que redondean igual que en el kernel escalar.
+ */
+__attribute__((target("avx2")))
+void deltasInsercionAVX2(const double* x, const double* y, size_t n, double zx, double zy, double velocidad, double* deltaDistancia, int* deltaTiempo) {
+  const __m256d vzx = _mm256_set1_pd(zx);
+  const __m256d vzy = _mm256_set1_pd(zy);
+  const __m256d vvelocidad = _mm256_set1_pd(velocidad);
+  size_t l = 1;
+  for (; l + 4 <= n; l += 4) {
+    const __m256d antesX = _mm256_loadu_pd(x + l - 1), antesY = _mm256_loadu_pd(y + l - 1);
+    const __m256d despuesX = _mm256_loadu_pd(x + l), despuesY = _mm256_loadu_pd(y + l);
+    const __m256d antesZona = distancia4(antesX, antesY, vzx, vzy);
+    const __m256d zonaDespues = distancia4(vzx, vzy, despuesX, despuesY);
+    const __m256d antesDespues = distancia4(antesX, antesY, despuesX, despuesY);
+    _mm256_storeu_pd(deltaDistancia + l, _mm256_sub_pd(_mm256_add_pd(antesZona, zonaDespues), antesDespues));
+    const __m128i tiempos = _mm_sub_epi32(_mm_add_epi32(tiempo4(antesZona, vvelocidad), tiempo4(zonaDespues, vvelocidad)), tiempo4(antesDespues, vvelocidad));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(deltaTiempo + l), tiempos);
+  }
+  // Las posiciones que no completan un bloque de cuatro
+  if (l < n) deltasInsercionEscalar(x + l - 1, y + l - 1, n - l + 1, zx, zy, velocidad, deltaDistancia + l - 1, deltaTiempo + l - 1);
+}
+
+} // namespace
+#endif
+
+/**
+ * @brief Función para saber si deltasInsercion usa el kernel AVX2 (se decide una vez, según la CPU)
+ * @return true si la CPU tiene AVX2, false en caso contrario
+ */
+bool insercionVectorial() {
+#ifdef VRPT_INSERCION_AVX2
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Coste y tiempo añadidos al insertar el punto (zx, zy) en cada posición de la ruta, con el
+ *        kernel AVX2 si la CPU lo tiene y el escalar si no
+ * @return void
+ */
+void deltasInsercion(const double* x, const double* y, size_t n, double zx, double zy, double velocidad, double* deltaDistancia, int* deltaTiempo) {
+#ifdef VRPT_INSERCION_AVX2
+  if (insercionVectorial()) {
+    deltasInsercionAVX2(x, y, n, zx, zy, velocidad, deltaDistancia, deltaTiempo);
+    return;
+  }
+#endif
+  deltasInsercionEscalar(x, y, n, zx, zy, velocidad, deltaDistancia, deltaTiempo);
+}
+
+/**
+ * @brief Método para cargar una ruta en el evaluador: coordenadas, carga de cada tramo entre SWTS,
+ *        duración y distancia, calculadas como en BusquedaLocal::esFactible y calcularCostoRuta
+ * @param ruta Ruta de recolección
+ * @param omitir Posición de la zona que se quita de la ruta antes de cargarla (kNinguna para ninguna)
+ * @return void
+ */
+void EvaluadorInsercion::cargar(const Recoleccion& ruta, size_t omitir) {
+  const pmr::vector<Zona>& zonas = ruta.getZonasVisitadas();
+  x_.clear();
+  y_.clear();
+  segmento_.clear();
+  carga_.assign(1, 0.0);
+  sobrecargados_ = 0;
+  tiempo_ = 0;
+  coste_ = 0.0;
+  capacidad_ = ruta.getCapacidad();
+  velocidad_ = ruta.getVelocidad();
+  duracion_ = ruta.getDuracion();
+  const Zona* anterior = nullptr;
+  for (size_t i = 0; i < zonas.size(); i++) {
+    if (i == omitir) continue;
+    const Zona& zona = zonas[i];
+    x_.push_back(zona.getPosicion().first);
+    y_.push_back(zona.getPosicion().second);
+    if (!zona.esSWTS() && !zona.esDeposito()) carga_.back() += zona.getContenido();
+    if (zona.esSWTS()) carga_.push_back(0.0); // En la SWTS se vacía: empieza otro tramo
+    segmento_.push_back(carga_.size() - 1);
+    if (anterior != nullptr) {
+      // El tiempo de procesado de la última zona no cuenta, como en esFactible
+      tiempo_ += ruta.calcularTiempo(anterior->getDistancia(zona));
+      tiempo_ += anterior->getTiempoDeProcesado();
+      coste_ += anterior->getDistancia(zona);
+    }
+    anterior = &zona;
+  }
+  for (double carga : carga_) {
+    if (carga > capacidad_) sobrecargados_++;
+  }
+}
+
+/**
+ * @brief Método para evaluar la inserción de una zona en todas las posiciones de la ruta cargada: la
+ *        distancia y el tiempo añadidos (kernel vectorial) y si la ruta resultante sería factible
+ * @param zona Zona de recolección a insertar
+ * @return void
+ */
+void EvaluadorInsercion::evaluar(const Zona& zona) {
+  const size_t n = x_.size();
+  deltaDistancia_.resize(n);
+  deltaTiempo_.resize(n);
+  factible_.assign(n, 0);
+  if (n < 2) return;
+  deltasInsercion(x_.data(), y_.data(), n, zona.getPosicion().first, zona.getPosicion().second, velocidad_, deltaDistancia_.data(), deltaTiempo_.data());
+  const double contenido = zona.getContenido();
+  const int procesado = static_cast<int>(zona.getTiempoDeProcesado());
+  for (size_t l = 1; l < n; l++) factible_[l] = cabe(l, contenido, deltaTiempo_[l], procesado);
+}
+
+/**
+ * @brief Método para evaluar la inserción de una zona en una sola posición de la ruta cargada, con el
+ *        kernel escalar (que redondea igual que el vectorial). No cambia los resultados de evaluar.
+ * @param zona Zona de recolección a insertar
+ * @param l Posición, en [1, tamano())
+ * @param deltaTiempo Tiempo de viaje añadido en la posición (aunque no sea factible)
+ * @return double Distancia añadida, o INFINITY si la ruta resultante no sería factible
+ */
+double EvaluadorInsercion::deltaPosicion(const Zona& zona, size_t l, int& deltaTiempo) const {
+  double deltasDistancia[2];
+  int deltasTiempo[2];
+  deltasInsercionEscalar(x_.data() + l - 1, y_.data() + l - 1, 2, zona.getPosicion().first, zona.getPosicion().second, velocidad_, deltasDistancia, deltasTiempo);
+  deltaTiempo = deltasTiempo[1];
+  if (!cabe(l, zona.getContenido(), deltaTiempo, static_cast<int>(zona.getTiempoDeProcesado()))) return INFINITY;
+  return deltasDistancia[1];
+}
+
+/**
+ * @brief Método para saber si la ruta cargada sería factible con una zona insertada en la posición l:
+ *        ningún tramo se pasa de la capacidad y la duración no se pasa de la máxima
+ * @param l Posición de la zona
+ * @param contenido Contenido de la zona
+ * @param deltaTiempo Tiempo de viaje añadido en la posición
+ * @param procesado Tiempo de procesado de la zona
+ * @return true si es factible, false en caso contrario
+ */
+bool EvaluadorInsercion::cabe(size_t l, double contenido, int deltaTiempo, int procesado) const {
+  const int tramo = segmento_[l - 1];
+  const int otrosSobrecargados = sobrecargados_ - (carga_[tramo] > capacidad_ ? 1 : 0);
+  const bool cabeEnTramo = otrosSobrecargados == 0 && !(carga_[tramo] + contenido > capacidad_);
+  return cabeEnTramo && aTiempo(deltaTiempo + procesado);
+}
+
+/**
+ * @brief Método para obtener la carga del tramo menos cargado de la ruta cargada en el que se puede
+ *        insertar una zona, para descartar sin evaluarla la que no cabe en ninguna posición
+ * @param hasta Última posición que se considera (kNinguna = todas)
+ * @return double Carga del tramo, o INFINITY si no hay posiciones o algún tramo se pasa de la capacidad
+ */
+double EvaluadorInsercion::cargaMinima(size_t hasta) const {
+  if (sobrecargados_ > 0) return INFINITY;
+  double minima = INFINITY;
+  const size_t fin = hasta == kNinguna ? x_.size() : min(hasta + 1, x_.size());
+  for (size_t l = 1; l < fin; l++) minima = min(minima, carga_[segmento_[l - 1]]);
+  return minima;
+}
+
+/**
+ * @brief Método para obtener la mejor posición de inserción de una zona en la ruta cargada
+ * @param zona Zona de recolección a insertar
+ * @param hasta Última posición que se considera (kNinguna = todas)
+ * @return size_t Posición factible de menor distancia añadida (la primera a igualdad), o kNinguna
+ */
+size_t EvaluadorInsercion::mejorPosicion(const Zona& zona, size_t hasta) {
+  evaluar(zona);
+  size_t mejor = kNinguna;
+  const size_t fin = hasta == kNinguna ? x_.size() : min(hasta + 1, x_.size());
+  for (size_t l = 1; l < fin; l++) {
+    if (factible_[l] && (mejor == kNinguna || deltaDistancia_[l] < deltaDistancia_[mejor])) mejor = l;
+  }
+  return mejor;
+}
+
+/**
+ * @brief Método para evaluar un tramo nuevo con la zona y una SWTS justo detrás de la parada "ultima" de
+ *        la ruta cargada (normalmente su última SWTS, para que la zona se descargue antes de volver)
+ * @param ruta Ruta cargada
+ * @param ultima Posición de la parada detrás de la que va el tramo (no puede ser la última de la ruta)
+ * @param zona Zona de recolección a insertar
+ * @param swts SWTS en la que termina el tramo
+ * @return double Distancia añadida, o INFINITY si la ruta se pasaría de la duración
+ */
+double EvaluadorInsercion::tramoNuevo(const Recoleccion& ruta, size_t ultima, const Zona& zona, const Zona& swts) const {
+  if (ultima + 1 >= ruta.getZonasVisitadas().size()) return INFINITY;
+  int tiempo = 0;
+  const double delta = tramoNuevo(ruta, ultima, zona, swts, tiempo);
+  return aTiempo(tiempo) ? delta : INFINITY;
+}
+
+/**
+ * @brief Método para evaluar un tramo nuevo como el anterior, pero sin comprobar la duración: el tiempo
+ *        que añade a la ruta no depende del resto de la ruta, así que se puede guardar y comprobar luego
+ * @param ruta Ruta cargada
+ * @param ultima Posición de la parada detrás de la que va el tramo (no puede ser la última de la ruta)
+ * @param zona Zona de recolección a insertar
+ * @param swts SWTS en la que termina el tramo
+ * @param tiempo Tiempo que añade el tramo a la ruta
+ * @return double Distancia añadida
+ */
+double EvaluadorInsercion::tramoNuevo(const Recoleccion& ruta, size_t ultima, const Zona& zona, const Zona& swts, int& tiempo) const {
+  const pmr::vector<Zona>& paradas = ruta.getZonasVisitadas();
+  const Zona& anterior = paradas[ultima];
+  const Zona& siguiente = paradas[ultima + 1];
+  tiempo = -ruta.calcularTiempo(anterior.getDistancia(siguiente)) + ruta.calcularTiempo(anterior.getDistancia(zona)) + ruta.calcularTiempo(zona.getDistancia(swts)) +
+           ruta.calcularTiempo(swts.getDistancia(siguiente)) + static_cast<int>(zona.getTiempoDeProcesado() + swts.getTiempoDeProcesado());
+  return anterior.getDistancia(zona) + zona.getDistancia(swts) + swts.getDistancia(siguiente) - anterior.getDistancia(siguiente);
+}
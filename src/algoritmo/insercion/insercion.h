@@ -0,0 +1,71 @@
+/**
+ * @class Evaluador de la inserción de una zona en todas las posiciones de una ruta de recolección a la
+ *        vez. La ruta se guarda como estructura de arrays (coordenadas, carga del tramo entre SWTS de
+ *        cada posición) y el coste y el tiempo añadidos de cada posición se calculan con un kernel
+ *        vectorial (AVX2 si la CPU lo tiene, escalar si no), con los mismos redondeos que
+ *        Zona::getDistancia, Vehiculo::calcularTiempo y BusquedaLocal::esFactible.
+ */
+
+#ifndef C_Insercion_H
+#define C_Insercion_H
+
+#include "../../vehiculo/recoleccion/recoleccion.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Coste y tiempo añadidos al insertar el punto (zx, zy) entre los puntos l - 1 y l de la ruta,
+ *        para cada l en [1, n). Los resultados de l se guardan en deltaDistancia[l] y deltaTiempo[l].
+ */
+void deltasInsercion(const double* x, const double* y, size_t n, double zx, double zy, double velocidad, double* deltaDistancia, int* deltaTiempo);
+void deltasInsercionEscalar(const double* x, const double* y, size_t n, double zx, double zy, double velocidad, double* deltaDistancia, int* deltaTiempo);
+bool insercionVectorial(); // true si deltasInsercion usa el kernel AVX2
+
+class EvaluadorInsercion {
+  public:
+    static constexpr size_t kNinguna = static_cast<size_t>(-1);
+
+    void cargar(const Recoleccion& ruta, size_t omitir = kNinguna); // Carga la ruta, sin la zona en la posición "omitir"
+    void evaluar(const Zona& zona); // Evalúa insertar la zona (de recolección) en cada posición de la ruta cargada
+    size_t mejorPosicion(const Zona& zona, size_t hasta = kNinguna); // Posición factible de menor coste añadido hasta "hasta" (kNinguna si no hay)
+    // Distancia añadida al insertar la zona en la posición l de la ruta cargada (como evaluar en una sola posición),
+    // con su tiempo de viaje añadido en deltaTiempo; infinito si no es factible
+    double deltaPosicion(const Zona& zona, size_t l, int& deltaTiempo) const;
+    // Si la ruta cargada sería factible con una zona en la posición l que añade deltaTiempo de viaje
+    bool cabe(size_t l, double contenido, int deltaTiempo, int procesado) const;
+    // Distancia añadida por un tramo nuevo (la zona y la SWTS) justo detrás de la parada "ultima" de la ruta
+    // cargada, que hay que volver a pasar; infinito si no da tiempo (la zona sola en su tramo siempre cabe)
+    double tramoNuevo(const Recoleccion& ruta, size_t ultima, const Zona& zona, const Zona& swts) const;
+    // Lo mismo aunque no dé tiempo, con el tiempo que añade en "tiempo" (para comprobarlo con aTiempo)
+    double tramoNuevo(const Recoleccion& ruta, size_t ultima, const Zona& zona, const Zona& swts, int& tiempo) const;
+    inline bool aTiempo(int tiempo) const { return tiempo_ + tiempo <= duracion_; } // Si se puede añadir a la ruta cargada
+    // Carga del tramo menos cargado en el que se puede insertar hasta la posición "hasta" (infinito si ninguno o si
+    // algún tramo ya se pasa de la capacidad): una zona que no cabe en él no cabe en ninguna posición
+    double cargaMinima(size_t hasta = kNinguna) const;
+
+    // Resultados de evaluar: la posición l es insertar antes de la zona l de la ruta cargada, l en [1, tamano())
+    inline size_t tamano() const { return x_.size(); }
+    inline bool factible(size_t l) const { return factible_[l]; }
+    inline double delta(size_t l) const { return deltaDistancia_[l]; }
+    inline int deltaTiempo(size_t l) const { return deltaTiempo_[l]; } // Tiempo de viaje añadido
+    inline double coste() const { return coste_; } // Distancia de la ruta cargada
+    inline int tiempo() const { return tiempo_; } // Duración de la ruta cargada, calculada como en esFactible
+
+  private:
+    // Ruta cargada en estructura de arrays
+    std::vector<double> x_, y_;
+    std::vector<int> segmento_; // Tramo (entre SWTS) en curso después de cada zona: al que se une una zona insertada detrás
+    std::vector<double> carga_; // Contenido recogido en cada tramo
+    int sobrecargados_ = 0; // Tramos que ya superan la capacidad
+    int tiempo_ = 0; // Duración de la ruta cargada, calculada como en esFactible
+    double coste_ = 0.0;
+    double capacidad_ = 0.0, velocidad_ = 0.0;
+    int duracion_ = 0;
+    // Resultados de la última evaluación
+    std::vector<double> deltaDistancia_;
+    std::vector<int> deltaTiempo_;
+    std::vector<uint8_t> factible_;
+};
+
+#endif
@@ -0,0 +1,250 @@
+#include "insercion_arrepentimiento.h"
+#include "../constructor/vecindario.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Método para construir las rutas de recolección. Cada paso saca de la cola la zona de mayor
+ *        arrepentimiento y la inserta en la ruta abierta; cuando la cola se vacía no cabe ninguna y se
+ *        abre otra ruta. Cada paso es O(1) por cada zona que cabe en la ruta o cerca de sus aristas nuevas,
+ *        más O(L) (L, paradas de la ruta abierta) por cada una que hay que evaluar en toda la ruta y
+ *        O(log n) por cada una cuyo coste cambia.
+ * @return void
+ * @throws std::runtime_error si la instancia no tiene SWTS (o ninguna es alcanzable)
+ */
+void InsercionArrepentimiento::construir() {
+  indicesDeZonas(dato_, recoleccion_, swts_);
+  if (swts_.empty() && !recoleccion_.empty()) {
+    throw runtime_error("InsercionArrepentimiento::construir: la instancia no tiene estaciones de transferencia");
+  }
+  const size_t m = recoleccion_.size();
+  const Zona& deposito = dato_.deposito();
+  swtsCercana_ = swtsMasCercanas(dato_, recoleccion_);
+  costeNueva_.resize(m);
+  for (size_t i = 0; i < m; i++) {
+    if (swtsCercana_[i] < 0) throw runtime_error("InsercionArrepentimiento::construir: la instancia no tiene estaciones de transferencia alcanzables");
+    const Zona& zona = dato_.zonas[recoleccion_[i]];
+    const Zona& cercana = dato_.zonas[swtsCercana_[i]];
+    costeNueva_[i] = deposito.getDistancia(zona) + zona.getDistancia(cercana) + cercana.getDistancia(deposito);
+  }
+  pendiente_.assign(m, 1);
+  porLejania_.resize(m);
+  vector<IndiceEspacial::Punto> puntos(m);
+  for (size_t i = 0; i < m; i++) {
+    const Zona& zona = dato_.zonas[recoleccion_[i]];
+    porLejania_[i] = i;
+    puntos[i] = {double(zona.getPosicion().first), double(zona.getPosicion().second), static_cast<int>(i)};
+  }
+  cercanas_ = IndiceEspacial(puntos);
+  stable_sort(porLejania_.begin(), porLejania_.end(), [&](int a, int b) { return costeNueva_[a] > costeNueva_[b]; });
+  siguienteLejana_ = 0;
+  coste_.assign(m, INFINITY);
+  posicion_.assign(m, EvaluadorInsercion::kNinguna);
+  deltaArista_.assign(m, INFINITY);
+  tiempoArista_.assign(m, 0);
+  deltaTramo_.assign(m, INFINITY);
+  tiempoTramo_.assign(m, 0);
+  ancla_.assign(m, 0);
+  anclas_ = 0;
+  tramoNuevo_.assign(m, 0);
+  version_.assign(m, 0);
+  repaso_.assign(m, 0);
+  cercaDeAristas_.assign(m, 0);
+  repasos_ = 0;
+  caben_.clear();
+  indices_.clear();
+  while (!cercanas_.vacio()) {
+    if (cola_.empty()) {
+      // Todas las pendientes tienen coste infinito en la ruta abierta, que ya no recibe más
+      while (!pendiente_[porLejania_[siguienteLejana_]]) siguienteLejana_++;
+      abrirRuta(porLejania_[siguienteLejana_]);
+      continue;
+    }
+    const Entrada entrada = cola_.top();
+    cola_.pop();
+    if (pendiente_[entrada.zona] && entrada.version == version_[entrada.zona]) insertar(entrada.zona);
+  }
+  guardarRutas();
+}
+
+/**
+ * @brief Método para insertar una zona en su mejor posición de la ruta abierta
+ * @param zona Posición en recoleccion_ de la zona
+ * @return void
+ */
+void InsercionArrepentimiento::insertar(int zona) {
+  // Al día desde actualizarRuta
+  const size_t posicion = tramoNuevo_[zona] ? ultima_ + 1 : posicion_[zona];
+  const int swts = tramoNuevo_[zona] ? swtsCercana_[zona] : -1;
+  pmr::vector<Zona>& paradas = ruta_.getZonasVisitadas();
+  vector<int>& indices = indices_.back();
+  if (swts >= 0) {
+    // Tramo nuevo: la SWTS va detrás de la zona y pasa a ser la última
+    paradas.insert(paradas.begin() + posicion, dato_.zonas[swts]);
+    indices.insert(indices.begin() + posicion, swts);
+    ultima_ = posicion + 1;
+  } else {
+    ultima_++; // La zona va antes de la última SWTS
+  }
+  paradas.insert(paradas.begin() + posicion, dato_.zonas[recoleccion_[zona]]);
+  indices.insert(indices.begin() + posicion, recoleccion_[zona]);
+  retirarPendiente(zona);
+  actualizarRuta(posicion, swts >= 0 ? 2 : 1);
+}
+
+/**
+ * @brief Método para abrir la ruta siguiente con una zona (depósito, zona, SWTS más cercana, depósito)
+ * @param zona Posición en recoleccion_ de la zona
+ * @return void
+ */
+void InsercionArrepentimiento::abrirRuta(int zona) {
+  const int indice = recoleccion_[zona];
+  const int swts = swtsCercana_[zona];
+  ruta_ = Recoleccion(dato_.capacidadRecoleccion, dato_.velocidad, dato_.deposito(), dato_.duracionRecoleccion);
+  ruta_.moverVehiculo(dato_.zonas[indice], dato_.deposito().getDistancia(dato_.zonas[indice]));
+  ruta_.moverVehiculo(dato_.zonas[swts], dato_.zonas[indice].getDistancia(dato_.zonas[swts]));
+  ruta_.volverAlInicio();
+  indices_.push_back({dato_.indiceDeposito, indice, swts, dato_.indiceDeposito});
+  ultima_ = 2;
+  retirarPendiente(zona);
+  caben_.clear(); // Ninguna cabía en la ruta anterior
+  actualizarRuta(1, 2); // Como si la zona abriera un tramo nuevo en una ruta vacía
+}
+
+/**
+ * @brief Método para recalcular el coste de las zonas pendientes en la ruta abierta. Al insertar, las
+ *        aristas de la ruta siguen ahí salvo la que se parte, y la carga de los tramos y la duración sólo
+ *        crecen, así que ninguna arista en la que una zona no cabía pasa a caber y la mejor arista guardada
+ *        sigue siendo la mejor de las antiguas mientras quepa. Sólo se repasan las zonas que cabían y las
+ *        que pueden caber en las aristas nuevas o, si la última SWTS es otra, en un tramo nuevo detrás de
+ *        ella. De cada una se comprueba si su arista y su tramo nuevo guardados siguen cabiendo (O(1)) y,
+ *        si está cerca, las dos aristas nuevas; la ruta entera sólo se evalúa si su arista se ha partido o
+ *        ya no cabe en ella, y el tramo nuevo sólo se vuelve a calcular si la última SWTS es otra. Las
+ *        zonas que cambian vuelven a la cola con una versión nueva, que anula su entrada anterior; las que
+ *        ya no caben sólo anulan la entrada.
+ * @param posicion Posición de la ruta abierta en la que se ha insertado la última zona
+ * @param insertadas Paradas insertadas: 1 (la zona) o 2 (la zona y la SWTS de su tramo nuevo)
+ * @return void
+ */
+void InsercionArrepentimiento::actualizarRuta(size_t posicion, size_t insertadas) {
+  evaluador_.cargar(ruta_);
+  const pmr::vector<Zona>& paradas = ruta_.getZonasVisitadas();
+  // Distancia que la ruta puede añadir antes de pasarse de la duración (con margen por el truncamiento de
+  // Vehiculo::calcularTiempo en cada arista, hasta 3 en un tramo nuevo)
+  const double holgura = (ruta_.getDuracion() - evaluador_.tiempo() + 3) * ruta_.getVelocidad() / 60.0;
+  if (insertadas == 2) anclas_++; // La última SWTS es otra
+  const double cargaMinima = evaluador_.cargaMinima(ultima_);
+  repasos_++;
+  candidatas_.clear();
+  for (int zona : caben_) {
+    if (!pendiente_[zona]) continue;
+    repaso_[zona] = repasos_;
+    candidatas_.push_back(zona);
+  }
+  anadirCandidatas(paradas[posicion - 1], paradas[posicion], holgura);
+  anadirCandidatas(paradas[posicion], paradas[posicion + 1], holgura);
+  // Un tramo nuevo pasa por la zona entre la última SWTS y el depósito, y la SWTS más cercana no lo acorta
+  if (insertadas == 2) anadirCandidatas(paradas[ultima_], paradas[ultima_ + 1], holgura, false);
+  caben_.clear();
+  for (int zona : candidatas_) {
+    const Zona& parada = dato_.zonas[recoleccion_[zona]];
+    const double contenido = parada.getContenido();
+    const int procesado = static_cast<int>(parada.getTiempoDeProcesado());
+    // Mejor arista de un tramo de la ruta (a igual coste, la primera, como EvaluadorInsercion::mejorPosicion)
+    size_t mejor = posicion_[zona];
+    double coste = INFINITY;
+    if (mejor != EvaluadorInsercion::kNinguna && mejor != posicion) {
+      if (mejor > posicion) mejor += insertadas;
+      if (evaluador_.cabe(mejor, contenido, tiempoArista_[zona], procesado)) coste = deltaArista_[zona];
+    }
+    if (mejor != EvaluadorInsercion::kNinguna && !(coste < INFINITY)) {
+      // Se ha partido su arista o ya no cabe en ella (ni en ninguna, si no cabe en el tramo menos cargado)
+      mejor = cargaMinima + contenido > ruta_.getCapacidad() ? EvaluadorInsercion::kNinguna : evaluador_.mejorPosicion(parada, ultima_);
+      if (mejor != EvaluadorInsercion::kNinguna) {
+        coste = evaluador_.delta(mejor);
+        tiempoArista_[zona] = evaluador_.deltaTiempo(mejor);
+      }
+    } else if (cercaDeAristas_[zona] == repasos_) {
+      for (size_t l : {posicion, posicion + 1}) {
+        int tiempo = 0;
+        const double delta = evaluador_.deltaPosicion(parada, l, tiempo);
+        if (delta < coste || (delta == coste && delta < INFINITY && l < mejor)) {
+          coste = delta;
+          mejor = l;
+          tiempoArista_[zona] = tiempo;
+        }
+      }
+    }
+    if (!(coste < INFINITY)) mejor = EvaluadorInsercion::kNinguna;
+    posicion_[zona] = mejor;
+    deltaArista_[zona] = coste;
+    if (ancla_[zona] != anclas_) {
+      ancla_[zona] = anclas_;
+      deltaTramo_[zona] = evaluador_.tramoNuevo(ruta_, ultima_, parada, dato_.zonas[swtsCercana_[zona]], tiempoTramo_[zona]);
+    }
+    tramoNuevo_[zona] = evaluador_.aTiempo(tiempoTramo_[zona]) && deltaTramo_[zona] < coste;
+    if (tramoNuevo_[zona]) coste = deltaTramo_[zona];
+    if (coste < INFINITY) caben_.push_back(zona);
+    if (coste == coste_[zona]) continue;
+    coste_[zona] = coste;
+    version_[zona]++;
+    if (coste < INFINITY) cola_.push(Entrada{costeNueva_[zona] - coste, coste, zona, version_[zona]});
+  }
+}
+
+/**
+ * @brief Método para añadir a candidatas_ las zonas pendientes que pueden caber en una arista: insertar
+ *        una zona entre "desde" y "hasta" añade d(desde, zona) + d(zona, hasta) - d(desde, hasta), que no
+ *        puede pasar de la holgura de la ruta, así que la zona está dentro de una elipse de focos
+ *        "desde" y "hasta"
+ * @param desde Parada en la que empieza la arista
+ * @param hasta Parada en la que termina
+ * @param holgura Distancia que la ruta puede añadir como mucho
+ * @param arista Si es una arista nueva de la ruta (si no, sólo se busca dónde puede caber un tramo nuevo)
+ * @return void
+ */
+void InsercionArrepentimiento::anadirCandidatas(const Zona& desde, const Zona& hasta, double holgura, bool arista) {
+  if (holgura < 0) return;
+  const double suma = (desde.getDistancia(hasta) + holgura) * (1 + 1e-12); // Con margen de redondeo
+  cercanas_.enElipse(desde.getPosicion().first, desde.getPosicion().second, hasta.getPosicion().first, hasta.getPosicion().second, suma, ids_);
+  for (int zona : ids_) {
+    if (arista) cercaDeAristas_[zona] = repasos_;
+    if (repaso_[zona] == repasos_) continue;
+    repaso_[zona] = repasos_;
+    candidatas_.push_back(zona);
+  }
+}
+
+void InsercionArrepentimiento::retirarPendiente(int zona) {
+  pendiente_[zona] = 0;
+  cercanas_.eliminar(zona);
+}
+
+/**
+ * @brief Método para rehacer cada ruta con las mismas operaciones que el Constructor (moverVehiculo,
+ *        vaciarZona en cada zona, vaciarVehiculo en cada SWTS y volverAlInicio), para que el tiempo de los
+ *        vehículos y el contenido de las zonas y SWTS queden como los deja él
+ * @return void
+ */
+void InsercionArrepentimiento::guardarRutas() {
+  vector<Recoleccion> rutasDeVehiculos;
+  rutasDeVehiculos.reserve(indices_.size());
+  for (const vector<int>& indices : indices_) {
+    Recoleccion vehiculo(dato_.capacidadRecoleccion, dato_.velocidad, dato_.deposito(), dato_.duracionRecoleccion);
+    int posicion = dato_.indiceDeposito;
+    for (size_t p = 1; p + 1 < indices.size(); p++) {
+      Zona& zona = dato_.zonas[indices[p]];
+      vehiculo.moverVehiculo(zona, dato_.zonas[posicion].getDistancia(zona));
+      if (zona.esSWTS()) vehiculo.vaciarVehiculo(zona);
+      else vehiculo.vaciarZona(zona);
+      posicion = indices[p];
+    }
+    vehiculo.volverAlInicio();
+    rutasDeVehiculos.push_back(std::move(vehiculo));
+  }
+  dato_.zonasRecoleccion.clear(); // Todas las zonas de recolección han quedado visitadas
+  dato_.rutasRecoleccion = std::move(rutasDeVehiculos);
+}
@@ -0,0 +1,94 @@
+/**
+ * @class Construcción de las rutas de recolección por inserción con arrepentimiento, la alternativa de
+ *        Voraz al vecino más cercano. Las rutas se llenan de una en una: en cada paso se inserta, en su
+ *        mejor posición de la ruta abierta, la zona pendiente de mayor arrepentimiento, es decir, la que
+ *        más distancia añadiría si en vez de entrar en ella tuviera que ir en una ruta nueva (depósito,
+ *        zona, SWTS más cercana, depósito). Cuando ninguna pendiente cabe, la de ruta propia más larga
+ *        (la más alejada del depósito y de su SWTS) abre la ruta siguiente. Como sólo se abre una ruta
+ *        cuando en las anteriores no cabe ninguna zona pendiente, las anteriores ya no pueden recibir más
+ *        y la segunda mejor alternativa de cada zona es siempre la ruta nueva (regret-2).
+ *        El coste y la mejor posición de cada zona en la ruta abierta se guardan y las zonas están en una
+ *        cola de prioridad perezosa. Al insertar sólo se repasan las zonas que caben en la ruta y las que
+ *        están lo bastante cerca de sus aristas nuevas para caber en ellas (un IndiceEspacial), y de cada
+ *        una sólo se comprueban las aristas nuevas y la posición guardada (toda la ruta sólo si se ha
+ *        partido su arista o ya no cabe en ella). Sólo vuelven a la cola las zonas cuyo coste cambia; las
+ *        entradas antiguas se descartan al salir.
+ */
+
+#ifndef C_InsercionArrepentimiento_H
+#define C_InsercionArrepentimiento_H
+
+#include "../../tools/tools.h"
+#include "../../tools/indice_espacial/indice_espacial.h"
+#include "../insercion/insercion.h"
+#include <queue>
+#include <vector>
+
+class InsercionArrepentimiento {
+  public:
+    explicit InsercionArrepentimiento(Tools& dato) : dato_(dato) {}
+
+    void construir(); // Construye las rutas de recolección y las guarda en dato.rutasRecoleccion
+
+  private:
+    // Entrada de la cola: la de mayor arrepentimiento y, a igualdad, la de menor coste y menor índice
+    struct Entrada {
+      double arrepentimiento;
+      double coste;
+      int zona; // Posición en recoleccion_
+      unsigned version;
+      inline bool operator<(const Entrada& otra) const {
+        if (arrepentimiento != otra.arrepentimiento) return arrepentimiento < otra.arrepentimiento;
+        if (coste != otra.coste) return coste > otra.coste;
+        return zona > otra.zona;
+      }
+    };
+
+    void insertar(int zona);
+    void abrirRuta(int zona);
+    // Recalcula el coste de las pendientes en la ruta abierta tras poner "insertadas" paradas (la zona y, con 2, la
+    // SWTS de su tramo nuevo) en "posicion"
+    void actualizarRuta(size_t posicion, size_t insertadas);
+    void anadirCandidatas(const Zona& desde, const Zona& hasta, double holgura, bool arista = true); // Las que pueden caber en la arista
+    void retirarPendiente(int zona);
+    void guardarRutas(); // Rehace las rutas con las operaciones del Constructor y las deja en dato_
+
+    Tools& dato_;
+    EvaluadorInsercion evaluador_;
+
+    // Zonas de recolección (por su posición en recoleccion_) y SWTS más cercana a cada una
+    std::vector<int> recoleccion_, swts_;
+    std::vector<int> swtsCercana_;
+    std::vector<double> costeNueva_; // Distancia de una ruta sólo con la zona
+
+    // Estado de la construcción
+    std::vector<char> pendiente_;
+    IndiceEspacial cercanas_; // Zonas pendientes, para buscar las que pueden caber en una arista
+    std::vector<int> porLejania_; // Zonas de mayor a menor costeNueva_, para abrir las rutas
+    size_t siguienteLejana_ = 0;
+    std::vector<double> coste_; // Coste de cada zona en la ruta abierta (infinito si no cabe)
+    // Mejor arista de un tramo de la ruta abierta (kNinguna si no cabe en ninguna), con la distancia y el tiempo de
+    // viaje que añade
+    std::vector<size_t> posicion_;
+    std::vector<double> deltaArista_;
+    std::vector<int> tiempoArista_;
+    // Tramo nuevo con su SWTS más cercana detrás de la última SWTS: distancia y tiempo que añade (aunque no quepa),
+    // calculados con la última SWTS de "ancla_", y si añade menos que la arista
+    std::vector<double> deltaTramo_;
+    std::vector<int> tiempoTramo_;
+    std::vector<unsigned> ancla_;
+    unsigned anclas_ = 0;
+    std::vector<char> tramoNuevo_;
+    std::vector<unsigned> version_;
+    std::vector<int> caben_; // Zonas pendientes con coste finito en la ruta abierta
+    std::vector<int> candidatas_, ids_;
+    // Último repaso en el que se ha añadido cada zona a candidatas_ y en el que estaba cerca de las aristas nuevas
+    std::vector<unsigned> repaso_, cercaDeAristas_;
+    unsigned repasos_ = 0;
+    std::priority_queue<Entrada> cola_;
+    Recoleccion ruta_{0, 0, Zona(), 0}; // Ruta abierta
+    size_t ultima_ = 0; // Posición de su última SWTS
+    std::vector<std::vector<int>> indices_; // Índice en Tools::zonas de cada parada de cada ruta
+};
+
+#endif
@@ -4,21 +4,18 @@
 using namespace std;
 
 /**
- * @brief Método para buscar la mejor ruta en base al número de vehículos que tenga
+ * @brief Método para buscar la mejor ruta en base al número de vehículos que tenga y, a igualdad
+ *        de vehículos, a la distancia de recolección (Solucion::mejorQue)
  * @return Tools* Mejor ruta
  */
 
 shared_ptr<Tools> RVND::mejorRuta() {
-  shared_ptr<Tools> mejorRuta = nullptr;
-  double numVehiculos = INFINITY;
-  // Buscamos la mejor ruta
-  for (auto& busquedaLocal : busquedasLocales_) {
-    if ((busquedaLocal->rutasRecoleccion.size() + busquedaLocal->rutasTransporte.size()) < numVehiculos) {
-      numVehiculos = busquedaLocal->rutasRecoleccion.size() + busquedaLocal->rutasTransporte.size();
-      mejorRuta = busquedaLocal;
-    }
+  size_t mejor = 0;
+  // Buscamos la mejor ruta comparando las soluciones compactas
+  for (size_t i = 1; i < soluciones_.size(); i++) {
+    if (soluciones_[i].mejorQue(soluciones_[mejor])) mejor = i;
   }
-  return mejorRuta;
+  return busquedasLocales_.empty() ? nullptr : busquedasLocales_[mejor];
 }
 
 /**
@@ -26,16 +23,40 @@ shared_ptr<Tools> RVND::mejorRuta() {
  * @return void
  */
 void RVND::ejecutar() {
+  IntervaloTraza intervalo(Traza::global().activa() ? "RVND " + dato_->nombreInstancia : string(), "algoritmo");
   auto grasp = make_unique<Grasp>(mejoresZonasCercanas_, numeroEjecuciones_);
   grasp->setDato(*dato_);
+  if (semillaFijada_) grasp->setSemilla(semilla_);
+  grasp->setSeleccion(seleccion_, alfa_);
+  grasp->setHilos(hilos_);
+  grasp->setVecindarioParalelo(vecindarioParalelo_);
+  grasp->setTiempoLimite(tiempoLimite_);
+  grasp->setMemoRutas(memoRutas_);
+  grasp->setTramosExactos(tramosExactos_);
+  grasp->setLNS(lns_, busquedaLocal_);
+  grasp->setDescomposicion(descomposicion_);
+  grasp->setReencadenamiento(reencadenamiento_);
 
   auto start = chrono::high_resolution_clock::now();
   grasp->ejecutar();
   // Guardamos los datos de la instancia
   busquedasLocales_ = grasp->getDato(*dato_);
+  soluciones_ = grasp->getSoluciones(*dato_);
   
-  // Buscamos la mejor ruta
-  datos_.push_back(mejorRuta());
+  // Buscamos la mejor ruta. Se guarda una copia para acumular en ella las métricas de todas
+  // las ejecuciones de GRASP de la instancia sin alterar los resultados de Grasp.
+  shared_ptr<Tools> mejor;
+  {
+    AmbitoMemoria memoria(FaseMemoria::copiaInstancia);
+    mejor = make_shared<Tools>(*mejorRuta());
+  }
+  mejor->metricas = Metricas();
+  for (const auto& busquedaLocal : busquedasLocales_) {
+    mejor->metricas.acumular(busquedaLocal->metricas);
+    // Grasp deja la trayectoria de la mejor solución en la ejecución que la obtuvo
+    if (!busquedaLocal->convergencia.empty()) mejor->convergencia = busquedaLocal->convergencia;
+  }
+  datos_.push_back(mejor);
   distancias_.push_back(datos_.back()->calcularDistanciaRecoleccion());
   auto end = chrono::high_resolution_clock::now();
   dato_->tiempoCPU = std::chrono::duration<double>(end - start).count();
@@ -96,4 +117,6 @@ void RVND::mostrarResultados() {
   << setw(12) << mediaCPU
   << endl;
   cout << "------------------------------------------------------------" << endl;
+
+  mostrarMetricas(datos_);
 }
\ No newline at end of file
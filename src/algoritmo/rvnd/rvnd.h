@@ -7,6 +7,7 @@
 
 #include "../algoritmo.h"
 #include "../grasp/grasp.h"
+#include "../../solucion/solucion.h"
 
 class RVND : public Algoritmo {
   public:
@@ -20,10 +21,36 @@ class RVND : public Algoritmo {
     void mostrarResultados() override;
     std::shared_ptr<Tools> mejorRuta();
 
+    // Setters (se trasladan al GRASP interno)
+    inline void setSemilla(unsigned semilla) { semilla_ = semilla; semillaFijada_ = true; }
+    inline void setSeleccion(TipoSeleccion seleccion, double alfa) { seleccion_ = seleccion; alfa_ = alfa; }
+    inline void setHilos(int hilos) { hilos_ = hilos; }
+    inline void setVecindarioParalelo(bool activo) { vecindarioParalelo_ = activo; }
+    inline void setTiempoLimite(double segundos) { tiempoLimite_ = segundos; }
+    inline void setMemoRutas(int capacidad) { memoRutas_ = capacidad; }
+    inline void setTramosExactos(int maxZonas) { tramosExactos_ = maxZonas; }
+    inline void setLNS(const ConfiguracionLNS& lns, bool busquedaLocal = true) { lns_ = lns; busquedaLocal_ = busquedaLocal; }
+    inline void setDescomposicion(const ConfiguracionDescomposicion& descomposicion) { descomposicion_ = descomposicion; }
+    inline void setReencadenamiento(int elite) { reencadenamiento_ = elite; }
+
   private:
     int mejoresZonasCercanas_;
     int numeroEjecuciones_;
+    unsigned semilla_ = 0;
+    bool semillaFijada_ = false;
+    TipoSeleccion seleccion_ = TipoSeleccion::lrcCardinalidad;
+    double alfa_ = 0.2;
+    int hilos_ = 1;
+    bool vecindarioParalelo_ = false;
+    double tiempoLimite_ = 0.0;
+    int memoRutas_ = 0;
+    int tramosExactos_ = 0;
+    ConfiguracionLNS lns_;
+    bool busquedaLocal_ = true;
+    ConfiguracionDescomposicion descomposicion_;
+    int reencadenamiento_ = 0;
     std::vector<std::shared_ptr<Tools>> busquedasLocales_;
+    std::vector<Solucion> soluciones_; // Solución de cada elemento de busquedasLocales_
     std::vector<double> distancias_;
 };
 
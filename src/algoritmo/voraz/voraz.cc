@@ -1,94 +1,29 @@
 #include "voraz.h"
 #include "../../tools/tools.h"
+#include "../constructor/constructor.h"
+#include "../insercion_arrepentimiento/insercion_arrepentimiento.h"
+#include "../descomposicion/descomposicion.h"
 #include <iomanip>
 
 using namespace std;
 
-/**
- * @brief Método para obtener la zona más cercana al vehículo que no haya sido visitada aún.
- *        Para ello se calculara la distancia euclídea entre el vehículo y las zonas que no han sido visitadas.
- * @param vehiculo Vehículo que se va a mover
- * @return Zona más cercana al vehículo con su distancia
- */
-pair<Zona&, double> Voraz::zonaMasCercana(const Recoleccion& vehiculo) {
-  const vector<vector<double>>& distancias = dato_->distancias;
-  const Zona& zonaActual = vehiculo.getPosicion();
-  Zona* zonaCercana = nullptr; // Inicializo la zona más cercana
-  double minDistancia = INFINITY;
-  auto it = find(dato_->zonas.begin(), dato_->zonas.end(), zonaActual); // Obtengo la posicion de la zona
-
-  int index = distance(dato_->zonas.begin(), it);
-  for (size_t i = 0; i < distancias[index].size(); i++) {
-    if (distancias[index][i] < minDistancia &&
-        find(vehiculo.getZonasVisitadas().begin(), vehiculo.getZonasVisitadas().end(), dato_->zonas[i]) == vehiculo.getZonasVisitadas().end() &&
-        find(dato_->zonasRecoleccion.begin(), dato_->zonasRecoleccion.end(), dato_->zonas[i]) != dato_->zonasRecoleccion.end()) {
-      minDistancia = distancias[index][i];
-      zonaCercana = &dato_->zonas[i];
-    }
-  }
-  return pair<Zona&, double>(*zonaCercana, minDistancia);
-}
-
-/**
- * @brief Método para obtener la swts más cercana
- * @param vehiculo Vehículo que se va a mover
- * @return SWTS más cercana al vehículo con su distancia
- */
-pair<Zona&, double> Voraz::swtsMasCercana(const Recoleccion& vehiculo) {
-  const vector<vector<double>>& distancias = dato_->distancias;
-  const Zona& zonaActual = vehiculo.getPosicion();
-  Zona* swtsCercana = nullptr;
-  double minDistancia = INFINITY;
-
-  auto it = find(dato_->zonas.begin(), dato_->zonas.end(), zonaActual);
-
-  int posicion = distance(dato_->zonas.begin(), it);
-
-  for (size_t i = 0; i < distancias[posicion].size(); i++) {
-    Zona& zona = dato_->zonas[i];
-    if (!zona.esSWTS()) continue;
-    else {
-      if (distancias[posicion][i] < minDistancia) {
-        minDistancia = distancias[posicion][i];
-        swtsCercana = &dato_->zonas[i];
-      }
-    }
-  }
-  return pair<Zona&, double>(*swtsCercana, minDistancia);
-}
-
-/**
- * @brief Método para obtener el tiempo en que tarda el vehículo en volver al depósito pasando por las zonas y la swts más cercana
- * @param vehiculo Vehículo que se va a mover
- * @return Tiempo que tarda en volver al depósito
- */
-int Voraz::TiempoVolverDeposito(const Recoleccion& vehiculo) {
-  int tiempo = 0;
-  pair<Zona&, double> zonaTransferenciaCercana = swtsMasCercana(vehiculo);
-  pair<Zona&, double> zonaCercana = zonaMasCercana(vehiculo);
-
-  Recoleccion vehiculoAux = vehiculo;
-  vehiculoAux.setPosicion(zonaTransferenciaCercana.first);
-  // Tiempo que tarda en llegar a la zona más cercana
-  tiempo += vehiculo.calcularTiempo(vehiculo.getPosicion().getDistancia(zonaCercana.first));
-  // Tiempo que tarda en procesar la zona más cercana
-  tiempo += zonaCercana.first.getTiempoDeProcesado();
-  // Tiempo que tarda en llegar a la swts más cercana
-  tiempo += vehiculo.calcularTiempo(zonaCercana.first.getDistancia(zonaTransferenciaCercana.first));
-  // Tiempo que tarda en volver al depósito desde la swts más cercana
-  tiempo += vehiculoAux.calcularTiempo(dato_->zonas[0].getDistancia(vehiculoAux.getPosicion()));
-
-  return tiempo;
-}
-
 /**
  * @brief Método para construir las rutas de los vehículos de recolección
  * @return void
  */
 void Voraz::ejecutar() {
+  IntervaloTraza intervalo(Traza::global().activa() ? "Voraz " + dato_->nombreInstancia : string(), "algoritmo");
   auto start = chrono::high_resolution_clock::now();
-  calcularRutasRecoleccion(); // Calculamos las rutas de recolección
-  calcularRutasTransporte(); // Calculamos las rutas de transporte
+  {
+    MedidorFase medidor(dato_->metricas.construccion);
+    IntervaloTraza intervaloConstruccion("construccion", "construccion");
+    AmbitoMemoria memoria(FaseMemoria::construccion);
+    calcularRutasRecoleccion(); // Calculamos las rutas de recolección
+  }
+  {
+    MedidorFase medidor(dato_->metricas.transporte);
+    calcularRutasTransporte(); // Calculamos las rutas de transporte
+  }
   auto end = chrono::high_resolution_clock::now();
   dato_->tiempoCPU = round(chrono::duration_cast<chrono::duration<double>>(end - start).count() * 10000) / 10000.0;
   // dato_ no es propiedad de Voraz (apunta a una instancia gestionada por el llamador),
@@ -143,50 +78,39 @@ void Voraz::mostrarResultados() {
   << setw(12) << mediaCPU
   << endl;
   cout << "---------------------------------------------" << endl;
+
+  mostrarMetricas(datos_);
 }
 
 /**
- * @brief Método para calcular las rutas de los vehículos de recolección
+ * @brief Método para calcular las rutas de los vehículos de recolección: por defecto cada vehículo va
+ *        siempre a la zona pendiente más cercana (Constructor con PoliticaMasCercana); con
+ *        TipoConstruccion::insercion, por inserción con arrepentimiento (InsercionArrepentimiento). Con
+ *        grupos en descomposicion_, cada grupo de zonas se construye por separado y en paralelo.
  * @return void
  */
 void Voraz::calcularRutasRecoleccion() {
-  vector<Recoleccion> rutasDeVehiculos;
-  vector<Zona>& zonasPendientes = dato_->zonasRecoleccion;
+  if (descomposicion_.grupos <= 1) {
+    construirPendientes(*dato_);
+    return;
+  }
+  Descomposicion(*dato_, descomposicion_).construir(*dato_, hilos_, [&](Tools& grupo, size_t) { construirPendientes(grupo); });
+}
 
-  while (!zonasPendientes.empty()) {
-    // Creamos el vehículo
-    Recoleccion vehiculo(dato_->capacidadRecoleccion, dato_->velocidad, dato_->zonas[0], dato_->duracionRecoleccion);
-    do {
-      if (zonasPendientes.empty()) break;
-      pair<Zona&, double> zonaCercana = zonaMasCercana(vehiculo);
-      int tiempoEnVolverAlDeposito = TiempoVolverDeposito(vehiculo);
-      // Si el contendio de la zona es menor a la capacidad del vehículo y le da tiempo a volver al deposito
-      if (vehiculo.llenarVehiculo(zonaCercana.first.getContenido()) && tiempoEnVolverAlDeposito <= (vehiculo.getDuracion() - vehiculo.getTiempoTranscurrido())) {
-        vehiculo.moverVehiculo(zonaCercana.first, zonaCercana.second);
-        vehiculo.vaciarZona(zonaCercana.first);
-        zonasPendientes.erase(remove(zonasPendientes.begin(), zonasPendientes.end(), zonaCercana.first), zonasPendientes.end());
-      } else if (tiempoEnVolverAlDeposito <= (vehiculo.getDuracion() - vehiculo.getTiempoTranscurrido())) {
-        // Si no puede recoger la zona, buscamos la swts más cercana
-        pair<Zona&, double> swtsCercana = swtsMasCercana(vehiculo);
-        vehiculo.moverVehiculo(swtsCercana.first, swtsCercana.second);
-        vehiculo.vaciarVehiculo(swtsCercana.first);
-      } else {
-        break; // No se puede añadir más zonas
-      }
-    } while (true);
-    // Si la última zona visitada no es una swts, buscamos la más cercana
-    if (!vehiculo.getPosicion().esSWTS()) {
-      pair<Zona&, double> swtsCercana = swtsMasCercana(vehiculo);
-      vehiculo.moverVehiculo(swtsCercana.first, swtsCercana.second);
-      vehiculo.vaciarVehiculo(swtsCercana.first);
-      vehiculo.volverAlInicio();
-    }
-    else {
-      vehiculo.volverAlInicio();
-    }
-    rutasDeVehiculos.push_back(vehiculo);
+/**
+ * @brief Método para construir con construccion_ las rutas de las zonas pendientes de una instancia
+ * @param dato Instancia (o grupo de una Descomposicion)
+ * @return void
+ */
+void Voraz::construirPendientes(Tools& dato) {
+  switch (construccion_) {
+    case TipoConstruccion::vecinoMasCercano:
+      construirRutas(dato, PoliticaMasCercana{});
+      break;
+    case TipoConstruccion::insercion:
+      InsercionArrepentimiento(dato).construir();
+      break;
   }
-  dato_->rutasRecoleccion = std::move(rutasDeVehiculos); // Guardamos las rutas de los vehículos de recolección
 }
 
 /**
@@ -253,6 +177,8 @@ double Voraz::buscarCantidadMinima(const vector<Tarea>& tareas) {
  * @return void
  */
 void Voraz::calcularRutasTransporte() {
+  IntervaloTraza intervalo("transporte", "transporte");
+  AmbitoMemoria memoria(FaseMemoria::transporte);
   vector<Transporte> rutasDeVehiculos;
   vector<Tarea> tareas = crearConjuntoTareas(dato_->rutasRecoleccion);
   double cantidadMínima = buscarCantidadMinima(tareas);
@@ -265,7 +191,7 @@ void Voraz::calcularRutasTransporte() {
 
     if (vehiculo == nullptr) {
       // Si no hay vehículos disponibles, creamos uno nuevo
-      Transporte nuevoVehiculo(dato_->capacidadTransporte, dato_->velocidad, dato_->zonas[3], dato_->duracionTransporte);
+      Transporte nuevoVehiculo(dato_->capacidadTransporte, dato_->velocidad, dato_->vertedero(), dato_->duracionTransporte);
       nuevoVehiculo.moverVehiculo(tareaMinima.Sh, nuevoVehiculo.getPosicion().getDistancia(tareaMinima.Sh));
       // Llenamos el vehículo con la cantidad de la tarea
       nuevoVehiculo.agregarContenido(tareaMinima.Dh);
@@ -280,8 +206,8 @@ void Voraz::calcularRutasTransporte() {
       // Si la capacidad remanente es insuficiente para atender la tarea mínima
       if (vehiculo->getContenido() < cantidadMínima) {
         // Nos desplazamos al vertedero para vaciar el vehículo
-        vehiculo->moverVehiculo(dato_->zonas[3], vehiculo->getPosicion().getDistancia(dato_->zonas[3]));
-        vehiculo->vaciarVehiculo(dato_->zonas[3]); // Vaciar en el vertedero
+        vehiculo->moverVehiculo(dato_->vertedero(), vehiculo->getPosicion().getDistancia(dato_->vertedero()));
+        vehiculo->vaciarVehiculo(dato_->vertedero()); // Vaciar en el vertedero
       }
     }
   }
@@ -290,7 +216,7 @@ void Voraz::calcularRutasTransporte() {
     if (!vehiculo.getPosicion().esDumpsite()) {
       // Nos aseguramos que la ruta finalice en el vertedero
       vehiculo.volverAlInicio();
-      vehiculo.vaciarVehiculo(dato_->zonas[3]); // Vaciar en el vertedero
+      vehiculo.vaciarVehiculo(dato_->vertedero()); // Vaciar en el vertedero
     }
   }
   dato_->rutasTransporte = std::move(rutasDeVehiculos); // Guardamos las rutas de los vehículos de transporte
@@ -324,6 +250,7 @@ Transporte* Voraz::escogerVehiculo(vector<Transporte>& vehiculos, const Tarea& t
  */
 double Voraz::calcularCostoInsercion(const Tarea& tarea, Transporte& vehiculo) {
   int costo;
+  instrumentar([&] { dato_->metricas.nucleo.calcularCostoInsercion++; });
 
   // La cantidad de residuos del vehículo debe ser menor a la cantidad de residuos de la tarea
   if (!vehiculo.llenarVehiculo(tarea.Dh)) {
@@ -354,8 +281,8 @@ double Voraz::calcularCostoInsercion(const Tarea& tarea, Transporte& vehiculo) {
 int Voraz::tiempoVolverAlVertedero(const Transporte& vehiculo) {
   int tiempo = 0;
   Transporte vehiculoAux = vehiculo;
-  const vector<Tarea>& tareas = vehiculo.getTareasAsignadas();
-  vehiculoAux.setPosicion(dato_->zonas[3]); // Colocamos el vehículo en el vertedero
+  const pmr::vector<Tarea>& tareas = vehiculo.getTareasAsignadas();
+  vehiculoAux.setPosicion(dato_->vertedero()); // Colocamos el vehículo en el vertedero
   // Recorremos las tareas asignadas al vehículo
   auto it = tareas.begin();
   while (it != tareas.end()) {
@@ -379,6 +306,6 @@ int Voraz::tiempoVolverAlVertedero(const Transporte& vehiculo) {
   }
 
   // Agrego el tiempo que tarda en volver al vertedero
-  tiempo += vehiculo.calcularTiempo(vehiculo.getPosicion().getDistancia(dato_->zonas[3]));
+  tiempo += vehiculo.calcularTiempo(vehiculo.getPosicion().getDistancia(dato_->vertedero()));
   return tiempo;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "../algoritmo.h"
 #include "../../vehiculo/recoleccion/recoleccion.h"
 #include "../../vehiculo/transporte/transporte.h"
+#include "../../tools/opciones/opciones.h"
 
 class Voraz : public Algoritmo {
   public:
@@ -20,12 +21,11 @@ class Voraz : public Algoritmo {
     void calcularRutasRecoleccion(); // Método para calcular las rutas de recolección
     void calcularRutasTransporte(); // Método para calcular las rutas de transporte
 
-  private:
-    // Métodos para calcular el voraz de las rutas de recolección
-    std::pair<Zona&, double> zonaMasCercana(const Recoleccion& vehiculo); // Zona más cercana al vehículo
-    std::pair<Zona&, double> swtsMasCercana(const Recoleccion& vehiculo); // SWTS más cercana a la zona
-    int TiempoVolverDeposito(const Recoleccion& vehiculo); // Tiempo que tarda en volver al depósito pasando por las zonas y la swts más cercanas
+    // Setters
+    inline void setConstruccion(TipoConstruccion construccion) { construccion_ = construccion; }
+    inline void setDescomposicion(const ConfiguracionDescomposicion& descomposicion, int hilos) { descomposicion_ = descomposicion; hilos_ = hilos; } // Ver Descomposicion
 
+  private:
     // Métodos para calcular el voraz de las rutas de transporte
     std::vector<Tarea> crearConjuntoTareas(const std::vector<Recoleccion>& vehiculos);
     std::vector<Tarea> ordenarTareas(const std::vector<Tarea>& tareas);
@@ -33,6 +33,12 @@ class Voraz : public Algoritmo {
     double calcularCostoInsercion(const Tarea& tarea, Transporte& vehiculo); // Método para calcular el costo de inserción de una tarea en un vehículo
     int tiempoVolverAlVertedero(const Transporte& vehiculo);
     Transporte* escogerVehiculo(std::vector<Transporte>& vehiculos, const Tarea& tarea); // Escoger el vehículo que mínimice el costo de inserción
+
+    void construirPendientes(Tools& dato); // Construye con construccion_ las rutas de las zonas pendientes de dato
+
+    TipoConstruccion construccion_ = TipoConstruccion::vecinoMasCercano;
+    ConfiguracionDescomposicion descomposicion_; // Sin grupos = toda la instancia de una vez
+    int hilos_ = 1; // Hilos entre los que se reparten los grupos de descomposicion_
 };
 
 #endif
\ No newline at end of file
@@ -13,28 +13,43 @@ using namespace std;
 
 namespace {
 constexpr int kOpcionSalir = 4;
-const char* kRutaExportacionJSON = "resultados.json";
 } // namespace
 
 int main(int argc, char* argv[]) {
-  if (argc != 2) {
-    cerr << "Error: Número de argumentos incorrecto" << endl;
-    cerr << "Uso: " << argv[0] << " <directorio_de_instancias>" << endl;
+  Opciones opciones;
+  try {
+    opciones = parsearOpciones(argc, argv);
+  } catch (const invalid_argument& e) {
+    cerr << e.what() << endl;
+    mostrarUso(argv[0]);
     exit(1);
   }
-  string dirName = argv[1];
+  if (opciones.ayuda) {
+    mostrarUso(argv[0]);
+    return 0;
+  }
+  if (!opciones.traza.empty()) Traza::global().activar();
   try {
-    vector<Tools> datos = readData(dirName);
-    // Menú de opciones
-    mostrarMenu();
-    int opcion;
-    cin >> opcion;
-    if (opcion == kOpcionSalir) {
-      cout << "Fin del programa" << endl;
-      return 0;
+    vector<Tools> datos = leerInstancias(opciones.entrada, opciones.vecinos > 0 ? PrecisionDistancias::ninguna : opciones.precision);
+    // Sólo si se ha pedido una precisión reducida: con --sin-matriz no hay precisión de la que informar
+    if (opciones.precision != PrecisionDistancias::doble && opciones.precision != PrecisionDistancias::ninguna) {
+      for (const auto& dato : datos) mostrarPrecision(dato);
     }
-    unique_ptr<Algoritmo> algoritmo(crearAlgoritmo(opcion));
-    // Ejecutar el algoritmo para cada instancia del directorio
+    if (opciones.vecinos > 0) {
+      for (auto& dato : datos) dato.vecinos = make_shared<const GrafoVecinos>(dato.zonas, opciones.vecinos);
+    }
+    // Sin --algoritmo se pregunta con el menú de opciones
+    int opcion = opciones.algoritmo;
+    if (opcion == 0) {
+      mostrarMenu();
+      cin >> opcion;
+      if (opcion == kOpcionSalir) {
+        cout << "Fin del programa" << endl;
+        return 0;
+      }
+    }
+    unique_ptr<Algoritmo> algoritmo(crearAlgoritmo(opcion, opciones));
+    // Ejecutar el algoritmo para cada instancia de la entrada
     for (auto& dato : datos) {
       algoritmo->setDato(dato);
       algoritmo->ejecutar();
@@ -42,8 +57,13 @@ int main(int argc, char* argv[]) {
     // Muestro los resultados
     algoritmo->mostrarResultados();
     // Exporto los resultados a JSON para la visualización web (ver visualizacion/index.html)
-    exportarResultadosJSON(algoritmo->getDatos(), kRutaExportacionJSON);
-    cout << "Resultados exportados a " << kRutaExportacionJSON << endl;
+    exportarResultadosJSON(algoritmo->getDatos(), opciones.salida, opciones.compacto);
+    cout << "Resultados exportados a " << opciones.salida << endl;
+    if (!opciones.traza.empty()) {
+      Traza::global().exportar(opciones.traza);
+      cout << "Traza de la ejecución guardada en " << opciones.traza << endl;
+    }
+    if constexpr (kConteoMemoria) mostrarMemoria();
     cout << "Fin del programa" << endl;
   } catch (const exception& e) {
     cerr << e.what() << endl;
@@ -51,4 +71,4 @@ int main(int argc, char* argv[]) {
   }
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,129 @@
+#include "solucion.h"
+#include "../tools/tools.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Constructor de la clase: captura las rutas de recolección y de transporte de una instancia
+ * @param dato Instancia con las rutas ya calculadas
+ * @return Solucion
+ */
+Solucion::Solucion(const Tools& dato) : Solucion(dato, indicesDeZonas(dato)) {}
+
+/**
+ * @brief Constructor de la clase con la tabla de índices de las zonas ya calculada (para capturar
+ *        varias soluciones de la misma instancia sin rehacerla)
+ * @param dato Instancia con las rutas ya calculadas
+ * @param indices Posición de cada zona en dato.zonas, por identificador
+ * @return Solucion
+ */
+Solucion::Solucion(const Tools& dato, const unordered_map<string, int>& indices) {
+  auto capturar = [&](const Vehiculo& vehiculo) {
+    for (const Zona& zona : vehiculo.getZonasVisitadas()) paradas_.push_back(indices.at(zona.getId()));
+    inicios_.push_back(paradas_.size());
+    metadatos_.push_back(MetadatosRuta{vehiculo.capacidad_, vehiculo.velocidad_, vehiculo.duracion_, vehiculo.tiempoTotal_,
+                                       vehiculo.contenido_, indices.at(vehiculo.posicion_.getId())});
+  };
+  size_t paradas = 0;
+  for (const auto& vehiculo : dato.rutasRecoleccion) paradas += vehiculo.getZonasVisitadas().size();
+  for (const auto& vehiculo : dato.rutasTransporte) paradas += vehiculo.getZonasVisitadas().size();
+  paradas_.reserve(paradas);
+  inicios_.reserve(dato.rutasRecoleccion.size() + dato.rutasTransporte.size() + 1);
+  metadatos_.reserve(dato.rutasRecoleccion.size() + dato.rutasTransporte.size());
+  for (const auto& vehiculo : dato.rutasRecoleccion) capturar(vehiculo);
+  numRecoleccion_ = dato.rutasRecoleccion.size();
+  for (const auto& vehiculo : dato.rutasTransporte) {
+    capturar(vehiculo);
+    for (const Tarea& tarea : vehiculo.getTareasAsignadas()) tareas_.push_back(TareaCompacta{tarea.Dh, indices.at(tarea.Sh.getId()), tarea.Th});
+    iniciosTareas_.push_back(tareas_.size());
+  }
+  distanciaRecoleccion_ = dato.calcularDistanciaRecoleccion();
+}
+
+/**
+ * @brief Método para obtener la posición de cada zona de la instancia
+ * @param dato Instancia
+ * @return unordered_map<string, int> Posición en dato.zonas de cada identificador de zona
+ */
+unordered_map<string, int> Solucion::indicesDeZonas(const Tools& dato) {
+  unordered_map<string, int> indices;
+  indices.reserve(dato.zonas.size());
+  for (size_t i = 0; i < dato.zonas.size(); i++) indices.emplace(dato.zonas[i].getId(), static_cast<int>(i));
+  return indices;
+}
+
+/**
+ * @brief Método para obtener la firma de las rutas de recolección de una instancia: las paradas de cada
+ *        ruta como índices, con las rutas ordenadas lexicográficamente y separadas por -1. No depende
+ *        del orden de las rutas, pero sí del orden de las paradas dentro de cada una (que cambia su coste).
+ * @param dato Instancia con las rutas de recolección ya calculadas
+ * @param indices Posición de cada zona en dato.zonas, por identificador
+ * @return vector<int32_t> Firma de las rutas
+ */
+vector<int32_t> Solucion::firmaRecoleccion(const Tools& dato, const unordered_map<string, int>& indices) {
+  vector<vector<int32_t>> rutas;
+  rutas.reserve(dato.rutasRecoleccion.size());
+  size_t paradas = 0;
+  for (const auto& vehiculo : dato.rutasRecoleccion) {
+    rutas.emplace_back();
+    rutas.back().reserve(vehiculo.getZonasVisitadas().size());
+    for (const Zona& zona : vehiculo.getZonasVisitadas()) rutas.back().push_back(indices.at(zona.getId()));
+    paradas += rutas.back().size() + 1;
+  }
+  sort(rutas.begin(), rutas.end());
+  vector<int32_t> firma;
+  firma.reserve(paradas);
+  for (const auto& ruta : rutas) {
+    firma.insert(firma.end(), ruta.begin(), ruta.end());
+    firma.push_back(-1);
+  }
+  return firma;
+}
+
+/**
+ * @brief Método para reconstruir las rutas de una instancia a partir de la solución. "dato" debe ser
+ *        la misma instancia (u otra copia de ella) de la que se capturó.
+ * @param dato Instancia cuyas rutas se sustituyen
+ * @return void
+ */
+void Solucion::restaurar(Tools& dato) const {
+  auto reconstruir = [&](Vehiculo& vehiculo, size_t ruta) {
+    const MetadatosRuta& metadatos = metadatos_[ruta];
+    vehiculo.tiempoTotal_ = metadatos.tiempoTranscurrido;
+    vehiculo.contenido_ = metadatos.contenido;
+    vehiculo.zonasVisitadas_.clear();
+    vehiculo.zonasVisitadas_.reserve(inicios_[ruta + 1] - inicios_[ruta]);
+    for (int32_t parada : getParadas(ruta)) vehiculo.zonasVisitadas_.push_back(dato.zonas[parada]);
+  };
+  dato.rutasRecoleccion.clear();
+  dato.rutasRecoleccion.reserve(numRecoleccion_);
+  for (size_t r = 0; r < numRecoleccion_; r++) {
+    const MetadatosRuta& metadatos = metadatos_[r];
+    dato.rutasRecoleccion.emplace_back(metadatos.capacidad, metadatos.velocidad, dato.zonas[metadatos.posicion], metadatos.duracion);
+    reconstruir(dato.rutasRecoleccion.back(), r);
+  }
+  dato.rutasTransporte.clear();
+  dato.rutasTransporte.reserve(numRutasTransporte());
+  for (size_t t = 0; t < numRutasTransporte(); t++) {
+    const size_t r = numRecoleccion_ + t;
+    const MetadatosRuta& metadatos = metadatos_[r];
+    dato.rutasTransporte.emplace_back(metadatos.capacidad, metadatos.velocidad, dato.zonas[metadatos.posicion], metadatos.duracion);
+    Transporte& vehiculo = dato.rutasTransporte.back();
+    reconstruir(vehiculo, r);
+    for (uint32_t i = iniciosTareas_[t]; i < iniciosTareas_[t + 1]; i++) {
+      vehiculo.agregarTarea(Tarea{tareas_[i].cantidad, dato.zonas[tareas_[i].zona], tareas_[i].tiempo});
+    }
+  }
+}
+
+/**
+ * @brief Método para comparar dos soluciones con el criterio del problema: primero el número total
+ *        de vehículos y, a igualdad, la distancia de las rutas de recolección
+ * @param otra Solución con la que se compara
+ * @return true si esta solución es estrictamente mejor que "otra"
+ */
+bool Solucion::mejorQue(const Solucion& otra) const {
+  if (numVehiculos() != otra.numVehiculos()) return numVehiculos() < otra.numVehiculos();
+  return distanciaRecoleccion_ < otra.distanciaRecoleccion_;
+}
@@ -0,0 +1,83 @@
+/**
+ * @class Clase para guardar una solución completa (rutas de recolección y de transporte) en memoria
+ *        contigua: todas las paradas en un único vector de índices de zona, con el inicio de cada
+ *        ruta en otro (formato CSR), y los datos de cada vehículo en vectores aparte. Copiarla es
+ *        copiar unos pocos vectores de datos simples, por lo que sirve para guardar las mejores
+ *        soluciones y compararlas sin copiar los vehículos ni el Tools.
+ */
+
+#ifndef C_Solucion_H
+#define C_Solucion_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct Tools;
+
+class Solucion {
+  public:
+    // Constructores de la clase
+    Solucion() = default;
+    explicit Solucion(const Tools& dato); // Captura las rutas de "dato"
+    Solucion(const Tools& dato, const std::unordered_map<std::string, int>& indices); // Igual, con la tabla id -> posición ya hecha
+
+    // Métodos de la clase
+    void restaurar(Tools& dato) const; // Reconstruye las rutas de "dato" a partir de la solución
+    bool mejorQue(const Solucion& otra) const; // Menos vehículos o, con los mismos, menos distancia de recolección
+    static std::unordered_map<std::string, int> indicesDeZonas(const Tools& dato); // Posición de cada zona en dato.zonas
+    // Rutas de recolección de "dato" sin importar el orden de las rutas: dos construcciones con la misma firma son la misma
+    static std::vector<int32_t> firmaRecoleccion(const Tools& dato, const std::unordered_map<std::string, int>& indices);
+
+    // Getters
+    inline size_t numRutasRecoleccion() const { return numRecoleccion_; }
+    inline size_t numRutasTransporte() const { return metadatos_.size() - numRecoleccion_; }
+    inline size_t numVehiculos() const { return metadatos_.size(); }
+    inline double getDistanciaRecoleccion() const { return distanciaRecoleccion_; }
+    // Paradas de la ruta "ruta" (primero las de recolección, después las de transporte) como índices en dato.zonas
+    inline std::span<const int32_t> getParadas(size_t ruta) const {
+      return std::span<const int32_t>(paradas_.data() + inicios_[ruta], inicios_[ruta + 1] - inicios_[ruta]);
+    }
+
+    friend bool operator==(const Solucion& a, const Solucion& b) {
+      return a.numRecoleccion_ == b.numRecoleccion_ && a.inicios_ == b.inicios_ && a.paradas_ == b.paradas_;
+    }
+
+    // Hash de una firma (FNV-1a), para guardarlas en un unordered_set/map
+    struct HashFirma {
+      inline size_t operator()(const std::vector<int32_t>& firma) const {
+        uint64_t hash = 14695981039346656037ull;
+        for (int32_t valor : firma) hash = (hash ^ static_cast<uint32_t>(valor)) * 1099511628211ull;
+        return static_cast<size_t>(hash);
+      }
+    };
+
+  private:
+    // Datos de cada vehículo necesarios para reconstruirlo tal cual
+    struct MetadatosRuta {
+      int capacidad;
+      int velocidad;
+      int duracion;
+      int tiempoTranscurrido;
+      double contenido;
+      int32_t posicion; // Índice de la zona en la que está
+    };
+    // Tarea de un vehículo de transporte, con la zona como índice
+    struct TareaCompacta {
+      double cantidad;
+      int32_t zona;
+      int tiempo;
+    };
+
+    std::vector<int32_t> paradas_; // Paradas de todas las rutas seguidas
+    std::vector<uint32_t> inicios_{0}; // La ruta r ocupa paradas_[inicios_[r], inicios_[r + 1])
+    std::vector<MetadatosRuta> metadatos_; // Un elemento por ruta
+    std::vector<TareaCompacta> tareas_; // Tareas de todas las rutas de transporte seguidas
+    std::vector<uint32_t> iniciosTareas_{0}; // La ruta de transporte t ocupa tareas_[iniciosTareas_[t], iniciosTareas_[t + 1])
+    size_t numRecoleccion_ = 0;
+    double distanciaRecoleccion_ = 0.0;
+};
+
+#endif
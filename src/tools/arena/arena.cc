@@ -0,0 +1,60 @@
+#include "arena.h"
+#include <new>
+
+using namespace std;
+
+namespace {
+thread_local pmr::memory_resource* recursoActual = nullptr; // nullptr = el recurso global
+} // namespace
+
+/**
+ * @brief Función para obtener el recurso de memoria de los vehículos del hilo actual
+ * @return pmr::memory_resource* La arena activa del hilo o, si no hay, el operator new global
+ */
+pmr::memory_resource* recursoVehiculos() {
+  return recursoActual != nullptr ? recursoActual : pmr::new_delete_resource();
+}
+
+/**
+ * @brief Método para obtener el buffer inicial de las arenas del hilo. Crece hasta lo que necesitó
+ *        la iteración más grande, así que se reserva una vez por hilo y no una vez por iteración.
+ * @return vector<byte>& Buffer del hilo
+ */
+vector<byte>& ArenaIteracion::bufferHilo() {
+  thread_local vector<byte> buffer;
+  return buffer;
+}
+
+/**
+ * @brief Constructor de la clase: a partir de aquí los vehículos del hilo se asignan en la arena
+ * @return ArenaIteracion
+ */
+ArenaIteracion::ArenaIteracion()
+    : monotono_(bufferHilo().data(), bufferHilo().size(), &desborde_), pool_(&monotono_), anterior_(recursoActual) {
+  recursoActual = &pool_;
+}
+
+/**
+ * @brief Destructor de la clase. Si la iteración no cupo en el buffer, lo agranda para la siguiente.
+ *        Lo que quede asignado en la arena deja de ser válido.
+ */
+ArenaIteracion::~ArenaIteracion() {
+  recursoActual = anterior_;
+  pool_.release();
+  monotono_.release();
+  if (desborde_.bytes > 0) {
+    vector<byte>& buffer = bufferHilo();
+    const size_t nuevoTamano = buffer.size() + desborde_.bytes;
+    buffer = vector<byte>(); // Se libera antes de reservar el nuevo, para no tener ambos a la vez
+    buffer.resize(nuevoTamano);
+  }
+}
+
+void* ArenaIteracion::Desborde::do_allocate(size_t tamano, size_t alineacion) {
+  bytes += tamano;
+  return ::operator new(tamano, align_val_t(alineacion));
+}
+
+void ArenaIteracion::Desborde::do_deallocate(void* puntero, size_t tamano, size_t alineacion) {
+  ::operator delete(puntero, tamano, align_val_t(alineacion));
+}
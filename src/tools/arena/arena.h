@@ -0,0 +1,57 @@
+/**
+ * @class Arena de memoria para el estado temporal de una iteración (rutas de los vehículos, copias
+ *        de la búsqueda local...). Mientras existe, los vehículos que se crean o copian en el hilo
+ *        toman sus vectores de ella en vez del operator new global, y al destruirse se libera todo
+ *        de golpe. El buffer se reutiliza entre iteraciones del mismo hilo, por lo que a partir de la
+ *        primera apenas se pide memoria al sistema.
+ */
+
+#ifndef C_Arena_H
+#define C_Arena_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// Recurso del que los vehículos del hilo actual toman sus vectores (el global fuera de una arena)
+std::pmr::memory_resource* recursoVehiculos();
+
+class ArenaIteracion {
+  public:
+    ArenaIteracion();
+    ~ArenaIteracion(); // Restaura el recurso anterior y libera todo lo asignado en la arena
+
+    // No se puede copiar ni mover (los vehículos apuntan a ella)
+    ArenaIteracion(const ArenaIteracion&) = delete;
+    ArenaIteracion& operator=(const ArenaIteracion&) = delete;
+
+  private:
+    // Recurso que pide memoria al global y cuenta cuánta, para agrandar el buffer del hilo la próxima vez
+    class Desborde : public std::pmr::memory_resource {
+      public:
+        size_t bytes = 0;
+
+      private:
+        void* do_allocate(size_t tamano, size_t alineacion) override;
+        void do_deallocate(void* puntero, size_t tamano, size_t alineacion) override;
+        bool do_is_equal(const std::pmr::memory_resource& otro) const noexcept override { return this == &otro; }
+    };
+
+    static std::vector<std::byte>& bufferHilo(); // Buffer inicial de las arenas del hilo actual
+
+    Desborde desborde_;
+    std::pmr::monotonic_buffer_resource monotono_;
+    std::pmr::unsynchronized_pool_resource pool_; // Reutiliza lo liberado dentro de la iteración (copias de rutas)
+    std::pmr::memory_resource* anterior_;
+};
+
+// Copia los vehículos con sus vectores en "recurso" (p.ej. para sacar el resultado de una arena antes de destruirla)
+template <typename VehiculoT>
+void reubicarVehiculos(std::vector<VehiculoT>& vehiculos, std::pmr::memory_resource* recurso) {
+  std::vector<VehiculoT> copia;
+  copia.reserve(vehiculos.size());
+  for (const VehiculoT& vehiculo : vehiculos) copia.emplace_back(vehiculo, recurso);
+  vehiculos = std::move(copia);
+}
+
+#endif
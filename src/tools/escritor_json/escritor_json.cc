@@ -0,0 +1,88 @@
+#include "escritor_json.h"
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief Constructor de la clase
+ * @param rutaSalida Ruta del fichero JSON de salida
+ * @param tamanoBuffer Tamaño del buffer en bytes
+ * @throws std::runtime_error si no se puede crear el fichero
+ */
+EscritorJSON::EscritorJSON(const std::string& rutaSalida, size_t tamanoBuffer) : salida_(rutaSalida, std::ios::binary), buffer_(tamanoBuffer) {
+  if (!salida_.is_open()) {
+    throw std::runtime_error("Error: No se pudo crear el fichero de salida " + rutaSalida);
+  }
+}
+
+/**
+ * @brief Destructor de la clase, vuelca lo que quede pendiente en el buffer
+ */
+EscritorJSON::~EscritorJSON() {
+  volcar();
+}
+
+/**
+ * @brief Método para escribir un texto tal cual
+ * @param texto Texto a escribir
+ * @return void
+ */
+void EscritorJSON::literal(std::string_view texto) {
+  if (texto.size() > buffer_.size()) {
+    volcar();
+    salida_.write(texto.data(), texto.size());
+    return;
+  }
+  reservar(texto.size());
+  std::memcpy(buffer_.data() + usado_, texto.data(), texto.size());
+  usado_ += texto.size();
+}
+
+/**
+ * @brief Método para escribir una cadena JSON, escapando comillas y barras invertidas
+ * @param texto Texto a escribir
+ * @return void
+ */
+void EscritorJSON::cadena(std::string_view texto) {
+  reservar(2 * texto.size() + 2);
+  buffer_[usado_++] = '"';
+  for (char c : texto) {
+    if (c == '"' || c == '\\') buffer_[usado_++] = '\\';
+    buffer_[usado_++] = c;
+  }
+  buffer_[usado_++] = '"';
+}
+
+/**
+ * @brief Método para escribir un número real con la representación más corta que lo identifica
+ * @param valor Número a escribir
+ * @return void
+ */
+void EscritorJSON::numero(double valor) {
+  if (!std::isfinite(valor)) {
+    literal("null"); // JSON no admite inf ni nan
+    return;
+  }
+  reservar(32);
+  auto resultado = std::to_chars(buffer_.data() + usado_, buffer_.data() + buffer_.size(), valor);
+  usado_ = resultado.ptr - buffer_.data();
+}
+
+/**
+ * @brief Método para volcar el buffer en el fichero
+ * @return void
+ */
+void EscritorJSON::volcar() {
+  if (usado_ == 0) return;
+  salida_.write(buffer_.data(), usado_);
+  usado_ = 0;
+}
+
+/**
+ * @brief Método para garantizar que caben "bytes" más en el buffer
+ * @param bytes Número de bytes que se van a escribir
+ * @return void
+ */
+void EscritorJSON::reservar(size_t bytes) {
+  if (usado_ + bytes > buffer_.size()) volcar();
+  if (bytes > buffer_.size()) buffer_.resize(bytes);
+}
@@ -0,0 +1,47 @@
+/**
+ * @class Clase para escribir ficheros JSON de forma eficiente, acumulando la salida en un buffer
+ *        y convirtiendo los números con std::to_chars en vez de usar "ofstream <<" campo a campo
+ */
+
+#ifndef C_EscritorJSON_H
+#define C_EscritorJSON_H
+
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+class EscritorJSON {
+  public:
+    // Constructor y destructor de la clase (el destructor vuelca lo que quede en el buffer)
+    EscritorJSON(const std::string& rutaSalida, size_t tamanoBuffer = 1 << 16);
+    ~EscritorJSON();
+
+    // No se puede copiar (es dueño del fichero)
+    EscritorJSON(const EscritorJSON&) = delete;
+    EscritorJSON& operator=(const EscritorJSON&) = delete;
+
+    // Métodos de la clase
+    void literal(std::string_view texto); // Escribe el texto tal cual (llaves, comas, claves...)
+    void cadena(std::string_view texto); // Escribe el texto entre comillas, escapado para JSON
+    void numero(double valor); // Escribe un número real (null si no es finito)
+    template <typename Entero, typename = std::enable_if_t<std::is_integral_v<Entero>>>
+    void numero(Entero valor) {
+      reservar(24);
+      auto resultado = std::to_chars(buffer_.data() + usado_, buffer_.data() + buffer_.size(), valor);
+      usado_ = resultado.ptr - buffer_.data();
+    }
+    void volcar(); // Escribe el contenido del buffer en el fichero
+
+  private:
+    void reservar(size_t bytes); // Garantiza que quepan "bytes" más en el buffer, volcando si es necesario
+
+    std::ofstream salida_;
+    std::vector<char> buffer_;
+    size_t usado_ = 0;
+};
+
+#endif
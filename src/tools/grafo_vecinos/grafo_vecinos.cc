@@ -0,0 +1,53 @@
+#include "grafo_vecinos.h"
+#include "../indice_espacial/indice_espacial.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Constructor del grafo: busca las k vecinas de cada zona con un IndiceEspacial, en O(n·k) de
+ *        memoria y sin calcular la matriz de distancias
+ * @param zonas Zonas de la instancia (Tools::zonas)
+ * @param k Número de vecinas de cada zona
+ * @throws std::invalid_argument si k no es positivo
+ */
+GrafoVecinos::GrafoVecinos(const std::vector<Zona>& zonas, int k) : k_(k) {
+  if (k <= 0) throw std::invalid_argument("Error: El número de vecinos del grafo debe ser positivo");
+  std::vector<IndiceEspacial::Punto> puntos;
+  puntos.reserve(zonas.size());
+  for (size_t i = 0; i < zonas.size(); i++) {
+    puntos.push_back({static_cast<double>(zonas[i].getPosicion().first), static_cast<double>(zonas[i].getPosicion().second), static_cast<int>(i)});
+    indices_.emplace(zonas[i].getId(), static_cast<int>(i));
+  }
+  const IndiceEspacial indice(puntos);
+  vecinos_.assign(zonas.size() * k_, -1);
+  longitudes_.assign(zonas.size(), 0);
+  std::vector<std::pair<double, int>> cercanas;
+  for (const IndiceEspacial::Punto& punto : puntos) {
+    indice.masCercanos(punto.x, punto.y, k_, cercanas, punto.id);
+    longitudes_[punto.id] = static_cast<int>(cercanas.size());
+    for (size_t v = 0; v < cercanas.size(); v++) vecinos_[static_cast<size_t>(punto.id) * k_ + v] = cercanas[v].second;
+  }
+}
+
+/**
+ * @brief Método para saber si dos zonas son vecinas en el grafo (en cualquiera de los dos sentidos)
+ * @param i Índice de una zona (-1 no es vecina de ninguna)
+ * @param j Índice de la otra
+ * @return true si j está entre las k más cercanas a i o i entre las k más cercanas a j
+ */
+bool GrafoVecinos::sonVecinos(int i, int j) const {
+  if (i < 0 || j < 0) return false;
+  const std::span<const int> deI = vecinos(i), deJ = vecinos(j);
+  return std::find(deI.begin(), deI.end(), j) != deI.end() || std::find(deJ.begin(), deJ.end(), i) != deJ.end();
+}
+
+/**
+ * @brief Método para obtener el índice de una zona a partir de su identificador
+ * @param zona Zona
+ * @return int Índice de la zona en Tools::zonas, o -1 si no es de la instancia
+ */
+int GrafoVecinos::indice(const Zona& zona) const {
+  const auto posicion = indices_.find(zona.getId());
+  return posicion == indices_.end() ? -1 : posicion->second;
+}
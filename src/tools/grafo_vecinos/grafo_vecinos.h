@@ -0,0 +1,36 @@
+/**
+ * @class Grafo disperso de vecinos de una instancia: para cada zona, sus k zonas más cercanas (en orden
+ *        de distancia, a igualdad por índice), guardadas en un único vector (n·k enteros en vez de la
+ *        matriz n² de distancias). El resto de distancias no se guarda: se calculan con las coordenadas
+ *        de las zonas cuando hacen falta (Zona::getDistancia). Lo usa la búsqueda local para restringir
+ *        los movimientos entre rutas a los que dejan una zona junto a una de sus vecinas.
+ */
+
+#ifndef C_GrafoVecinos_H
+#define C_GrafoVecinos_H
+
+#include "../../zona/zona.h"
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GrafoVecinos {
+  public:
+    GrafoVecinos(const std::vector<Zona>& zonas, int k);
+
+    inline int k() const { return k_; }
+    inline size_t numZonas() const { return indices_.size(); }
+    // Vecinas de la zona i (índices en Tools::zonas), de la más cercana a la más lejana
+    inline std::span<const int> vecinos(int i) const { return std::span<const int>(vecinos_.data() + static_cast<size_t>(i) * k_, longitudes_[i]); }
+    bool sonVecinos(int i, int j) const; // j está entre las vecinas de i o i entre las de j
+    int indice(const Zona& zona) const; // Índice de la zona en Tools::zonas (-1 si no es de la instancia)
+
+  private:
+    int k_;
+    std::vector<int> vecinos_; // Vecinas de la zona i en [i·k, i·k + longitudes_[i])
+    std::vector<int> longitudes_; // Menos de k si la instancia tiene menos de k + 1 zonas
+    std::unordered_map<std::string, int> indices_;
+};
+
+#endif
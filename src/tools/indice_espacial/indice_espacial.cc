@@ -0,0 +1,206 @@
+#include "indice_espacial.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Mismo redondeo que Zona::getDistancia (las coordenadas son enteras, así que dx * dx es exacto)
+inline double distancia(double x1, double y1, double x2, double y2) {
+  const double dx = x1 - x2, dy = y1 - y2;
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+// Mete (distancia, id) en la lista ordenada si está entre las k primeras
+inline void insertarCandidato(std::vector<std::pair<double, int>>& lista, size_t k, double d, int id) {
+  const std::pair<double, int> candidato(d, id);
+  if (lista.size() == k) {
+    if (!(candidato < lista.back())) return;
+    lista.pop_back();
+  }
+  lista.insert(std::upper_bound(lista.begin(), lista.end(), candidato), candidato);
+}
+
+} // namespace
+
+/**
+ * @brief Constructor del índice
+ * @param puntos Puntos a indexar (los identificadores no se pueden repetir)
+ */
+IndiceEspacial::IndiceEspacial(const std::vector<Punto>& puntos) {
+  int maxId = -1;
+  for (const Punto& punto : puntos) maxId = std::max(maxId, punto.id);
+  celdaDe_.assign(maxId + 1, -1);
+  construir(puntos);
+}
+
+/**
+ * @brief Reparte los puntos en una rejilla de unos dos puntos por celda. El lado de la celda no baja de
+ *        max(ancho, alto) / n, para que las instancias alargadas no tengan más celdas que puntos.
+ * @param puntos Puntos que quedan en el índice
+ * @return void
+ */
+void IndiceEspacial::construir(const std::vector<Punto>& puntos) {
+  tamano_ = tamanoConstruccion_ = puntos.size();
+  celdas_.clear();
+  columnas_ = filas_ = 0;
+  if (puntos.empty()) return;
+  double minX = puntos[0].x, maxX = puntos[0].x, minY = puntos[0].y, maxY = puntos[0].y;
+  for (const Punto& punto : puntos) {
+    minX = std::min(minX, punto.x);
+    maxX = std::max(maxX, punto.x);
+    minY = std::min(minY, punto.y);
+    maxY = std::max(maxY, punto.y);
+  }
+  const double ancho = std::max(maxX - minX, 1.0), alto = std::max(maxY - minY, 1.0);
+  const double n = static_cast<double>(puntos.size());
+  x0_ = minX;
+  y0_ = minY;
+  lado_ = std::max(std::sqrt(ancho * alto / std::max(n / 2.0, 1.0)), std::max(ancho, alto) / n);
+  columnas_ = static_cast<int>(ancho / lado_) + 1;
+  filas_ = static_cast<int>(alto / lado_) + 1;
+  celdas_.assign(static_cast<size_t>(columnas_) * filas_, {});
+  for (const Punto& punto : puntos) {
+    const int columna = std::min(static_cast<int>((punto.x - x0_) / lado_), columnas_ - 1);
+    const int fila = std::min(static_cast<int>((punto.y - y0_) / lado_), filas_ - 1);
+    const int indice = celda(columna, fila);
+    celdas_[indice].push_back(punto);
+    celdaDe_[punto.id] = indice;
+  }
+}
+
+/**
+ * @brief Quita un punto del índice. Cuando queda menos de la cuarta parte de los puntos con los que se
+ *        construyó la rejilla, se reconstruye con celdas más grandes para no recorrer celdas vacías.
+ * @param id Identificador del punto
+ * @return void
+ */
+void IndiceEspacial::eliminar(int id) {
+  if (id < 0 || id >= static_cast<int>(celdaDe_.size()) || celdaDe_[id] < 0) return;
+  std::vector<Punto>& puntos = celdas_[celdaDe_[id]];
+  const auto posicion = std::find_if(puntos.begin(), puntos.end(), [id](const Punto& punto) { return punto.id == id; });
+  *posicion = puntos.back();
+  puntos.pop_back();
+  celdaDe_[id] = -1;
+  tamano_--;
+  if (tamanoConstruccion_ >= 64 && tamano_ * 4 < tamanoConstruccion_) {
+    std::vector<Punto> quedan;
+    quedan.reserve(tamano_);
+    for (const std::vector<Punto>& celda : celdas_) quedan.insert(quedan.end(), celda.begin(), celda.end());
+    construir(quedan);
+  }
+}
+
+/**
+ * @brief Recorre la rejilla por anillos de celdas alrededor de la del punto (x, y), llamando a
+ *        visitar(punto) con cada punto, hasta que terminado(cota) es cierto, siendo cota la distancia
+ *        mínima desde (x, y) a las celdas sin visitar, o hasta que no quedan celdas.
+ * @return void
+ */
+template<typename Visitar, typename Terminado>
+void IndiceEspacial::recorrer(double x, double y, Visitar visitar, Terminado terminado) const {
+  if (tamano_ == 0) return;
+  const int cx = std::clamp(static_cast<int>(std::floor((x - x0_) / lado_)), 0, columnas_ - 1);
+  const int cy = std::clamp(static_cast<int>(std::floor((y - y0_) / lado_)), 0, filas_ - 1);
+  const auto visitarCelda = [&](int columna, int fila) {
+    for (const Punto& punto : celdas_[celda(columna, fila)]) visitar(punto);
+  };
+  for (int r = 0;; r++) {
+    for (int fila = std::max(cy - r, 0); fila <= std::min(cy + r, filas_ - 1); fila++) {
+      if (fila == cy - r || fila == cy + r) {
+        for (int columna = std::max(cx - r, 0); columna <= std::min(cx + r, columnas_ - 1); columna++) visitarCelda(columna, fila);
+      } else {
+        if (cx - r >= 0) visitarCelda(cx - r, fila);
+        if (cx + r < columnas_) visitarCelda(cx + r, fila);
+      }
+    }
+    // Las celdas sin visitar quedan fuera del cuadrado de anillos recorridos
+    double cota = std::numeric_limits<double>::infinity();
+    if (cx - r > 0) cota = std::min(cota, x - (x0_ + (cx - r) * lado_));
+    if (cx + r < columnas_ - 1) cota = std::min(cota, x0_ + (cx + r + 1) * lado_ - x);
+    if (cy - r > 0) cota = std::min(cota, y - (y0_ + (cy - r) * lado_));
+    if (cy + r < filas_ - 1) cota = std::min(cota, y0_ + (cy + r + 1) * lado_ - y);
+    if (std::isinf(cota)) return;
+    // Con margen de redondeo, y la comparación que haga terminado debe ser estricta: un punto a la misma
+    // distancia fuera del cuadrado puede tener menor id
+    if (terminado(cota - 1e-9 * lado_)) return;
+  }
+}
+
+/**
+ * @brief Los k puntos más cercanos a (x, y)
+ * @param x Coordenada x de la consulta
+ * @param y Coordenada y de la consulta
+ * @param k Número de puntos
+ * @param lista Lista en la que se dejan los puntos con su distancia, ordenados por (distancia, id)
+ * @param excluir Identificador que no se devuelve (la propia zona de la consulta), o -1
+ * @return void
+ */
+void IndiceEspacial::masCercanos(double x, double y, size_t k, std::vector<std::pair<double, int>>& lista, int excluir) const {
+  lista.clear();
+  if (k == 0) return;
+  recorrer(x, y,
+    [&](const Punto& punto) {
+      if (punto.id != excluir) insertarCandidato(lista, k, distancia(x, y, punto.x, punto.y), punto.id);
+    },
+    [&](double cota) { return lista.size() == k && lista.back().first < cota; });
+}
+
+/**
+ * @brief El punto más cercano a (x, y) (a igual distancia, el de menor id)
+ * @param x Coordenada x de la consulta
+ * @param y Coordenada y de la consulta
+ * @param excluir Identificador que no se devuelve, o -1
+ * @return int Identificador del punto, o -1 si el índice está vacío
+ */
+int IndiceEspacial::masCercano(double x, double y, int excluir) const {
+  std::pair<double, int> mejor(std::numeric_limits<double>::infinity(), -1);
+  recorrer(x, y,
+    [&](const Punto& punto) {
+      if (punto.id == excluir) return;
+      const std::pair<double, int> candidato(distancia(x, y, punto.x, punto.y), punto.id);
+      if (mejor.second < 0 || candidato < mejor) mejor = candidato;
+    },
+    [&](double cota) { return mejor.second >= 0 && mejor.first < cota; });
+  return mejor.second;
+}
+
+/**
+ * @brief Identificadores de los puntos que quedan en el índice
+ * @param ids Vector en el que se dejan, en orden creciente
+ * @return void
+ */
+void IndiceEspacial::identificadores(std::vector<int>& ids) const {
+  ids.clear();
+  ids.reserve(tamano_);
+  for (const std::vector<Punto>& celda : celdas_) {
+    for (const Punto& punto : celda) ids.push_back(punto.id);
+  }
+  std::sort(ids.begin(), ids.end());
+}
+
+/**
+ * @brief Puntos dentro de una elipse: recorre las celdas del cuadrado que contiene al círculo de radio
+ *        suma / 2 centrado en el punto medio de los focos (la elipse está dentro de él)
+ * @param ax Coordenada x del primer foco
+ * @param ay Coordenada y del primer foco
+ * @param bx Coordenada x del segundo foco
+ * @param by Coordenada y del segundo foco
+ * @param suma Suma máxima de las distancias a los dos focos
+ * @param ids Vector en el que se dejan los identificadores
+ * @return void
+ */
+void IndiceEspacial::enElipse(double ax, double ay, double bx, double by, double suma, std::vector<int>& ids) const {
+  ids.clear();
+  if (tamano_ == 0 || !(suma >= distancia(ax, ay, bx, by))) return;
+  const double cx = (ax + bx) / 2, cy = (ay + by) / 2, radio = suma / 2;
+  const auto columna = [&](double x) { return static_cast<int>(std::clamp(std::floor((x - x0_) / lado_), 0.0, columnas_ - 1.0)); };
+  const auto fila = [&](double y) { return static_cast<int>(std::clamp(std::floor((y - y0_) / lado_), 0.0, filas_ - 1.0)); };
+  for (int f = fila(cy - radio); f <= fila(cy + radio); f++) {
+    for (int c = columna(cx - radio); c <= columna(cx + radio); c++) {
+      for (const Punto& punto : celdas_[celda(c, f)]) {
+        if (distancia(ax, ay, punto.x, punto.y) + distancia(punto.x, punto.y, bx, by) <= suma) ids.push_back(punto.id);
+      }
+    }
+  }
+}
@@ -0,0 +1,50 @@
+/**
+ * @class Índice espacial de rejilla uniforme sobre las coordenadas de un conjunto de zonas. Responde a
+ *        las consultas de la zona más cercana y de las k más cercanas a un punto, y permite eliminar
+ *        zonas a medida que se visitan. No necesita la matriz de distancias: las distancias se calculan
+ *        al consultar, con la misma fórmula que Zona::getDistancia, por lo que coinciden exactamente con
+ *        las de la matriz y los empates se resuelven igual (a igual distancia, el menor identificador).
+ */
+
+#ifndef C_IndiceEspacial_H
+#define C_IndiceEspacial_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class IndiceEspacial {
+  public:
+    struct Punto {
+      double x, y;
+      int id; // Identificador no negativo (el índice de la zona en Tools::zonas)
+    };
+
+    IndiceEspacial() = default;
+    explicit IndiceEspacial(const std::vector<Punto>& puntos);
+
+    void eliminar(int id); // Quita el punto (no hace nada si ya no está)
+    inline size_t tamano() const { return tamano_; }
+    inline bool vacio() const { return tamano_ == 0; }
+
+    int masCercano(double x, double y, int excluir = -1) const; // -1 si no queda ninguno
+    void masCercanos(double x, double y, size_t k, std::vector<std::pair<double, int>>& lista, int excluir = -1) const; // Ordenados por (distancia, id)
+    void identificadores(std::vector<int>& ids) const; // Los que quedan, en orden creciente
+    // Los que están dentro de la elipse de focos a y b: d(a, p) + d(p, b) <= suma (en el orden de la rejilla)
+    void enElipse(double ax, double ay, double bx, double by, double suma, std::vector<int>& ids) const;
+
+  private:
+    void construir(const std::vector<Punto>& puntos);
+    template<typename Visitar, typename Terminado>
+    void recorrer(double x, double y, Visitar visitar, Terminado terminado) const; // Definida en el .cc
+    inline int celda(int columna, int fila) const { return fila * columnas_ + columna; }
+
+    double x0_ = 0.0, y0_ = 0.0, lado_ = 1.0; // Origen y lado de las celdas
+    int columnas_ = 0, filas_ = 0;
+    std::vector<std::vector<Punto>> celdas_;
+    std::vector<int> celdaDe_; // Celda de cada id (-1 si no está)
+    size_t tamano_ = 0;
+    size_t tamanoConstruccion_ = 0; // Puntos al construir la rejilla: se reconstruye cuando quedan pocos
+};
+
+#endif
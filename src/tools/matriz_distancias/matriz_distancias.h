@@ -0,0 +1,98 @@
+/**
+ * @class Matriz de distancias entre las zonas de una instancia, guardada en un único bloque de n·n
+ *        valores del tipo T: double (exacta), float, o entero sin signo en coma fija (uint32_t,
+ *        uint16_t), donde el valor guardado es round(distancia / paso) y el mayor valor del tipo
+ *        representa la diagonal (infinito). Con float o uint16_t un recorrido de una fila lee la mitad o
+ *        la cuarta parte de bytes que con double, a cambio de un error acotado por errorMaximo().
+ *        Los datos son inmutables y las copias los comparten, así que copiar el Tools no copia la matriz.
+ */
+
+#ifndef C_MatrizDistancias_H
+#define C_MatrizDistancias_H
+
+#include "../../zona/zona.h"
+#include "../opciones/opciones.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+template<typename T>
+class MatrizDistancias {
+  public:
+    static_assert(std::is_floating_point_v<T> || std::is_unsigned_v<T>, "MatrizDistancias: T debe ser de coma flotante o entero sin signo");
+    using Valor = T;
+    static constexpr bool kCompacta = !std::is_floating_point_v<T>; // Coma fija
+    static constexpr T kInfinito = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+
+    MatrizDistancias() = default;
+    explicit MatrizDistancias(const std::vector<Zona>& zonas);
+
+    inline size_t numZonas() const { return n_; }
+    inline const T* fila(size_t i) const { return datos_->data() + i * n_; } // Valores guardados, sin decodificar
+    inline double operator()(size_t i, size_t j) const { return decodificar(fila(i)[j]); }
+    inline double decodificar(T valor) const {
+      if constexpr (kCompacta) return valor == kInfinito ? INFINITY : valor * paso_;
+      else return valor;
+    }
+    inline double errorMaximo() const { return error_; } // Cota del error absoluto de cada distancia
+    inline size_t bytes() const { return n_ * n_ * sizeof(T); }
+
+  private:
+    size_t n_ = 0;
+    double paso_ = 1.0; // Distancia que representa una unidad en coma fija
+    double error_ = 0.0;
+    std::shared_ptr<const std::vector<T>> datos_;
+};
+
+/**
+ * @brief Constructor: calcula las distancias entre todas las zonas con Zona::getDistancia (infinito en
+ *        la diagonal). La diagonal del rectángulo que contiene a las zonas acota cualquier distancia: en
+ *        coma fija el paso se elige para que quepa en el tipo, y de ella sale la cota del error.
+ * @param zonas Zonas de la instancia
+ */
+template<typename T>
+MatrizDistancias<T>::MatrizDistancias(const std::vector<Zona>& zonas) : n_(zonas.size()) {
+  int minX = 0, maxX = 0, minY = 0, maxY = 0;
+  if (!zonas.empty()) {
+    minX = maxX = zonas[0].getPosicion().first;
+    minY = maxY = zonas[0].getPosicion().second;
+  }
+  for (const Zona& zona : zonas) {
+    minX = std::min(minX, zona.getPosicion().first);
+    maxX = std::max(maxX, zona.getPosicion().first);
+    minY = std::min(minY, zona.getPosicion().second);
+    maxY = std::max(maxY, zona.getPosicion().second);
+  }
+  const double diagonal = std::max(std::hypot(double(maxX - minX), double(maxY - minY)), 1.0);
+  if constexpr (kCompacta) {
+    paso_ = diagonal / (static_cast<double>(kInfinito) - 1.0);
+    error_ = paso_ / 2.0; // Redondeo al entero más próximo
+  } else if constexpr (std::is_same_v<T, float>) {
+    error_ = std::ldexp(diagonal, -24); // Redondeo al float más próximo: medio ulp de la mayor distancia
+  }
+  std::vector<T> datos(n_ * n_, kInfinito);
+  for (size_t i = 0; i < n_; i++) {
+    for (size_t j = 0; j < n_; j++) {
+      if (i == j) continue;
+      const double distancia = zonas[i].getDistancia(zonas[j]);
+      if constexpr (kCompacta) {
+        datos[i * n_ + j] = static_cast<T>(std::min(std::llround(distancia / paso_), static_cast<long long>(kInfinito) - 1));
+      } else {
+        datos[i * n_ + j] = static_cast<T>(distancia);
+      }
+    }
+  }
+  datos_ = std::make_shared<const std::vector<T>>(std::move(datos));
+}
+
+// Matriz de una instancia con la precisión elegida al arrancar (--precision); monostate = sin matriz
+using Distancias = std::variant<std::monostate, MatrizDistancias<double>, MatrizDistancias<float>, MatrizDistancias<uint32_t>, MatrizDistancias<uint16_t>>;
+
+inline bool tieneMatriz(const Distancias& distancias) { return !std::holds_alternative<std::monostate>(distancias); }
+
+#endif
@@ -0,0 +1,122 @@
+#include "memoria.h"
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+using namespace std;
+
+namespace {
+
+struct ContadoresFase {
+  atomic<uint64_t> asignaciones{0};
+  atomic<uint64_t> bytes{0};
+  atomic<int64_t> vivos{0};
+  atomic<int64_t> pico{0};
+};
+
+ContadoresFase contadores[kNumeroFasesMemoria];
+
+} // namespace
+
+/**
+ * @brief Función para obtener el nombre de una fase, tal como se muestra en la tabla
+ * @param fase Fase
+ * @return const char* Nombre de la fase
+ */
+const char* nombreFaseMemoria(FaseMemoria fase) {
+  static const char* nombres[kNumeroFasesMemoria] = {"resto", "lectura", "distancias", "copiaInstancia",
+                                                      "construccion", "busquedaLocal", "transporte", "exportacion"};
+  return nombres[static_cast<int>(fase)];
+}
+
+/**
+ * @brief Función para obtener lo contado para una fase (todo a cero si no se ha compilado el conteo)
+ * @param fase Fase
+ * @return EstadisticasMemoria Asignaciones, bytes y pico de bytes vivos de la fase
+ */
+EstadisticasMemoria estadisticasMemoria(FaseMemoria fase) {
+  const ContadoresFase& contador = contadores[static_cast<int>(fase)];
+  EstadisticasMemoria estadisticas;
+  estadisticas.asignaciones = contador.asignaciones.load(memory_order_relaxed);
+  estadisticas.bytes = contador.bytes.load(memory_order_relaxed);
+  estadisticas.pico = contador.pico.load(memory_order_relaxed);
+  return estadisticas;
+}
+
+/**
+ * @brief Función para mostrar la memoria dinámica usada en cada fase
+ * @return void
+ */
+void mostrarMemoria() {
+  cout << "------------------------------------------------------------" << endl;
+  cout << left
+  << setw(18) << "Fase (memoria)"
+  << setw(16) << "Asignaciones"
+  << setw(16) << "Bytes"
+  << setw(16) << "Pico vivo"
+  << endl;
+  cout << "------------------------------------------------------------" << endl;
+  for (int i = 0; i < kNumeroFasesMemoria; i++) {
+    const EstadisticasMemoria estadisticas = estadisticasMemoria(static_cast<FaseMemoria>(i));
+    cout << left
+    << setw(18) << nombreFaseMemoria(static_cast<FaseMemoria>(i))
+    << setw(16) << estadisticas.asignaciones
+    << setw(16) << estadisticas.bytes
+    << setw(16) << estadisticas.pico
+    << endl;
+  }
+  cout << "------------------------------------------------------------" << endl;
+}
+
+#if VRPT_CONTEO_MEMORIA
+
+namespace {
+
+// Cada bloque lleva delante su tamaño y la fase en que se pidió, para descontarlo de esa fase al
+// liberarlo aunque se libere en otra. 16 bytes mantienen la alineación que garantiza malloc.
+constexpr size_t kCabecera = 16;
+
+void* asignar(size_t tamano) noexcept {
+  void* bloque = malloc(tamano + kCabecera);
+  if (bloque == nullptr) return nullptr;
+  const FaseMemoria fase = faseMemoriaActual;
+  uint64_t* cabecera = static_cast<uint64_t*>(bloque);
+  cabecera[0] = tamano;
+  cabecera[1] = static_cast<uint64_t>(fase);
+  ContadoresFase& contador = contadores[static_cast<int>(fase)];
+  contador.asignaciones.fetch_add(1, memory_order_relaxed);
+  contador.bytes.fetch_add(tamano, memory_order_relaxed);
+  const int64_t vivos = contador.vivos.fetch_add(tamano, memory_order_relaxed) + tamano;
+  int64_t pico = contador.pico.load(memory_order_relaxed);
+  while (vivos > pico && !contador.pico.compare_exchange_weak(pico, vivos, memory_order_relaxed)) {}
+  return static_cast<char*>(bloque) + kCabecera;
+}
+
+void liberar(void* puntero) noexcept {
+  if (puntero == nullptr) return;
+  char* bloque = static_cast<char*>(puntero) - kCabecera;
+  const uint64_t* cabecera = reinterpret_cast<const uint64_t*>(bloque);
+  contadores[cabecera[1]].vivos.fetch_sub(cabecera[0], memory_order_relaxed);
+  free(bloque);
+}
+
+} // namespace
+
+void* operator new(size_t tamano) {
+  void* puntero = asignar(tamano);
+  if (puntero == nullptr) throw bad_alloc();
+  return puntero;
+}
+void* operator new[](size_t tamano) { return operator new(tamano); }
+void* operator new(size_t tamano, const nothrow_t&) noexcept { return asignar(tamano); }
+void* operator new[](size_t tamano, const nothrow_t&) noexcept { return asignar(tamano); }
+void operator delete(void* puntero) noexcept { liberar(puntero); }
+void operator delete[](void* puntero) noexcept { liberar(puntero); }
+void operator delete(void* puntero, size_t) noexcept { liberar(puntero); }
+void operator delete[](void* puntero, size_t) noexcept { liberar(puntero); }
+void operator delete(void* puntero, const nothrow_t&) noexcept { liberar(puntero); }
+void operator delete[](void* puntero, const nothrow_t&) noexcept { liberar(puntero); }
+
+#endif
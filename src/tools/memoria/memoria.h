@@ -0,0 +1,54 @@
+/**
+ * @brief Contabilidad opcional de la memoria dinámica por fase del programa (lectura, distancias,
+ *        construcción, búsqueda local, transporte, exportación...). Con -DVRPT_CONTEO_MEMORIA=1
+ *        ("make memoria") se sustituyen los operator new/delete globales para contar, por fase,
+ *        las asignaciones, los bytes pedidos y el pico de bytes vivos; sin ella no hay nada que pagar.
+ */
+
+#ifndef C_Memoria_H
+#define C_Memoria_H
+
+#include <cstdint>
+
+#ifndef VRPT_CONTEO_MEMORIA
+#define VRPT_CONTEO_MEMORIA 0
+#endif
+constexpr bool kConteoMemoria = VRPT_CONTEO_MEMORIA != 0;
+
+// Fase a la que se atribuyen las asignaciones del hilo actual ("resto" fuera de cualquier ámbito)
+enum class FaseMemoria { resto, lectura, distancias, copiaInstancia, construccion, busquedaLocal, transporte, exportacion };
+constexpr int kNumeroFasesMemoria = 8;
+
+const char* nombreFaseMemoria(FaseMemoria fase);
+
+struct EstadisticasMemoria {
+  uint64_t asignaciones = 0; // Llamadas a operator new
+  uint64_t bytes = 0; // Bytes pedidos en total
+  int64_t pico = 0; // Máximo de bytes asignados en la fase y aún no liberados a la vez
+};
+
+EstadisticasMemoria estadisticasMemoria(FaseMemoria fase); // Lo contado hasta ahora para una fase
+void mostrarMemoria(); // Imprime la tabla de todas las fases
+
+inline thread_local FaseMemoria faseMemoriaActual = FaseMemoria::resto;
+
+// Atribuye a una fase las asignaciones del hilo actual mientras exista (los ámbitos se pueden anidar)
+class AmbitoMemoria {
+  public:
+    explicit AmbitoMemoria(FaseMemoria fase) {
+      if constexpr (kConteoMemoria) {
+        anterior_ = faseMemoriaActual;
+        faseMemoriaActual = fase;
+      }
+    }
+    ~AmbitoMemoria() {
+      if constexpr (kConteoMemoria) faseMemoriaActual = anterior_;
+    }
+    AmbitoMemoria(const AmbitoMemoria&) = delete;
+    AmbitoMemoria& operator=(const AmbitoMemoria&) = delete;
+
+  private:
+    FaseMemoria anterior_ = FaseMemoria::resto;
+};
+
+#endif
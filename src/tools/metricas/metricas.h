@@ -0,0 +1,164 @@
+/**
+ * @struct Estructuras para medir dónde se va el tiempo al resolver una instancia: tiempos por fase
+ *         (construcción, búsqueda local, transporte) y contadores por operador de búsqueda local
+ */
+
+#ifndef C_Metricas_H
+#define C_Metricas_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+// Instrumentación de los caminos críticos (contadores por operador y de las funciones más llamadas).
+// Se decide al compilar: con -DVRPT_INSTRUMENTACION=1 ("make perfil") se cuenta todo; sin ella el
+// código de instrumentación se descarta entero con "if constexpr" y no cuesta nada. Los tiempos por
+// fase (unas pocas lecturas de reloj por ejecución) se miden siempre.
+#ifndef VRPT_INSTRUMENTACION
+#define VRPT_INSTRUMENTACION 0
+#endif
+constexpr bool kInstrumentacion = VRPT_INSTRUMENTACION != 0;
+
+// Ejecuta una acción de instrumentación solo en compilaciones de perfilado
+template <typename Accion>
+inline void instrumentar(Accion&& accion) {
+  if constexpr (kInstrumentacion) accion();
+}
+
+// Operadores de la búsqueda local, en el orden en que los aplica BusquedaLocal::mejorarRutas
+// (tramosExactos sólo se aplica con BusquedaLocal::setTramosExactos)
+enum class Operador { swapInter, tramosExactos, swapIntra, reinsertIntra, reinsertInter, twoOptIntra };
+constexpr int kNumeroOperadores = 6;
+
+inline const char* nombreOperador(Operador operador) {
+  static const char* nombres[kNumeroOperadores] = {"swapInter", "tramosExactos", "swapIntra", "reinsertIntra", "reinsertInter", "twoOptIntra"};
+  return nombres[static_cast<int>(operador)];
+}
+
+struct TiempoFase {
+  double pared = 0.0; // Segundos de reloj
+  double cpu = 0.0; // Segundos de CPU del hilo que ejecuta la fase
+};
+
+struct ContadorOperador {
+  uint64_t evaluados = 0; // Movimientos probados
+  uint64_t factibles = 0; // Movimientos que respetan capacidad y duración
+  uint64_t aceptados = 0; // Movimientos aplicados a la solución (todos reducen la distancia)
+  double tiempo = 0.0; // Segundos de reloj dentro del operador
+};
+
+// Llamadas a las funciones más usadas de la construcción y la búsqueda local
+struct ContadoresNucleo {
+  uint64_t zonaMasCercana = 0; // Selecciones de zona del Constructor (Voraz y Grasp)
+  uint64_t candidatosExaminados = 0; // Zonas pendientes recorridas en esas selecciones
+  uint64_t esFactible = 0; // Comprobaciones de factibilidad de la búsqueda local
+  uint64_t calcularCostoRuta = 0; // Cálculos del coste de una ruta de la búsqueda local
+  uint64_t calcularCostoInsercion = 0; // Costes de inserción de tareas en los vehículos de transporte
+};
+
+// Consultas a la memoria de rutas de la búsqueda local (ver MemoRutas), una por ruta y operador intra-ruta
+struct ContadorMemo {
+  uint64_t aciertos = 0; // Rutas cuyas paradas estaban guardadas
+  uint64_t fallos = 0;
+};
+
+// Iteraciones de la búsqueda de ruina y recreación (ver RuinaRecreacion)
+struct ContadorLNS {
+  uint64_t iteraciones = 0;
+  uint64_t aceptadas = 0; // Soluciones que pasan el criterio de aceptación
+  uint64_t mejoras = 0; // Soluciones mejores que la mejor encontrada hasta entonces
+  double tiempo = 0.0; // Segundos de reloj (dentro de la fase de búsqueda local)
+};
+
+// Caminos del reencadenamiento de trayectorias entre soluciones de GRASP (ver ReencadenamientoTrayectorias)
+struct ContadorReencadenamiento {
+  uint64_t trayectorias = 0;
+  uint64_t pasos = 0; // Zonas movidas a su ruta de la guía
+  uint64_t mejoras = 0; // Caminos con alguna solución mejor que la inicial
+  double tiempo = 0.0; // Segundos de reloj (dentro de la fase de búsqueda local)
+};
+
+struct Metricas {
+  TiempoFase construccion;
+  TiempoFase busquedaLocal;
+  TiempoFase transporte;
+  std::array<ContadorOperador, kNumeroOperadores> operadores;
+  std::vector<int> pasadas; // Pasadas de mejora de cada llamada a BusquedaLocal::mejorarRutas
+  ContadoresNucleo nucleo;
+  int duplicadas = 0; // Construcciones de GRASP repetidas, que reutilizan el resultado de otra anterior
+  ContadorMemo memo;
+  ContadorLNS lns;
+  ContadorReencadenamiento reencadenamiento;
+
+  inline ContadorOperador& operador(Operador operador) { return operadores[static_cast<int>(operador)]; }
+  inline const ContadorOperador& operador(Operador operador) const { return operadores[static_cast<int>(operador)]; }
+
+  // Suma las métricas de otra ejecución (p.ej. todas las de GRASP sobre una instancia)
+  inline void acumular(const Metricas& otras) {
+    for (auto [fase, otra] : {std::make_pair(&construccion, &otras.construccion), std::make_pair(&busquedaLocal, &otras.busquedaLocal),
+                              std::make_pair(&transporte, &otras.transporte)}) {
+      fase->pared += otra->pared;
+      fase->cpu += otra->cpu;
+    }
+    for (int i = 0; i < kNumeroOperadores; i++) {
+      operadores[i].evaluados += otras.operadores[i].evaluados;
+      operadores[i].factibles += otras.operadores[i].factibles;
+      operadores[i].aceptados += otras.operadores[i].aceptados;
+      operadores[i].tiempo += otras.operadores[i].tiempo;
+    }
+    pasadas.insert(pasadas.end(), otras.pasadas.begin(), otras.pasadas.end());
+    nucleo.zonaMasCercana += otras.nucleo.zonaMasCercana;
+    nucleo.candidatosExaminados += otras.nucleo.candidatosExaminados;
+    nucleo.esFactible += otras.nucleo.esFactible;
+    nucleo.calcularCostoRuta += otras.nucleo.calcularCostoRuta;
+    nucleo.calcularCostoInsercion += otras.nucleo.calcularCostoInsercion;
+    duplicadas += otras.duplicadas;
+    memo.aciertos += otras.memo.aciertos;
+    memo.fallos += otras.memo.fallos;
+    lns.iteraciones += otras.lns.iteraciones;
+    lns.aceptadas += otras.lns.aceptadas;
+    lns.mejoras += otras.lns.mejoras;
+    lns.tiempo += otras.lns.tiempo;
+    reencadenamiento.trayectorias += otras.reencadenamiento.trayectorias;
+    reencadenamiento.pasos += otras.reencadenamiento.pasos;
+    reencadenamiento.mejoras += otras.reencadenamiento.mejoras;
+    reencadenamiento.tiempo += otras.reencadenamiento.tiempo;
+  }
+};
+
+// Punto de la trayectoria de la mejor solución: se añade cada vez que GRASP/RVND la mejoran
+struct PuntoConvergencia {
+  double tiempo = 0.0; // Segundos desde el inicio del algoritmo sobre la instancia
+  int iteracion = 0; // Número de ejecuciones de GRASP terminadas hasta ese momento
+  int vehiculosRecoleccion = 0; // #CV
+  int vehiculosTransporte = 0; // #TV
+  double distancia = 0.0; // Distancia de las rutas de recolección
+};
+
+// Tiempo de CPU consumido por el hilo actual, en segundos
+inline double tiempoCPUHilo() {
+  timespec tiempo;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &tiempo);
+  return tiempo.tv_sec + tiempo.tv_nsec * 1e-9;
+}
+
+// Mide el tiempo de pared y de CPU desde su creación hasta su destrucción y lo suma a una fase
+class MedidorFase {
+  public:
+    explicit MedidorFase(TiempoFase& fase) : fase_(fase), inicioPared_(std::chrono::steady_clock::now()), inicioCPU_(tiempoCPUHilo()) {}
+    ~MedidorFase() {
+      fase_.pared += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicioPared_).count();
+      fase_.cpu += tiempoCPUHilo() - inicioCPU_;
+    }
+    MedidorFase(const MedidorFase&) = delete;
+    MedidorFase& operator=(const MedidorFase&) = delete;
+
+  private:
+    TiempoFase& fase_;
+    std::chrono::steady_clock::time_point inicioPared_;
+    double inicioCPU_;
+};
+
+#endif
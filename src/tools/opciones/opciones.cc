@@ -0,0 +1,260 @@
+#include "opciones.h"
+#include "../../algoritmo/grasp/secuenciador_exacto/secuenciador_exacto.h"
+#include <iostream>
+#include <stdexcept>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::invalid_argument;
+
+namespace {
+
+// Devuelve el valor que acompaña a la opción argv[i] (y avanza i), o lanza si no lo hay
+string valorDeOpcion(int argc, char* argv[], int& i) {
+  if (i + 1 >= argc) {
+    throw invalid_argument("Error: La opción " + string(argv[i]) + " necesita un valor");
+  }
+  return argv[++i];
+}
+
+int enteroDeOpcion(const string& opcion, const string& valor, int minimo) {
+  size_t leidos = 0;
+  int numero;
+  try {
+    numero = std::stoi(valor, &leidos);
+  } catch (const std::exception&) {
+    leidos = 0;
+  }
+  if (leidos != valor.size() || valor.empty()) {
+    throw invalid_argument("Error: El valor de " + opcion + " debe ser un número entero (\"" + valor + "\")");
+  }
+  if (numero < minimo) {
+    throw invalid_argument("Error: El valor de " + opcion + " debe ser mayor o igual que " + std::to_string(minimo));
+  }
+  return numero;
+}
+
+int algoritmoDeOpcion(const string& valor) {
+  if (valor == "voraz" || valor == "1") return 1;
+  if (valor == "grasp" || valor == "2") return 2;
+  if (valor == "rvnd" || valor == "3") return 3;
+  throw invalid_argument("Error: Algoritmo desconocido \"" + valor + "\" (use voraz, grasp o rvnd)");
+}
+
+/**
+ * @brief Función para obtener la política de construcción a partir del valor de --seleccion
+ * @param valor Nombre de la política
+ * @return TipoSeleccion Política indicada
+ * @throws std::invalid_argument si la política no existe
+ */
+TipoSeleccion seleccionDeOpcion(const string& valor) {
+  if (valor == "lrc") return TipoSeleccion::lrcCardinalidad;
+  if (valor == "valor") return TipoSeleccion::lrcValor;
+  if (valor == "arrepentimiento") return TipoSeleccion::arrepentimiento;
+  throw invalid_argument("Error: Selección desconocida \"" + valor + "\" (use lrc, valor o arrepentimiento)");
+}
+
+/**
+ * @brief Función para obtener la construcción de Voraz a partir del valor de --construccion
+ * @param valor Nombre de la construcción
+ * @return TipoConstruccion Construcción indicada
+ * @throws std::invalid_argument si la construcción no existe
+ */
+TipoConstruccion construccionDeOpcion(const string& valor) {
+  if (valor == "vecino") return TipoConstruccion::vecinoMasCercano;
+  if (valor == "insercion") return TipoConstruccion::insercion;
+  throw invalid_argument("Error: Construcción desconocida \"" + valor + "\" (use vecino o insercion)");
+}
+
+/**
+ * @brief Función para obtener el reparto de la descomposición a partir del valor de --particion
+ * @param valor Nombre del reparto
+ * @return TipoParticion Reparto indicado
+ * @throws std::invalid_argument si el reparto no existe
+ */
+TipoParticion particionDeOpcion(const string& valor) {
+  if (valor == "barrido") return TipoParticion::barrido;
+  if (valor == "kmedias") return TipoParticion::kMedias;
+  throw invalid_argument("Error: Partición desconocida \"" + valor + "\" (use barrido o kmedias)");
+}
+
+/**
+ * @brief Función para obtener el tipo de la matriz de distancias a partir del valor de --precision
+ * @param valor Nombre del tipo
+ * @return PrecisionDistancias Tipo indicado
+ * @throws std::invalid_argument si el tipo no existe
+ */
+PrecisionDistancias precisionDeOpcion(const string& valor) {
+  if (valor == "double") return PrecisionDistancias::doble;
+  if (valor == "float") return PrecisionDistancias::simple;
+  if (valor == "u32") return PrecisionDistancias::fija32;
+  if (valor == "u16") return PrecisionDistancias::fija16;
+  throw invalid_argument("Error: Precisión desconocida \"" + valor + "\" (use double, float, u32 o u16)");
+}
+
+/**
+ * @brief Función para obtener el criterio de aceptación de la LNS a partir del valor de --lns-aceptacion,
+ *        "criterio" o "criterio:parametro" (p.ej. "umbral:0.02")
+ * @param valor Criterio y, opcionalmente, su parámetro
+ * @param lns Configuración en la que se dejan el criterio y el parámetro (el de por defecto si no se indica)
+ * @return void
+ * @throws std::invalid_argument si el criterio no existe o el parámetro no es un número positivo
+ */
+void aceptacionDeOpcion(const string& valor, ConfiguracionLNS& lns) {
+  const size_t separador = valor.find(':');
+  const string criterio = valor.substr(0, separador);
+  if (criterio == "mejora") {
+    lns.aceptacion = CriterioAceptacion::mejora;
+    lns.parametro = 0.0;
+  } else if (criterio == "umbral") {
+    lns.aceptacion = CriterioAceptacion::umbral;
+    lns.parametro = 0.01;
+  } else if (criterio == "recocido") {
+    lns.aceptacion = CriterioAceptacion::recocido;
+    lns.parametro = 1.0;
+  } else {
+    throw invalid_argument("Error: Criterio de aceptación desconocido \"" + criterio + "\" (use mejora, umbral o recocido)");
+  }
+  if (separador == string::npos) return;
+  const string parametro = valor.substr(separador + 1);
+  size_t leidos = 0;
+  try {
+    lns.parametro = std::stod(parametro, &leidos);
+  } catch (const std::exception&) {
+    leidos = 0;
+  }
+  if (lns.aceptacion == CriterioAceptacion::mejora || leidos != parametro.size() || parametro.empty() || !(lns.parametro > 0)) {
+    throw invalid_argument("Error: El parámetro de --lns-aceptacion debe ser un número positivo y sólo lo admiten umbral y recocido (\"" + valor + "\")");
+  }
+}
+
+} // namespace
+
+/**
+ * @brief Función para interpretar los argumentos de la línea de comandos
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @return Opciones Opciones leídas (las no indicadas conservan su valor por defecto)
+ * @throws std::invalid_argument si alguna opción es desconocida, le falta el valor o este no es válido
+ */
+Opciones parsearOpciones(int argc, char* argv[]) {
+  Opciones opciones;
+  for (int i = 1; i < argc; i++) {
+    const string argumento = argv[i];
+    if (argumento == "-h" || argumento == "--ayuda") opciones.ayuda = true;
+    else if (argumento == "-a" || argumento == "--algoritmo") opciones.algoritmo = algoritmoDeOpcion(valorDeOpcion(argc, argv, i));
+    else if (argumento == "-i" || argumento == "--entrada") opciones.entrada = valorDeOpcion(argc, argv, i);
+    else if (argumento == "-o" || argumento == "--salida") opciones.salida = valorDeOpcion(argc, argv, i);
+    else if (argumento == "--lrc") opciones.tamanoLRC = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 2);
+    else if (argumento == "--seleccion") opciones.seleccion = seleccionDeOpcion(valorDeOpcion(argc, argv, i));
+    else if (argumento == "--construccion") opciones.construccion = construccionDeOpcion(valorDeOpcion(argc, argv, i));
+    else if (argumento == "--alfa") {
+      const string valor = valorDeOpcion(argc, argv, i);
+      size_t leidos = 0;
+      try {
+        opciones.alfa = std::stod(valor, &leidos);
+      } catch (const std::exception&) {
+        leidos = 0;
+      }
+      if (leidos != valor.size() || valor.empty() || opciones.alfa < 0 || opciones.alfa > 1) {
+        throw invalid_argument("Error: El valor de --alfa debe ser un número entre 0 y 1 (\"" + valor + "\")");
+      }
+    }
+    else if (argumento == "--ejecuciones") opciones.numeroEjecuciones = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 1);
+    else if (argumento == "--semilla") {
+      const string valor = valorDeOpcion(argc, argv, i);
+      size_t leidos = 0;
+      try {
+        opciones.semilla = static_cast<unsigned>(std::stoul(valor, &leidos));
+      } catch (const std::exception&) {
+        leidos = 0;
+      }
+      if (leidos != valor.size() || valor.empty() || valor[0] == '-') {
+        throw invalid_argument("Error: El valor de --semilla debe ser un entero no negativo (\"" + valor + "\")");
+      }
+      opciones.semillaFijada = true;
+    }
+    else if (argumento == "--hilos") opciones.hilos = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 0);
+    else if (argumento == "--vecindario-paralelo") opciones.vecindarioParalelo = true;
+    else if (argumento == "--sin-matriz") opciones.precision = PrecisionDistancias::ninguna;
+    else if (argumento == "--precision") opciones.precision = precisionDeOpcion(valorDeOpcion(argc, argv, i));
+    else if (argumento == "--vecinos") opciones.vecinos = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 1);
+    else if (argumento == "--memo-rutas") opciones.memoRutas = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 1);
+    else if (argumento == "--tramos-exactos") {
+      opciones.tramosExactos = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 2);
+      if (opciones.tramosExactos > SecuenciadorExacto::kMaxZonas) {
+        throw invalid_argument("Error: El valor de --tramos-exactos debe ser menor o igual que " + std::to_string(SecuenciadorExacto::kMaxZonas));
+      }
+    }
+    else if (argumento == "--lns") opciones.lns.iteraciones = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 1);
+    else if (argumento == "--lns-ruina") opciones.lns.maxRuina = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 1);
+    else if (argumento == "--lns-aceptacion") aceptacionDeOpcion(valorDeOpcion(argc, argv, i), opciones.lns);
+    else if (argumento == "--sin-busqueda-local") opciones.sinBusquedaLocal = true;
+    else if (argumento == "--descomposicion") opciones.descomposicion.grupos = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 0);
+    else if (argumento == "--particion") opciones.descomposicion.particion = particionDeOpcion(valorDeOpcion(argc, argv, i));
+    else if (argumento == "--reencadenamiento") opciones.reencadenamiento = enteroDeOpcion(argumento, valorDeOpcion(argc, argv, i), 2);
+    else if (argumento == "--tiempo") {
+      const string valor = valorDeOpcion(argc, argv, i);
+      size_t leidos = 0;
+      try {
+        opciones.tiempoLimite = std::stod(valor, &leidos);
+      } catch (const std::exception&) {
+        leidos = 0;
+      }
+      if (leidos != valor.size() || valor.empty() || opciones.tiempoLimite < 0) {
+        throw invalid_argument("Error: El valor de --tiempo debe ser un número de segundos no negativo (\"" + valor + "\")");
+      }
+    }
+    else if (argumento == "--compacto") opciones.compacto = true;
+    else if (argumento == "--traza") opciones.traza = valorDeOpcion(argc, argv, i);
+    else if (!argumento.empty() && argumento[0] == '-') {
+      throw invalid_argument("Error: Opción desconocida " + argumento);
+    }
+    else if (opciones.entrada.empty()) opciones.entrada = argumento; // Argumento posicional: la entrada
+    else {
+      throw invalid_argument("Error: Argumento inesperado " + argumento + " (la entrada ya es " + opciones.entrada + ")");
+    }
+  }
+  if (opciones.entrada.empty() && !opciones.ayuda) {
+    throw invalid_argument("Error: Falta la entrada (directorio, fichero o patrón de instancias)");
+  }
+  return opciones;
+}
+
+/**
+ * @brief Función para mostrar la ayuda de la línea de comandos
+ * @param programa Nombre del ejecutable (argv[0])
+ * @return void
+ */
+void mostrarUso(const string& programa) {
+  cout << "Uso: " << programa << " <entrada> [opciones]" << endl;
+  cout << "  <entrada>                 Directorio con ficheros \"instanceN.txt\", un fichero de instancia" << endl;
+  cout << "                            o un patrón con * y ? (p.ej. \"data/instance1*.txt\")" << endl;
+  cout << "  -a, --algoritmo <nombre>  voraz, grasp o rvnd (sin esta opción se muestra el menú)" << endl;
+  cout << "  --lrc <n>                 Tamaño máximo de la LRC de GRASP/RVND (por defecto 3, mínimo 2)" << endl;
+  cout << "  --seleccion <politica>    Construcción de GRASP/RVND: lrc (por defecto), valor o arrepentimiento" << endl;
+  cout << "  --construccion <c>        Construcción de Voraz: vecino (por defecto) o insercion (con arrepentimiento)" << endl;
+  cout << "  --alfa <x>                Umbral de la LRC por valor, entre 0 y 1 (por defecto 0.2)" << endl;
+  cout << "  --ejecuciones <n>         Ejecuciones de GRASP por tamaño de LRC (por defecto 3)" << endl;
+  cout << "  --semilla <n>             Semilla de GRASP/RVND (por defecto, aleatoria)" << endl;
+  cout << "  --hilos <n>               Hilos para las ejecuciones de GRASP y los grupos (por defecto 1; 0 = todos)" << endl;
+  cout << "  --vecindario-paralelo     Evalúa en paralelo los pares de rutas de swapInter/reinsertInter" << endl;
+  cout << "  --sin-matriz              No calcula la matriz de distancias (por defecto, sólo con más de 5000 zonas)" << endl;
+  cout << "  --precision <tipo>        Tipo de la matriz de distancias: double (por defecto), float, u32 o u16" << endl;
+  cout << "  --vecinos <k>             Búsqueda local granular sobre las k zonas más cercanas (implica --sin-matriz)" << endl;
+  cout << "  --memo-rutas <n>          Guarda el mejor orden de hasta n rutas entre ejecuciones de GRASP (LRU)" << endl;
+  cout << "  --tramos-exactos <m>      Ordena de forma exacta los tramos de hasta m zonas entre SWTS (entre 2 y 16)" << endl;
+  cout << "  --lns <n>                 Iteraciones de ruina y recreación tras la búsqueda local de GRASP/RVND" << endl;
+  cout << "  --lns-ruina <q>           Zonas que quita como mucho cada iteración de la LNS (por defecto 10)" << endl;
+  cout << "  --lns-aceptacion <c>      Criterio de la LNS: mejora (por defecto), umbral[:x] o recocido[:t]" << endl;
+  cout << "  --sin-busqueda-local      GRASP/RVND no aplican la búsqueda local por enumeración (p.ej. con --lns)" << endl;
+  cout << "  --descomposicion <k>      Construye y mejora por separado, en paralelo, k grupos de zonas" << endl;
+  cout << "  --particion <p>           Grupos de --descomposicion: kmedias (por defecto, desde las SWTS) o barrido" << endl;
+  cout << "  --reencadenamiento <e>    Reencadena trayectorias entre las e mejores soluciones de GRASP/RVND" << endl;
+  cout << "  --tiempo <segundos>       Tiempo máximo por instancia de GRASP/RVND (por defecto sin límite)" << endl;
+  cout << "  -o, --salida <fichero>    Fichero JSON de resultados (por defecto resultados.json)" << endl;
+  cout << "  --compacto                Exporta las rutas como índices en la tabla de zonas" << endl;
+  cout << "  --traza <fichero>         Guarda una traza de la ejecución (Perfetto, chrome://tracing)" << endl;
+  cout << "  -h, --ayuda               Muestra esta ayuda" << endl;
+}
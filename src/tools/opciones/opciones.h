@@ -0,0 +1,87 @@
+/**
+ * @struct Estructura con las opciones de la línea de comandos del programa
+ */
+
+#ifndef C_Opciones_H
+#define C_Opciones_H
+
+#include <string>
+
+// Política con la que GRASP/RVND escogen la siguiente zona al construir (ver algoritmo/constructor/politicas.h)
+enum class TipoSeleccion {
+  lrcCardinalidad, // Al azar entre las "LRC" zonas más cercanas
+  lrcValor, // Al azar entre las zonas a menos de dMin + alfa * (dMax - dMin)
+  arrepentimiento // Entre las "LRC" más cercanas, la que más costaría dejar para después
+};
+
+// Construcción de las rutas de recolección de Voraz
+enum class TipoConstruccion {
+  vecinoMasCercano, // Cada vehículo va a la zona pendiente más cercana (Constructor con PoliticaMasCercana)
+  insercion // Inserción con arrepentimiento (ver algoritmo/insercion_arrepentimiento)
+};
+
+// Tipo en que se guarda la matriz de distancias (ver tools/matriz_distancias/matriz_distancias.h)
+enum class PrecisionDistancias {
+  ninguna, // Sin matriz: el Constructor usa un índice espacial
+  doble, // double, exacta
+  simple, // float
+  fija32, // uint32_t en coma fija
+  fija16 // uint16_t en coma fija
+};
+
+// Criterio con el que la búsqueda de ruina y recreación acepta una solución (ver algoritmo/grasp/ruina_recreacion)
+enum class CriterioAceptacion {
+  mejora, // Si no es peor que la actual
+  umbral, // Si no es peor que la mejor encontrada en más de una fracción (record-to-record travel)
+  recocido // Si no es peor, o con probabilidad exp(-empeora / temperatura) (recocido simulado)
+};
+
+struct ConfiguracionLNS {
+  int iteraciones = 0; // Iteraciones de ruina y recreación tras la búsqueda local (0 = no se aplica)
+  int maxRuina = 10; // Zonas que se quitan como mucho en cada iteración
+  CriterioAceptacion aceptacion = CriterioAceptacion::mejora;
+  double parametro = 0.0; // umbral: fracción de la mejor distancia; recocido: temperatura inicial relativa
+};
+
+// Reparto de las zonas de recolección en grupos que se resuelven por separado (ver algoritmo/descomposicion)
+enum class TipoParticion {
+  barrido, // Sectores de ángulo alrededor del depósito, con el mismo contenido
+  kMedias // k-medias sobre las coordenadas, con los centros iniciales en las SWTS
+};
+
+struct ConfiguracionDescomposicion {
+  int grupos = 0; // Grupos en los que se reparten las zonas (0 o 1 = sin descomposición)
+  TipoParticion particion = TipoParticion::kMedias;
+};
+
+struct Opciones {
+  std::string entrada; // Directorio, fichero "instanceN.txt" o patrón (p.ej. "data/instance1*.txt")
+  std::string salida = "resultados.json"; // Fichero JSON de resultados
+  int algoritmo = 0; // 1 = Voraz, 2 = GRASP, 3 = RVND; 0 = preguntar con el menú
+  int tamanoLRC = 3; // Tamaño máximo de la lista restringida de candidatos de GRASP/RVND
+  int numeroEjecuciones = 3; // Ejecuciones de GRASP por cada tamaño de LRC
+  TipoSeleccion seleccion = TipoSeleccion::lrcCardinalidad; // Política de la construcción de GRASP/RVND
+  double alfa = 0.2; // Umbral de la LRC por valor (entre 0 = voraz y 1 = aleatoria)
+  TipoConstruccion construccion = TipoConstruccion::vecinoMasCercano; // Construcción de Voraz
+  unsigned semilla = 0; // Semilla de GRASP/RVND (sólo si semillaFijada)
+  bool semillaFijada = false;
+  int hilos = 1; // Hilos para las ejecuciones de GRASP (0 = los que tenga la máquina)
+  bool vecindarioParalelo = false; // Evaluar en paralelo los pares de rutas de swapInter/reinsertInter
+  PrecisionDistancias precision = PrecisionDistancias::doble; // Matriz de distancias (--precision, --sin-matriz)
+  int vecinos = 0; // Vecinas por zona del grafo de la búsqueda local granular (0 = sin grafo; implica sin matriz)
+  int memoRutas = 0; // Rutas que guarda la memoria de la búsqueda local de GRASP/RVND (0 = sin memoria)
+  int tramosExactos = 0; // Zonas máximas de los tramos que la búsqueda local ordena de forma exacta (0 = ninguno)
+  ConfiguracionLNS lns; // Ruina y recreación de GRASP/RVND (--lns, --lns-ruina, --lns-aceptacion)
+  ConfiguracionDescomposicion descomposicion; // Construcción y búsqueda local por grupos (--descomposicion, --particion)
+  int reencadenamiento = 0; // Soluciones de GRASP/RVND entre las que se reencadenan trayectorias (0 = ninguna)
+  bool sinBusquedaLocal = false; // GRASP/RVND no aplican la búsqueda local por enumeración (sólo la LNS, si la hay)
+  double tiempoLimite = 0.0; // Segundos por instancia para GRASP/RVND (0 = sin límite)
+  bool compacto = false; // Exportar el JSON en formato compacto
+  std::string traza; // Fichero de la traza de ejecución para Perfetto/chrome://tracing (vacío = sin traza)
+  bool ayuda = false; // Mostrar la ayuda y salir
+};
+
+Opciones parsearOpciones(int argc, char* argv[]); // Interpreta los argumentos de la línea de comandos
+void mostrarUso(const std::string& programa); // Muestra la ayuda de la línea de comandos
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @brief Utilidad para repartir las iteraciones de un bucle entre varios hilos
+ */
+
+#ifndef C_Paralelo_H
+#define C_Paralelo_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Número de hilos a usar: "hilos" si es positivo, o los que tenga la máquina si es 0
+ * @param hilos Número de hilos pedido
+ * @return int Número de hilos efectivo (al menos 1)
+ */
+inline int hilosEfectivos(int hilos) {
+  if (hilos > 0) return hilos;
+  const unsigned disponibles = std::thread::hardware_concurrency();
+  return disponibles > 0 ? static_cast<int>(disponibles) : 1;
+}
+
+/**
+ * @brief Ejecuta funcion(i) para cada i en [0, n) repartiendo las iteraciones entre "hilos" hilos.
+ *        Las iteraciones se asignan dinámicamente (la siguiente libre), por lo que "funcion" debe
+ *        poder ejecutarse en paralelo para índices distintos. Si alguna iteración lanza una
+ *        excepción, se dejan de repartir iteraciones y se relanza la primera en el hilo llamador.
+ * @param n Número de iteraciones
+ * @param hilos Número de hilos (0 = los que tenga la máquina)
+ * @param funcion Cuerpo del bucle
+ * @return void
+ */
+template <typename Funcion>
+void paraleloPara(size_t n, int hilos, Funcion&& funcion) {
+  const size_t numeroHilos = std::min<size_t>(hilosEfectivos(hilos), n);
+  if (numeroHilos <= 1) {
+    for (size_t i = 0; i < n; i++) funcion(i);
+    return;
+  }
+  std::atomic<size_t> siguiente{0};
+  std::exception_ptr error = nullptr;
+  std::mutex mutexError;
+  auto trabajar = [&]() {
+    for (size_t i = siguiente++; i < n; i = siguiente++) {
+      try {
+        funcion(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> bloqueo(mutexError);
+        if (!error) error = std::current_exception();
+        siguiente = n; // No se reparten más iteraciones
+      }
+    }
+  };
+  std::vector<std::thread> trabajadores;
+  trabajadores.reserve(numeroHilos - 1);
+  for (size_t h = 1; h < numeroHilos; h++) trabajadores.emplace_back(trabajar);
+  trabajar(); // El hilo llamador también trabaja
+  for (auto& trabajador : trabajadores) trabajador.join();
+  if (error) std::rethrow_exception(error);
+}
+
+#endif
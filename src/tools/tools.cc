@@ -1,5 +1,8 @@
 #include "tools.h"
+#include "escritor_json/escritor_json.h"
 #include <algorithm>
+#include <iomanip>
+#include <unordered_map>
 
 using std::cout;
 using std::endl;
@@ -9,8 +12,12 @@ using std::vector;
 using std::pair;
 using std::istringstream;
 using std::ifstream;
-using std::ofstream;
 using std::invalid_argument;
+using std::ostringstream;
+using std::left;
+using std::fixed;
+using std::setw;
+using std::setprecision;
 
 /**
  * @brief Función para procesar una línea en tokens
@@ -47,6 +54,7 @@ void crearZona(const string& id, istringstream& linea, Tools& datos) {
   linea >> posicion.first >> posicion.second;
   if (id == "Dumpsite") {
     contenido = 0;
+    datos.indiceVertedero = datos.zonas.size();
     datos.zonas.push_back(Zona(id, posicion, contenido));
     return;
   }
@@ -56,7 +64,7 @@ void crearZona(const string& id, istringstream& linea, Tools& datos) {
   else if (posicion.first > datos.maxX || posicion.second > datos.maxY) {
     throw invalid_argument("Error: Las coordenadas de la zona " + id + " están fuera del rango");
   }
-  else if (id == "IF" || id == "IF1" || id == "Depot") {
+  else if (Zona::esIdentificadorSWTS(id) || id == "Depot") {
     contenido = 0.0;
     tiempoProcesado = 0.0;
   } else {
@@ -68,9 +76,10 @@ void crearZona(const string& id, istringstream& linea, Tools& datos) {
       throw invalid_argument("Error: El tiempo de procesado de la zona " + id + " no puede ser negativo");
     }
   }
+  if (id == "Depot") datos.indiceDeposito = datos.zonas.size();
   datos.zonas.push_back(Zona(id, posicion, tiempoProcesado, contenido));
   // Si la zona es de recolección, la añado al vector de zonas de recolección
-  if (id != "IF" && id != "IF1" && id != "Depot" && id != "Dumpsite") {
+  if (!Zona::esIdentificadorSWTS(id) && id != "Depot") {
     datos.zonasRecoleccion.push_back(Zona(id, posicion, tiempoProcesado, contenido));
   }
 }
@@ -78,19 +87,20 @@ void crearZona(const string& id, istringstream& linea, Tools& datos) {
 /**
  * @brief Función para calcular las distancias entre las zonas
  * @param datos Estructura con las zonas ya cargadas
- * @return void
+ * @param precision Tipo en que se guardan (ninguna = sin matriz)
+ * @return Distancias Matriz de distancias, con infinito en la diagonal
  */
-vector<vector<double>> calcularDistancias(const Tools& datos) {
-  vector<vector<double>> distancias(datos.zonas.size(), vector<double>(datos.zonas.size(), INFINITY));
-  for (size_t i = 0; i < datos.zonas.size(); i++) {
-    for (size_t j = 0; j < datos.zonas.size(); j++) {
-      if (i == j) continue;
-      else {
-        distancias[i][j] = datos.zonas[i].getDistancia(datos.zonas[j]);
-      }
-    }
+Distancias calcularDistancias(const Tools& datos, PrecisionDistancias precision) {
+  IntervaloTraza intervalo("calcularDistancias", "carga");
+  AmbitoMemoria memoria(FaseMemoria::distancias);
+  switch (precision) {
+    case PrecisionDistancias::doble: return MatrizDistancias<double>(datos.zonas);
+    case PrecisionDistancias::simple: return MatrizDistancias<float>(datos.zonas);
+    case PrecisionDistancias::fija32: return MatrizDistancias<uint32_t>(datos.zonas);
+    case PrecisionDistancias::fija16: return MatrizDistancias<uint16_t>(datos.zonas);
+    case PrecisionDistancias::ninguna: break;
   }
-  return distancias;
+  return std::monostate{};
 }
 
 /**
@@ -114,40 +124,172 @@ void mostrarZonas(const vector<Zona>& zonas) {
  * @return void
  */
 void mostrarDistancias(const Tools& datos) {
-  for (size_t i = 0; i < datos.distancias.size(); i++) {
-    cout << "Distancias de la zona " << datos.zonas[i].getId() << endl;
-    for (size_t j = 0; j < datos.distancias[i].size(); j++) {
-      cout << datos.zonas[i].getId() << " --> " << datos.zonas[j].getId() << ": " << datos.distancias[i][j] << endl;
+  std::visit([&](const auto& matriz) {
+    if constexpr (!std::is_same_v<std::decay_t<decltype(matriz)>, std::monostate>) {
+      for (size_t i = 0; i < matriz.numZonas(); i++) {
+        cout << "Distancias de la zona " << datos.zonas[i].getId() << endl;
+        for (size_t j = 0; j < matriz.numZonas(); j++) {
+          cout << datos.zonas[i].getId() << " --> " << datos.zonas[j].getId() << ": " << matriz(i, j) << endl;
+        }
+        cout << endl;
+      }
     }
-    cout << endl;
-  }
+  }, datos.distancias);
 }
 
 /**
- * @brief Función para leer los datos de un único fichero de instancia
- * @param rutaFichero Ruta al fichero de instancia (p.ej. "data/instance5.txt")
- * @return Tools Datos de la instancia leída, con la matriz de distancias ya calculada
- * @throws std::invalid_argument si el fichero no se puede abrir o no contiene zonas
+ * @brief Función para mostrar con qué tipo se ha guardado la matriz de distancias de una instancia, lo
+ *        que ocupa y la cota del error de cada distancia
+ * @param datos Instancia
+ * @return void
  */
-Tools leerInstancia(const string& rutaFichero) {
-  ifstream file(rutaFichero);
-  if (!file.is_open()) {
-    throw invalid_argument("Error: No se pudo abrir el fichero de instancia " + rutaFichero);
+void mostrarPrecision(const Tools& datos) {
+  std::visit([&](const auto& matriz) {
+    using Matriz = std::decay_t<decltype(matriz)>;
+    cout << datos.nombreInstancia << ": ";
+    if constexpr (std::is_same_v<Matriz, std::monostate>) {
+      cout << "sin matriz de distancias" << endl;
+    } else {
+      using Valor = typename Matriz::Valor;
+      const string tipo = std::is_same_v<Valor, double> ? "double" : std::is_same_v<Valor, float> ? "float" : std::is_same_v<Valor, uint32_t> ? "u32" : "u16";
+      cout << "matriz de distancias en " << tipo << " (" << matriz.bytes() / (1024.0 * 1024.0) << " MB), error máximo " << matriz.errorMaximo() << endl;
+    }
+  }, datos.distancias);
+}
+
+/**
+ * @brief Función para mostrar dónde se ha ido el tiempo de cada resultado: tiempos de pared y de CPU
+ *        por fase y, sumados sobre todos los resultados, los contadores de cada operador de búsqueda local
+ * @param datos Resultados de un algoritmo
+ * @return void
+ */
+void mostrarMetricas(const vector<std::shared_ptr<Tools>>& datos) {
+  cout << "--------------------------------------------------------------------------------------------" << endl;
+  cout << left
+  << setw(20) << "Instancia"
+  << setw(24) << "Construccion (s/CPU)"
+  << setw(24) << "Busq. local (s/CPU)"
+  << setw(24) << "Transporte (s/CPU)"
+  << setw(10) << "Pasadas"
+  << endl;
+  cout << "--------------------------------------------------------------------------------------------" << endl;
+  Metricas total;
+  auto fase = [](const TiempoFase& tiempo) {
+    ostringstream texto;
+    texto << fixed << setprecision(4) << tiempo.pared << " / " << tiempo.cpu;
+    return texto.str();
+  };
+  for (const auto& dato : datos) {
+    const Metricas& metricas = dato->metricas;
+    int pasadas = 0;
+    for (int p : metricas.pasadas) pasadas += p;
+    cout << left
+    << setw(20) << dato->nombreInstancia
+    << setw(24) << fase(metricas.construccion)
+    << setw(24) << fase(metricas.busquedaLocal)
+    << setw(24) << fase(metricas.transporte)
+    << setw(10) << pasadas
+    << endl;
+    total.acumular(metricas);
+  }
+  cout << "--------------------------------------------------------------------------------------------" << endl;
+  if (total.duplicadas > 0) {
+    cout << "Construcciones repetidas (sin búsqueda local ni transporte): " << total.duplicadas << " de " << datos.size() << endl;
+    cout << "--------------------------------------------------------------------------------------------" << endl;
+  }
+  if (total.memo.aciertos + total.memo.fallos > 0) {
+    cout << "Memoria de rutas: " << total.memo.aciertos << " aciertos, " << total.memo.fallos << " fallos" << endl;
+    cout << "--------------------------------------------------------------------------------------------" << endl;
+  }
+  if (total.lns.iteraciones > 0) {
+    cout << "Ruina y recreación: " << total.lns.iteraciones << " iteraciones, " << total.lns.aceptadas << " aceptadas, "
+         << total.lns.mejoras << " mejoras (" << total.lns.tiempo << " s)" << endl;
+    cout << "--------------------------------------------------------------------------------------------" << endl;
+  }
+  if (total.reencadenamiento.trayectorias > 0) {
+    cout << "Reencadenamiento de trayectorias: " << total.reencadenamiento.trayectorias << " caminos, " << total.reencadenamiento.pasos
+         << " pasos, " << total.reencadenamiento.mejoras << " mejoras (" << total.reencadenamiento.tiempo << " s)" << endl;
+    cout << "--------------------------------------------------------------------------------------------" << endl;
+  }
+  if constexpr (!kInstrumentacion) {
+    cout << "Contadores por operador desactivados (compilar con \"make perfil\" para obtenerlos)" << endl;
+    return;
+  }
+  cout << left
+  << "zonaMasCercana: " << total.nucleo.zonaMasCercana
+  << " (" << total.nucleo.candidatosExaminados << " candidatos) · esFactible: " << total.nucleo.esFactible
+  << " · calcularCostoRuta: " << total.nucleo.calcularCostoRuta
+  << " · calcularCostoInsercion: " << total.nucleo.calcularCostoInsercion
+  << endl;
+  cout << "--------------------------------------------------------------------------------------------" << endl;
+  if (total.pasadas.empty()) return; // Sin búsqueda local (p.ej. Voraz)
+  cout << left
+  << setw(16) << "Operador"
+  << setw(14) << "Evaluados"
+  << setw(14) << "Factibles"
+  << setw(12) << "Aceptados"
+  << setw(12) << "Tiempo (s)"
+  << endl;
+  cout << "--------------------------------------------------------------------------------------------" << endl;
+  for (int i = 0; i < kNumeroOperadores; i++) {
+    const ContadorOperador& contador = total.operadores[i];
+    cout << left
+    << setw(16) << nombreOperador(static_cast<Operador>(i))
+    << setw(14) << contador.evaluados
+    << setw(14) << contador.factibles
+    << setw(12) << contador.aceptados
+    << setw(12) << contador.tiempo
+    << endl;
   }
+  cout << "--------------------------------------------------------------------------------------------" << endl;
+}
+
+/**
+ * @brief Función para leer los datos de una instancia desde un flujo (fichero, cadena generada...)
+ * @param entrada Flujo con el contenido de la instancia, en el formato de "instanceN.txt"
+ * @param nombreInstancia Nombre con el que se identifica la instancia en los resultados
+ * @param precision Tipo de la matriz de distancias (ninguna = sin matriz); con más de kMaxZonasMatriz zonas no se calcula
+ * @return Tools Datos de la instancia leída, con la matriz de distancias ya calculada si corresponde
+ * @throws std::invalid_argument si no contiene zonas o le falta el depósito, el vertedero o las SWTS
+ */
+Tools leerInstancia(std::istream& entrada, const string& nombreInstancia, PrecisionDistancias precision) {
+  IntervaloTraza intervalo(Traza::global().activa() ? "leerInstancia " + nombreInstancia : string(), "carga");
+  AmbitoMemoria memoria(FaseMemoria::lectura);
   Tools dato;
-  dato.nombreInstancia = fs::path(rutaFichero).stem().string();
+  dato.nombreInstancia = nombreInstancia;
   string line;
-  while (getline(file, line)) {
+  while (getline(entrada, line)) {
     istringstream lineaStream(line);
     procesarLinea(lineaStream, dato);
   }
   if (dato.zonas.empty()) {
-    throw invalid_argument("Error: El fichero de instancia " + rutaFichero + " no contiene ninguna zona");
+    throw invalid_argument("Error: La instancia " + nombreInstancia + " no contiene ninguna zona");
+  }
+  if (dato.indiceDeposito < 0 || dato.indiceVertedero < 0 ||
+      std::none_of(dato.zonas.begin(), dato.zonas.end(), [](const Zona& zona) { return zona.esSWTS(); })) {
+    throw invalid_argument("Error: La instancia " + nombreInstancia + " debe tener un Depot, un Dumpsite y al menos una SWTS (IF)");
+  }
+  if (dato.zonas.size() <= kMaxZonasMatriz) {
+    dato.distancias = calcularDistancias(dato, precision); // Calculo las distancias entre las zonas
   }
-  dato.distancias = calcularDistancias(dato); // Calculo las distancias entre las zonas
   return dato;
 }
 
+/**
+ * @brief Función para leer los datos de un único fichero de instancia
+ * @param rutaFichero Ruta al fichero de instancia (p.ej. "data/instance5.txt")
+ * @param precision Tipo de la matriz de distancias (ver leerInstancia)
+ * @return Tools Datos de la instancia leída, con la matriz de distancias ya calculada si corresponde
+ * @throws std::invalid_argument si el fichero no se puede abrir o no es una instancia válida
+ */
+Tools leerInstancia(const string& rutaFichero, PrecisionDistancias precision) {
+  ifstream file(rutaFichero);
+  if (!file.is_open()) {
+    throw invalid_argument("Error: No se pudo abrir el fichero de instancia " + rutaFichero);
+  }
+  return leerInstancia(file, fs::path(rutaFichero).stem().string(), precision);
+}
+
 namespace {
 
 // Extrae el número de "instanceN.txt" (p.ej. 12 de "instance12"); -1 si el nombre no sigue ese patrón.
@@ -165,10 +307,11 @@ int numeroDeInstancia(const fs::path& ruta) {
 /**
  * @brief Función para leer todos los ficheros de instancia ("instanceN.txt") de un directorio
  * @param dirName Ruta al directorio que contiene los ficheros de instancia
+ * @param precision Tipo de la matriz de distancias (ver leerInstancia)
  * @return vector<Tools> Datos de cada instancia encontrada, ordenados por número de instancia
  * @throws std::invalid_argument si el directorio no existe o no contiene ningún fichero de instancia
  */
-vector<Tools> readData(const string& dirName) {
+vector<Tools> readData(const string& dirName, PrecisionDistancias precision) {
   if (!fs::exists(dirName) || !fs::is_directory(dirName)) {
     throw invalid_argument("Error: El directorio de instancias " + dirName + " no existe");
   }
@@ -188,7 +331,73 @@ vector<Tools> readData(const string& dirName) {
   vector<Tools> datos;
   datos.reserve(ficheros.size());
   for (const auto& fichero : ficheros) {
-    datos.push_back(leerInstancia(fichero.string()));
+    datos.push_back(leerInstancia(fichero.string(), precision));
+  }
+  return datos;
+}
+
+namespace {
+
+// Comprueba si "nombre" encaja con "patron", donde '*' representa cualquier secuencia y '?' cualquier carácter
+bool coincidePatron(const string& nombre, const string& patron) {
+  size_t n = 0, p = 0, estrella = string::npos, marca = 0;
+  while (n < nombre.size()) {
+    if (p < patron.size() && (patron[p] == '?' || patron[p] == nombre[n])) {
+      n++;
+      p++;
+    } else if (p < patron.size() && patron[p] == '*') {
+      estrella = p++;
+      marca = n;
+    } else if (estrella != string::npos) {
+      p = estrella + 1;
+      n = ++marca;
+    } else {
+      return false;
+    }
+  }
+  while (p < patron.size() && patron[p] == '*') p++;
+  return p == patron.size();
+}
+
+} // namespace
+
+/**
+ * @brief Función para leer las instancias indicadas en la línea de comandos
+ * @param entrada Directorio (se leen todos sus "instanceN.txt"), fichero de instancia o patrón con '*'/'?'
+ *        en el nombre del fichero (p.ej. "data/instance1*.txt")
+ * @param precision Tipo de la matriz de distancias (ver leerInstancia)
+ * @return vector<Tools> Datos de cada instancia, ordenados por número de instancia
+ * @throws std::invalid_argument si la entrada no existe o el patrón no encaja con ningún fichero
+ */
+vector<Tools> leerInstancias(const string& entrada, PrecisionDistancias precision) {
+  if (fs::is_directory(entrada)) return readData(entrada, precision);
+  if (fs::is_regular_file(entrada)) return {leerInstancia(entrada, precision)};
+  const fs::path ruta(entrada);
+  const string patron = ruta.filename().string();
+  if (patron.find_first_of("*?") == string::npos) {
+    throw invalid_argument("Error: La entrada " + entrada + " no existe");
+  }
+  const fs::path directorio = ruta.has_parent_path() ? ruta.parent_path() : fs::path(".");
+  if (!fs::is_directory(directorio)) {
+    throw invalid_argument("Error: El directorio de instancias " + directorio.string() + " no existe");
+  }
+  vector<fs::path> ficheros;
+  for (const auto& fichero : fs::directory_iterator(directorio)) {
+    if (fichero.is_regular_file() && coincidePatron(fichero.path().filename().string(), patron)) {
+      ficheros.push_back(fichero.path());
+    }
+  }
+  if (ficheros.empty()) {
+    throw invalid_argument("Error: El patrón " + entrada + " no encaja con ningún fichero");
+  }
+  std::sort(ficheros.begin(), ficheros.end(), [](const fs::path& a, const fs::path& b) {
+    const int numeroA = numeroDeInstancia(a), numeroB = numeroDeInstancia(b);
+    return numeroA != numeroB ? numeroA < numeroB : a < b;
+  });
+  vector<Tools> datos;
+  datos.reserve(ficheros.size());
+  for (const auto& fichero : ficheros) {
+    datos.push_back(leerInstancia(fichero.string(), precision));
   }
   return datos;
 }
@@ -229,6 +438,53 @@ Algoritmo* crearAlgoritmo(int opcion) {
   return algoritmo;
 }
 
+/**
+ * @brief Función para crear el algoritmo elegido con los parámetros de la línea de comandos
+ * @param opcion Opción elegida (1 = Voraz, 2 = GRASP, 3 = RVND)
+ * @param opciones Opciones de la línea de comandos (construcción de Voraz, tamaño de LRC, selección, ejecuciones, semilla, hilos, tiempo, memoria de rutas, LNS, descomposición, reencadenamiento)
+ * @return Algoritmo* Puntero al algoritmo creado
+ */
+Algoritmo* crearAlgoritmo(int opcion, const Opciones& opciones) {
+  switch (opcion) {
+    case 1: {
+      Voraz* voraz = new Voraz();
+      voraz->setConstruccion(opciones.construccion);
+      voraz->setDescomposicion(opciones.descomposicion, opciones.hilos);
+      return voraz;
+    }
+    case 2: {
+      Grasp* grasp = new Grasp(opciones.tamanoLRC, opciones.numeroEjecuciones);
+      if (opciones.semillaFijada) grasp->setSemilla(opciones.semilla);
+      grasp->setSeleccion(opciones.seleccion, opciones.alfa);
+      grasp->setHilos(opciones.hilos);
+      grasp->setVecindarioParalelo(opciones.vecindarioParalelo);
+      grasp->setTiempoLimite(opciones.tiempoLimite);
+      grasp->setMemoRutas(opciones.memoRutas);
+      grasp->setTramosExactos(opciones.tramosExactos);
+      grasp->setLNS(opciones.lns, !opciones.sinBusquedaLocal);
+      grasp->setDescomposicion(opciones.descomposicion);
+      grasp->setReencadenamiento(opciones.reencadenamiento);
+      return grasp;
+    }
+    case 3: {
+      RVND* rvnd = new RVND(opciones.tamanoLRC, opciones.numeroEjecuciones);
+      if (opciones.semillaFijada) rvnd->setSemilla(opciones.semilla);
+      rvnd->setSeleccion(opciones.seleccion, opciones.alfa);
+      rvnd->setHilos(opciones.hilos);
+      rvnd->setVecindarioParalelo(opciones.vecindarioParalelo);
+      rvnd->setTiempoLimite(opciones.tiempoLimite);
+      rvnd->setMemoRutas(opciones.memoRutas);
+      rvnd->setTramosExactos(opciones.tramosExactos);
+      rvnd->setLNS(opciones.lns, !opciones.sinBusquedaLocal);
+      rvnd->setDescomposicion(opciones.descomposicion);
+      rvnd->setReencadenamiento(opciones.reencadenamiento);
+      return rvnd;
+    }
+    default:
+      throw invalid_argument("Opción no válida");
+  }
+}
+
 /**
  * @brief Función para calcular la distancia de recolección
  * @return double Distancia de recolección
@@ -236,7 +492,7 @@ Algoritmo* crearAlgoritmo(int opcion) {
 double Tools::calcularDistanciaRecoleccion() const {
   double distancia = 0.0;
   for (const auto& vehiculo : rutasRecoleccion) {
-    const vector<Zona>& zonasVisitadas = vehiculo.getZonasVisitadas();
+    const std::pmr::vector<Zona>& zonasVisitadas = vehiculo.getZonasVisitadas();
     for (auto it = zonasVisitadas.begin(); it != zonasVisitadas.end(); ++it) {
       if (it + 1 != zonasVisitadas.end()) {
         distancia += it->getDistancia(*next(it));
@@ -248,41 +504,144 @@ double Tools::calcularDistanciaRecoleccion() const {
 
 namespace {
 
-// Escapa comillas y barras invertidas para incrustar cadenas en JSON
-string escaparJSON(const string& texto) {
-  string resultado;
-  resultado.reserve(texto.size());
-  for (char c : texto) {
-    if (c == '"' || c == '\\') resultado += '\\';
-    resultado += c;
-  }
-  return resultado;
+const char* tipoDeZona(const Zona& zona) {
+  if (zona.esDeposito()) return "deposito";
+  if (zona.esSWTS()) return "swts";
+  if (zona.esDumpsite()) return "vertedero";
+  return "recoleccion";
 }
 
-void escribirZona(ofstream& salida, const Zona& zona) {
-  string tipo = "recoleccion";
-  if (zona.esDeposito()) tipo = "deposito";
-  else if (zona.esSWTS()) tipo = "swts";
-  else if (zona.esDumpsite()) tipo = "vertedero";
-  salida << "{\"id\":\"" << escaparJSON(zona.getId()) << "\","
-         << "\"x\":" << zona.getPosicion().first << ","
-         << "\"y\":" << zona.getPosicion().second << ","
-         << "\"contenido\":" << zona.getContenido() << ","
-         << "\"tipo\":\"" << tipo << "\"}";
+void escribirZona(EscritorJSON& salida, const Zona& zona) {
+  salida.literal("{\"id\":");
+  salida.cadena(zona.getId());
+  salida.literal(",\"x\":");
+  salida.numero(zona.getPosicion().first);
+  salida.literal(",\"y\":");
+  salida.numero(zona.getPosicion().second);
+  salida.literal(",\"contenido\":");
+  salida.numero(zona.getContenido());
+  salida.literal(",\"tipo\":\"");
+  salida.literal(tipoDeZona(zona));
+  salida.literal("\"}");
 }
 
+// En formato compacto cada parada es el índice de la zona en la tabla "zonas" de la instancia;
+// en formato completo se repite el objeto de la zona entero.
 template <typename VehiculoT>
-void escribirRuta(ofstream& salida, const VehiculoT& vehiculo) {
-  salida << "{\"capacidad\":" << vehiculo.getCapacidad() << ","
-         << "\"duracion\":" << vehiculo.getDuracion() << ","
-         << "\"tiempoTranscurrido\":" << vehiculo.getTiempoTranscurrido() << ","
-         << "\"zonas\":[";
+void escribirRuta(EscritorJSON& salida, const VehiculoT& vehiculo, const std::unordered_map<string, int>* indices) {
+  salida.literal("{\"capacidad\":");
+  salida.numero(vehiculo.getCapacidad());
+  salida.literal(",\"duracion\":");
+  salida.numero(vehiculo.getDuracion());
+  salida.literal(",\"tiempoTranscurrido\":");
+  salida.numero(vehiculo.getTiempoTranscurrido());
+  salida.literal(",\"zonas\":[");
   const auto& zonas = vehiculo.getZonasVisitadas();
   for (size_t i = 0; i < zonas.size(); i++) {
-    if (i > 0) salida << ",";
-    escribirZona(salida, zonas[i]);
+    if (i > 0) salida.literal(",");
+    if (indices != nullptr) salida.numero(indices->at(zonas[i].getId()));
+    else escribirZona(salida, zonas[i]);
+  }
+  salida.literal("]}");
+}
+
+template <typename VehiculoT>
+void escribirRutas(EscritorJSON& salida, const vector<VehiculoT>& vehiculos, const std::unordered_map<string, int>* indices) {
+  for (size_t i = 0; i < vehiculos.size(); i++) {
+    if (i > 0) salida.literal(",");
+    escribirRuta(salida, vehiculos[i], indices);
+  }
+}
+
+void escribirFase(EscritorJSON& salida, const char* nombre, const TiempoFase& fase) {
+  salida.literal("\"");
+  salida.literal(nombre);
+  salida.literal("\":{\"pared\":");
+  salida.numero(fase.pared);
+  salida.literal(",\"cpu\":");
+  salida.numero(fase.cpu);
+  salida.literal("}");
+}
+
+void escribirMetricas(EscritorJSON& salida, const Metricas& metricas) {
+  salida.literal(kInstrumentacion ? "{\"instrumentado\":true,\"fases\":{" : "{\"instrumentado\":false,\"fases\":{");
+  escribirFase(salida, "construccion", metricas.construccion);
+  salida.literal(",");
+  escribirFase(salida, "busquedaLocal", metricas.busquedaLocal);
+  salida.literal(",");
+  escribirFase(salida, "transporte", metricas.transporte);
+  salida.literal("},\"operadores\":{");
+  for (int i = 0; i < kNumeroOperadores; i++) {
+    const ContadorOperador& contador = metricas.operadores[i];
+    if (i > 0) salida.literal(",");
+    salida.literal("\"");
+    salida.literal(nombreOperador(static_cast<Operador>(i)));
+    salida.literal("\":{\"evaluados\":");
+    salida.numero(contador.evaluados);
+    salida.literal(",\"factibles\":");
+    salida.numero(contador.factibles);
+    salida.literal(",\"aceptados\":");
+    salida.numero(contador.aceptados);
+    salida.literal(",\"tiempo\":");
+    salida.numero(contador.tiempo);
+    salida.literal("}");
+  }
+  salida.literal("},\"pasadas\":[");
+  for (size_t i = 0; i < metricas.pasadas.size(); i++) {
+    if (i > 0) salida.literal(",");
+    salida.numero(metricas.pasadas[i]);
+  }
+  salida.literal("],\"nucleo\":{\"zonaMasCercana\":");
+  salida.numero(metricas.nucleo.zonaMasCercana);
+  salida.literal(",\"candidatosExaminados\":");
+  salida.numero(metricas.nucleo.candidatosExaminados);
+  salida.literal(",\"esFactible\":");
+  salida.numero(metricas.nucleo.esFactible);
+  salida.literal(",\"calcularCostoRuta\":");
+  salida.numero(metricas.nucleo.calcularCostoRuta);
+  salida.literal(",\"calcularCostoInsercion\":");
+  salida.numero(metricas.nucleo.calcularCostoInsercion);
+  salida.literal("},\"duplicadas\":");
+  salida.numero(metricas.duplicadas);
+  salida.literal(",\"memo\":{\"aciertos\":");
+  salida.numero(metricas.memo.aciertos);
+  salida.literal(",\"fallos\":");
+  salida.numero(metricas.memo.fallos);
+  salida.literal("},\"lns\":{\"iteraciones\":");
+  salida.numero(metricas.lns.iteraciones);
+  salida.literal(",\"aceptadas\":");
+  salida.numero(metricas.lns.aceptadas);
+  salida.literal(",\"mejoras\":");
+  salida.numero(metricas.lns.mejoras);
+  salida.literal(",\"tiempo\":");
+  salida.numero(metricas.lns.tiempo);
+  salida.literal("},\"reencadenamiento\":{\"trayectorias\":");
+  salida.numero(metricas.reencadenamiento.trayectorias);
+  salida.literal(",\"pasos\":");
+  salida.numero(metricas.reencadenamiento.pasos);
+  salida.literal(",\"mejoras\":");
+  salida.numero(metricas.reencadenamiento.mejoras);
+  salida.literal(",\"tiempo\":");
+  salida.numero(metricas.reencadenamiento.tiempo);
+  salida.literal("}}");
+}
+
+void escribirConvergencia(EscritorJSON& salida, const vector<PuntoConvergencia>& convergencia) {
+  for (size_t i = 0; i < convergencia.size(); i++) {
+    const PuntoConvergencia& punto = convergencia[i];
+    if (i > 0) salida.literal(",");
+    salida.literal("{\"tiempo\":");
+    salida.numero(punto.tiempo);
+    salida.literal(",\"iteracion\":");
+    salida.numero(punto.iteracion);
+    salida.literal(",\"cv\":");
+    salida.numero(punto.vehiculosRecoleccion);
+    salida.literal(",\"tv\":");
+    salida.numero(punto.vehiculosTransporte);
+    salida.literal(",\"distancia\":");
+    salida.numero(punto.distancia);
+    salida.literal("}");
   }
-  salida << "]}";
 }
 
 } // namespace
@@ -292,36 +651,44 @@ void escribirRuta(ofstream& salida, const VehiculoT& vehiculo) {
  *        consumido por la visualización web (visualizacion/index.html).
  * @param datos Vector con los datos (una entrada por instancia) que se quieren exportar
  * @param rutaSalida Ruta del fichero JSON de salida
+ * @param compacto Si es true, las paradas de las rutas se escriben como índices en la tabla de zonas
+ *        de la instancia ("formato":"compacto") en vez de repetir el objeto de la zona completo
  * @return void
+ * @throws std::runtime_error si no se puede crear el fichero de salida
  */
-void exportarResultadosJSON(const vector<std::shared_ptr<Tools>>& datos, const string& rutaSalida) {
-  ofstream salida(rutaSalida);
-  if (!salida.is_open()) {
-    throw std::runtime_error("Error: No se pudo crear el fichero de salida " + rutaSalida);
-  }
-  salida << "{\"instancias\":[";
+void exportarResultadosJSON(const vector<std::shared_ptr<Tools>>& datos, const string& rutaSalida, bool compacto) {
+  IntervaloTraza intervalo("exportarResultadosJSON", "exportacion");
+  AmbitoMemoria memoria(FaseMemoria::exportacion);
+  EscritorJSON salida(rutaSalida);
+  salida.literal(compacto ? "{\"formato\":\"compacto\",\"instancias\":[" : "{\"formato\":\"completo\",\"instancias\":[");
+  std::unordered_map<string, int> indices;
   for (size_t d = 0; d < datos.size(); d++) {
-    if (d > 0) salida << ",";
+    if (d > 0) salida.literal(",");
     const Tools& dato = *datos[d];
-    salida << "{\"nombre\":\"" << escaparJSON(dato.nombreInstancia) << "\","
-           << "\"maxX\":" << dato.maxX << ",\"maxY\":" << dato.maxY << ","
-           << "\"tiempoCPU\":" << dato.tiempoCPU << ","
-           << "\"zonas\":[";
+    salida.literal("{\"nombre\":");
+    salida.cadena(dato.nombreInstancia);
+    salida.literal(",\"maxX\":");
+    salida.numero(dato.maxX);
+    salida.literal(",\"maxY\":");
+    salida.numero(dato.maxY);
+    salida.literal(",\"tiempoCPU\":");
+    salida.numero(dato.tiempoCPU);
+    salida.literal(",\"zonas\":[");
+    indices.clear();
     for (size_t i = 0; i < dato.zonas.size(); i++) {
-      if (i > 0) salida << ",";
+      if (i > 0) salida.literal(",");
       escribirZona(salida, dato.zonas[i]);
+      indices.emplace(dato.zonas[i].getId(), static_cast<int>(i));
     }
-    salida << "],\"rutasRecoleccion\":[";
-    for (size_t i = 0; i < dato.rutasRecoleccion.size(); i++) {
-      if (i > 0) salida << ",";
-      escribirRuta(salida, dato.rutasRecoleccion[i]);
-    }
-    salida << "],\"rutasTransporte\":[";
-    for (size_t i = 0; i < dato.rutasTransporte.size(); i++) {
-      if (i > 0) salida << ",";
-      escribirRuta(salida, dato.rutasTransporte[i]);
-    }
-    salida << "]}";
+    salida.literal("],\"rutasRecoleccion\":[");
+    escribirRutas(salida, dato.rutasRecoleccion, compacto ? &indices : nullptr);
+    salida.literal("],\"rutasTransporte\":[");
+    escribirRutas(salida, dato.rutasTransporte, compacto ? &indices : nullptr);
+    salida.literal("],\"metricas\":");
+    escribirMetricas(salida, dato.metricas);
+    salida.literal(",\"convergencia\":[");
+    escribirConvergencia(salida, dato.convergencia);
+    salida.literal("]}");
   }
-  salida << "]}";
+  salida.literal("]}");
 }
@@ -16,6 +16,12 @@
 #include <filesystem> // Para recorrer los ficheros del directorio
 #include <memory>
 #include "../zona/zona.h"
+#include "opciones/opciones.h"
+#include "metricas/metricas.h"
+#include "traza/traza.h"
+#include "memoria/memoria.h"
+#include "grafo_vecinos/grafo_vecinos.h"
+#include "matriz_distancias/matriz_distancias.h"
 #include "../vehiculo/recoleccion/recoleccion.h"
 #include "../vehiculo/transporte/transporte.h"
 #include "../algoritmo/voraz/voraz.h"
@@ -31,7 +37,8 @@ struct Tools {
   std::vector<Zona> zonasRecoleccion; // Vector con las zonas de recolección
   std::vector<Recoleccion> rutasRecoleccion; // Vector con las rutas de los vehículos de recolección
   std::vector<Transporte> rutasTransporte; // Vector con las rutas de los vehículos de transporte
-  std::vector<std::vector<double>> distancias;
+  Distancias distancias; // Matriz de distancias con la precisión de --precision (monostate si se ha leído sin matriz)
+  std::shared_ptr<const GrafoVecinos> vecinos; // k vecinas de cada zona (--vecinos); nulo si no se usa. Las copias lo comparten
   int numZonas = 0;
   int numVehiculos = 0;
   // Información de los vehículos de recolección
@@ -46,19 +53,36 @@ struct Tools {
   int maxY = 0;
   std::string nombreInstancia;
   double tiempoCPU = 0.0; // Tiempo que tarda en resolver el problema
+  // Posición en "zonas" del depósito y del vertedero (las SWTS pueden ser cualquier número: IF, IF1, IF2...)
+  int indiceDeposito = -1;
+  int indiceVertedero = -1;
+  Metricas metricas; // Tiempos por fase y contadores de la búsqueda local con los que se ha obtenido la solución
+  std::vector<PuntoConvergencia> convergencia; // Mejoras de la mejor solución a lo largo de GRASP/RVND (vacío en el resto)
 
+  inline Zona& deposito() { return zonas[indiceDeposito]; }
+  inline Zona& vertedero() { return zonas[indiceVertedero]; }
   double calcularDistanciaRecoleccion() const;
 };
 
-std::vector<Tools> readData(const std::string& dirName); // Lee todos los ficheros "instanceN.txt" de un directorio
-Tools leerInstancia(const std::string& rutaFichero); // Lee los datos de un único fichero de instancia
+// Con más zonas que esto no se calcula la matriz de distancias (en double ocuparía unos 200 MB) y el
+// Constructor usa un índice espacial (ver algoritmo/constructor/vecindario.h)
+constexpr size_t kMaxZonasMatriz = 5000;
+
+// "precision" es el tipo en que se guarda la matriz de distancias (--precision); ninguna = sin matriz (--sin-matriz)
+std::vector<Tools> readData(const std::string& dirName, PrecisionDistancias precision = PrecisionDistancias::doble); // Lee todos los ficheros "instanceN.txt" de un directorio
+Tools leerInstancia(const std::string& rutaFichero, PrecisionDistancias precision = PrecisionDistancias::doble); // Lee los datos de un único fichero de instancia
+Tools leerInstancia(std::istream& entrada, const std::string& nombreInstancia, PrecisionDistancias precision = PrecisionDistancias::doble); // Lee una instancia desde un flujo
+std::vector<Tools> leerInstancias(const std::string& entrada, PrecisionDistancias precision = PrecisionDistancias::doble); // Lee un directorio, un fichero o un patrón ("data/instance1*.txt")
 void procesarLinea(std::istringstream& linea, Tools& datos); // Función para procesar una línea de texto
 void crearZona(const std::string& id, std::istringstream& linea, Tools& datos); // Función para crear una zona
-std::vector<std::vector<double>> calcularDistancias(const Tools& datos); // Función para calcular las distancias entre las zonas
+Distancias calcularDistancias(const Tools& datos, PrecisionDistancias precision = PrecisionDistancias::doble); // Función para calcular las distancias entre las zonas
 void mostrarZonas(const std::vector<Zona>& zonas); // Función para mostrar las zonas
 void mostrarDistancias(const Tools& datos); // Función para mostrar las distancias
+void mostrarPrecision(const Tools& datos); // Muestra el tipo, el tamaño y la cota del error de la matriz de distancias
 void mostrarMenu(); // Función para mostrar el menú de opciones
 Algoritmo* crearAlgoritmo(int opcion); // Función para crear el algoritmo según la opción elegida
-void exportarResultadosJSON(const std::vector<std::shared_ptr<Tools>>& datos, const std::string& rutaSalida); // Exporta zonas y rutas a JSON para la visualización web
+Algoritmo* crearAlgoritmo(int opcion, const Opciones& opciones); // Igual, con los parámetros de la línea de comandos
+void mostrarMetricas(const std::vector<std::shared_ptr<Tools>>& datos); // Muestra los tiempos por fase y los contadores de los operadores
+void exportarResultadosJSON(const std::vector<std::shared_ptr<Tools>>& datos, const std::string& rutaSalida, bool compacto = false); // Exporta zonas y rutas a JSON para la visualización web
 
 #endif
@@ -0,0 +1,128 @@
+#include "traza.h"
+#include "../escritor_json/escritor_json.h"
+#include <algorithm>
+#include <set>
+
+using namespace std;
+
+/**
+ * @brief Método para obtener la traza del programa (todas las partes del solver escriben en la misma)
+ * @return Traza& Traza global
+ */
+Traza& Traza::global() {
+  static Traza traza;
+  return traza;
+}
+
+/**
+ * @brief Método para empezar a registrar intervalos. El hilo que la activa es el hilo 1 ("principal").
+ * @return void
+ */
+void Traza::activar() {
+  idHilo();
+  lock_guard<mutex> bloqueo(mutex_);
+  origen_ = chrono::steady_clock::now();
+  eventos_.clear();
+  activa_.store(true, memory_order_relaxed);
+}
+
+/**
+ * @brief Método para obtener el instante actual de la traza
+ * @return int64_t Microsegundos desde la activación
+ */
+int64_t Traza::ahora() const {
+  return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - origen_).count();
+}
+
+namespace {
+
+// Reparte identificadores pequeños entre los hilos vivos. paraleloPara crea hilos nuevos en cada
+// llamada, así que al terminar un hilo su identificador se reutiliza: en el visor aparece un carril
+// por trabajador en vez de uno por cada hilo que haya existido.
+class IdentificadorHilo {
+  public:
+    IdentificadorHilo() {
+      lock_guard<mutex> bloqueo(mutex_);
+      if (libres_.empty()) id_ = siguiente_++;
+      else {
+        id_ = *libres_.begin();
+        libres_.erase(libres_.begin());
+      }
+    }
+    ~IdentificadorHilo() {
+      lock_guard<mutex> bloqueo(mutex_);
+      libres_.insert(id_);
+    }
+    int id() const { return id_; }
+
+  private:
+    static inline mutex mutex_;
+    static inline set<int> libres_;
+    static inline int siguiente_ = 1;
+    int id_;
+};
+
+} // namespace
+
+/**
+ * @brief Método para obtener el identificador del hilo actual: el menor que no esté usando otro hilo
+ *        vivo, que es más legible en el visor que el id del sistema
+ * @return int Identificador del hilo
+ */
+int Traza::idHilo() {
+  thread_local const IdentificadorHilo identificador;
+  return identificador.id();
+}
+
+/**
+ * @brief Método para añadir un intervalo del hilo actual a la traza
+ * @param nombre Nombre del intervalo (p.ej. "swapInter" o "GRASP LRC=2 #1")
+ * @param categoria Categoría con la que se agrupa en el visor (p.ej. "busquedaLocal")
+ * @param inicio Instante de inicio, en microsegundos desde la activación
+ * @param duracion Duración en microsegundos
+ * @return void
+ */
+void Traza::registrar(string nombre, const char* categoria, int64_t inicio, int64_t duracion) {
+  if (!activa()) return;
+  const int hilo = idHilo();
+  lock_guard<mutex> bloqueo(mutex_);
+  eventos_.push_back(Evento{std::move(nombre), categoria, inicio, duracion, hilo});
+}
+
+/**
+ * @brief Método para escribir la traza como JSON "trace event" (un evento "X" por intervalo y
+ *        un evento "M" con el nombre de cada hilo)
+ * @param rutaSalida Ruta del fichero de salida
+ * @return void
+ */
+void Traza::exportar(const string& rutaSalida) const {
+  lock_guard<mutex> bloqueo(mutex_);
+  EscritorJSON salida(rutaSalida);
+  salida.literal("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  vector<int> hilos;
+  for (size_t i = 0; i < eventos_.size(); i++) {
+    const Evento& evento = eventos_[i];
+    if (i > 0) salida.literal(",");
+    salida.literal("{\"name\":");
+    salida.cadena(evento.nombre);
+    salida.literal(",\"cat\":");
+    salida.cadena(evento.categoria);
+    salida.literal(",\"ph\":\"X\",\"ts\":");
+    salida.numero(evento.inicio);
+    salida.literal(",\"dur\":");
+    salida.numero(evento.duracion);
+    salida.literal(",\"pid\":1,\"tid\":");
+    salida.numero(evento.hilo);
+    salida.literal("}");
+    if (find(hilos.begin(), hilos.end(), evento.hilo) == hilos.end()) hilos.push_back(evento.hilo);
+  }
+  for (int hilo : hilos) {
+    salida.literal(eventos_.empty() ? "" : ",");
+    salida.literal("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+    salida.numero(hilo);
+    salida.literal(",\"args\":{\"name\":");
+    salida.cadena(hilo == 1 ? string("principal") : "trabajador " + to_string(hilo - 1));
+    salida.literal("}}");
+  }
+  salida.literal("]}");
+}
@@ -0,0 +1,68 @@
+/**
+ * @class Registro opcional de la ejecución en formato "trace event" de Chrome, para verlo sin conexión
+ *        en Perfetto (ui.perfetto.dev) o en chrome://tracing. Mientras no se active no registra nada.
+ */
+
+#ifndef C_Traza_H
+#define C_Traza_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Traza {
+  public:
+    static Traza& global(); // Traza única del programa
+
+    // Métodos de la clase
+    void activar(); // Empieza a registrar (el tiempo 0 de la traza es el momento de la activación)
+    inline bool activa() const { return activa_.load(std::memory_order_relaxed); }
+    void registrar(std::string nombre, const char* categoria, int64_t inicio, int64_t duracion); // Añade un intervalo del hilo actual
+    int64_t ahora() const; // Microsegundos desde la activación
+    void exportar(const std::string& rutaSalida) const; // Escribe el JSON de la traza
+    static int idHilo(); // Identificador pequeño y estable del hilo actual (1, 2, 3...)
+
+  private:
+    Traza() = default;
+
+    struct Evento {
+      std::string nombre;
+      const char* categoria;
+      int64_t inicio; // Microsegundos desde la activación
+      int64_t duracion;
+      int hilo;
+    };
+
+    std::atomic<bool> activa_{false};
+    std::chrono::steady_clock::time_point origen_;
+    mutable std::mutex mutex_;
+    std::vector<Evento> eventos_;
+};
+
+// Intervalo de la traza que abarca desde su creación hasta su destrucción. Si la traza no está
+// activa sólo cuesta comprobarlo, y con un nombre literal no construye ninguna cadena.
+class IntervaloTraza {
+  public:
+    IntervaloTraza(const char* nombre, const char* categoria) : literal_(nombre), categoria_(categoria), inicio_(comenzar()) {}
+    IntervaloTraza(std::string nombre, const char* categoria) : nombre_(std::move(nombre)), categoria_(categoria), inicio_(comenzar()) {}
+    ~IntervaloTraza() {
+      if (inicio_ < 0) return;
+      Traza& traza = Traza::global();
+      traza.registrar(literal_ != nullptr ? std::string(literal_) : std::move(nombre_), categoria_, inicio_, traza.ahora() - inicio_);
+    }
+    IntervaloTraza(const IntervaloTraza&) = delete;
+    IntervaloTraza& operator=(const IntervaloTraza&) = delete;
+
+  private:
+    static int64_t comenzar() { return Traza::global().activa() ? Traza::global().ahora() : -1; }
+
+    const char* literal_ = nullptr;
+    std::string nombre_;
+    const char* categoria_;
+    int64_t inicio_; // -1 si la traza no estaba activa al crearlo
+};
+
+#endif
@@ -11,7 +11,12 @@ class Recoleccion : public Vehiculo {
   public:
     // Constructor de la clase
     Recoleccion(const int& capacidad, const int& velocidad, const Zona& posicion, const int& duracion) : Vehiculo(capacidad, velocidad, posicion, duracion) {}
-    
+    Recoleccion(const Recoleccion& otro) = default;
+    Recoleccion(const Recoleccion& otro, std::pmr::memory_resource* recurso) : Vehiculo(otro, recurso) {}
+    Recoleccion(Recoleccion&&) = default;
+    Recoleccion& operator=(const Recoleccion&) = default;
+    Recoleccion& operator=(Recoleccion&&) = default;
+
     // Destructor de la clase
     ~Recoleccion() {}
 
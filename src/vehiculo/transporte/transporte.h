@@ -17,15 +17,21 @@ class Transporte : public Vehiculo {
   public:
     // Constructor de la clase
     Transporte(const int& capacidad, const int& velocidad, const Zona& posicion, const int& duracion) : Vehiculo(capacidad, velocidad, posicion, duracion) {}
+    Transporte(const Transporte& otro) : Transporte(otro, recursoVehiculos()) {}
+    Transporte(const Transporte& otro, std::pmr::memory_resource* recurso) : Vehiculo(otro, recurso), tareasAsignadas_(otro.tareasAsignadas_, recurso) {}
+    Transporte(Transporte&&) = default;
+    Transporte& operator=(const Transporte&) = default;
+    Transporte& operator=(Transporte&&) = default;
 
     // Métodos de la clase
     inline void agregarTarea(const Tarea& tarea) { tareasAsignadas_.push_back(tarea); } // Agregar una tarea al vehículo
 
     // Getters
-    inline const std::vector<Tarea>& getTareasAsignadas() const { return tareasAsignadas_; } // Obtener las tareas asignadas al vehículo
+    inline const std::pmr::vector<Tarea>& getTareasAsignadas() const { return tareasAsignadas_; } // Obtener las tareas asignadas al vehículo
 
   private:
-    std::vector<Tarea> tareasAsignadas_; // Tareas asignadas al vehículo
+    friend class Solucion;
+    std::pmr::vector<Tarea> tareasAsignadas_{recursoVehiculos()}; // Tareas asignadas al vehículo
 };
 
 #endif
\ No newline at end of file
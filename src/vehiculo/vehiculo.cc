@@ -16,6 +16,16 @@ Vehiculo::Vehiculo(const int& capacidad, const int& velocidad, const Zona& posic
   duracion_ = duracion;
 }
 
+/**
+ * @brief Constructor de copia que asigna las zonas visitadas en un recurso de memoria concreto
+ * @param otro Vehículo a copiar
+ * @param recurso Recurso del que se toma la memoria de la copia
+ * @return Vehiculo
+ */
+Vehiculo::Vehiculo(const Vehiculo& otro, std::pmr::memory_resource* recurso)
+    : capacidad_(otro.capacidad_), duracion_(otro.duracion_), tiempoTotal_(otro.tiempoTotal_), contenido_(otro.contenido_),
+      velocidad_(otro.velocidad_), posicion_(otro.posicion_), zonasVisitadas_(otro.zonasVisitadas_, recurso) {}
+
 /**
  * @brief Método para llenar el vehículo
  * @param cantidad Cantidad de residuos que se van a añadir al vehículo
@@ -9,12 +9,20 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <memory_resource>
 #include "../zona/zona.h"
+#include "../tools/arena/arena.h"
 
 class Vehiculo {
   // Constructor de la clase
   public:
     Vehiculo(const int& capacidad, const int& velocidad, const Zona& posicion, const int& duracion);
+    // Las copias toman sus vectores del recurso actual del hilo (la arena de la iteración, si la hay)
+    Vehiculo(const Vehiculo& otro) : Vehiculo(otro, recursoVehiculos()) {}
+    Vehiculo(const Vehiculo& otro, std::pmr::memory_resource* recurso);
+    Vehiculo(Vehiculo&&) = default;
+    Vehiculo& operator=(const Vehiculo&) = default;
+    Vehiculo& operator=(Vehiculo&&) = default;
 
     // Métodos de la clase
     bool llenarVehiculo(double cantidad) const;
@@ -26,17 +34,19 @@ class Vehiculo {
 
     // Getters
     inline const Zona& getPosicion() const { return posicion_; }
-    inline std::vector<Zona>& getZonasVisitadas() { return zonasVisitadas_; }
-    inline const std::vector<Zona>& getZonasVisitadas() const { return zonasVisitadas_; }
+    inline std::pmr::vector<Zona>& getZonasVisitadas() { return zonasVisitadas_; }
+    inline const std::pmr::vector<Zona>& getZonasVisitadas() const { return zonasVisitadas_; }
     inline int getDuracion() const { return duracion_; }
     inline int getContenido() const { return contenido_; }
     inline int getCapacidad() const { return capacidad_; }
+    inline int getVelocidad() const { return velocidad_; }
     inline int getTiempoTranscurrido() const { return tiempoTotal_; }
 
     // Setters
     inline void setPosicion(const Zona& zona) { posicion_ = zona; }
 
   protected:
+    friend class Solucion; // Guarda y reconstruye el estado completo del vehículo (src/solucion)
     // Valores que dependen para que el vehículo siga funcionando
     int capacidad_;
     int duracion_;
@@ -45,7 +55,7 @@ class Vehiculo {
     double contenido_ = 0.0;
     int velocidad_;
     Zona posicion_; // Zona actual del vehículo
-    std::vector<Zona> zonasVisitadas_; // Zonas que ha visitado el vehículo
+    std::pmr::vector<Zona> zonasVisitadas_{recursoVehiculos()}; // Zonas que ha visitado el vehículo
 };
 
 #endif
\ No newline at end of file
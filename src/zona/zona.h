@@ -29,10 +29,19 @@ class Zona {
     inline void setContenido(double contenido) { contenido_ = contenido; }
 
     // Métodos de la clase
-    inline bool esSWTS() const { return id_ == "IF" || id_ == "IF1"; }
+    inline bool esSWTS() const { return esIdentificadorSWTS(id_); }
     inline bool esDeposito() const { return id_ == "Depot"; }
     inline bool esDumpsite() const { return id_ == "Dumpsite"; }
 
+    // Las SWTS se identifican como "IF", "IF1", "IF2"... (una instancia puede tener cualquier número)
+    static inline bool esIdentificadorSWTS(const std::string& id) {
+      if (id.size() < 2 || id[0] != 'I' || id[1] != 'F') return false;
+      for (size_t i = 2; i < id.size(); i++) {
+        if (id[i] < '0' || id[i] > '9') return false;
+      }
+      return true;
+    }
+
     // Sobrecarga de operadores
     friend inline bool operator==(const Zona& zona1, const Zona& zona2) {
       return zona1.id_ == zona2.id_;